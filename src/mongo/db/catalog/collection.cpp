@@ -600,14 +600,16 @@ void Collection::deleteDocument(
 Counter64 moveCounter;
 ServerStatusMetricField<Counter64> moveCounterDisplay("record.moves", &moveCounter);
 
-StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
-                                                const RecordId& oldLocation,
-                                                const Snapshotted<BSONObj>& oldDoc,
-                                                const BSONObj& newDoc,
-                                                bool enforceQuota,
-                                                bool indexesAffected,
-                                                OpDebug* opDebug,
-                                                OplogUpdateEntryArgs* args) {
+StatusWith<RecordId> Collection::updateDocument(
+    OperationContext* txn,
+    const RecordId& oldLocation,
+    const Snapshotted<BSONObj>& oldDoc,
+    const BSONObj& newDoc,
+    bool enforceQuota,
+    bool indexesAffected,
+    OpDebug* opDebug,
+    OplogUpdateEntryArgs* args,
+    const std::vector<std::string>* modifiedIndexedPaths) {
     {
         auto status = checkValidation(txn, newDoc);
         if (!status.isOK()) {
@@ -657,9 +659,10 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
                               << " != "
                               << newDoc.objsize()};
 
-    // At the end of this step, we will have a map of UpdateTickets, one per index, which
+    // At the end of this step, we will have a map of UpdateTickets, one per affected index, which
     // represent the index updates needed to be done, based on the changes between oldDoc and
-    // newDoc.
+    // newDoc. Indexes which cover none of the modified paths keep their keys, so we do not
+    // generate any for them.
     OwnedPointerMap<IndexDescriptor*, UpdateTicket> updateTickets;
     if (indexesAffected) {
         IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator(txn, true);
@@ -668,6 +671,10 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
             IndexCatalogEntry* entry = ii.catalogEntry(descriptor);
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
+            if (!_updateAffectsIndex(txn, descriptor, modifiedIndexedPaths)) {
+                continue;
+            }
+
             InsertDeleteOptions options;
             IndexCatalog::prepareInsertDeleteOptions(txn, descriptor, &options);
             UpdateTicket* updateTicket = new UpdateTicket();
@@ -695,17 +702,21 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
         return updateStatus;
     }
 
-    // Object did not move.  We update each index with each respective UpdateTicket.
+    // Object did not move.  We update each affected index with its respective UpdateTicket.
     if (indexesAffected) {
         IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator(txn, true);
         while (ii.more()) {
             IndexDescriptor* descriptor = ii.next();
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
+            auto ticketIt = updateTickets.mutableMap().find(descriptor);
+            if (ticketIt == updateTickets.mutableMap().end()) {
+                continue;
+            }
+
             int64_t keysInserted;
             int64_t keysDeleted;
-            Status ret = iam->update(
-                txn, *updateTickets.mutableMap()[descriptor], &keysInserted, &keysDeleted);
+            Status ret = iam->update(txn, *ticketIt->second, &keysInserted, &keysDeleted);
             if (!ret.isOK())
                 return StatusWith<RecordId>(ret);
             if (opDebug) {
@@ -723,6 +734,27 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
     return {oldLocation};
 }
 
+bool Collection::_updateAffectsIndex(OperationContext* txn,
+                                     const IndexDescriptor* descriptor,
+                                     const std::vector<std::string>* modifiedIndexedPaths) const {
+    if (!modifiedIndexedPaths) {
+        return true;
+    }
+
+    const UpdateIndexData* indexKeys =
+        _infoCache.getIndexKeysForIndex(txn, descriptor->indexName());
+    if (!indexKeys) {
+        return true;
+    }
+
+    for (const auto& path : *modifiedIndexedPaths) {
+        if (indexKeys->mightBeIndexed(path)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 StatusWith<RecordId> Collection::_updateDocumentWithMove(OperationContext* txn,
                                                          const RecordId& oldLocation,
                                                          const Snapshotted<BSONObj>& oldDoc,
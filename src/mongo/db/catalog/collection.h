@@ -315,16 +315,21 @@ public:
      * Sets 'args.updatedDoc' to the updated version of the document with damages applied, on
      * success.
      * 'opDebug' Optional argument. When not null, will be used to record operation statistics.
+     * When 'indexesAffected' is true, the keys of every index are recomputed, or only those of
+     * the indexes covering one of 'modifiedIndexedPaths' if it is given.
+     *
      * @return the post update location of the doc (may or may not be the same as oldLocation)
      */
-    StatusWith<RecordId> updateDocument(OperationContext* txn,
-                                        const RecordId& oldLocation,
-                                        const Snapshotted<BSONObj>& oldDoc,
-                                        const BSONObj& newDoc,
-                                        bool enforceQuota,
-                                        bool indexesAffected,
-                                        OpDebug* opDebug,
-                                        OplogUpdateEntryArgs* args);
+    StatusWith<RecordId> updateDocument(
+        OperationContext* txn,
+        const RecordId& oldLocation,
+        const Snapshotted<BSONObj>& oldDoc,
+        const BSONObj& newDoc,
+        bool enforceQuota,
+        bool indexesAffected,
+        OpDebug* opDebug,
+        OplogUpdateEntryArgs* args,
+        const std::vector<std::string>* modifiedIndexedPaths = nullptr);
 
     bool updateWithDamagesSupported() const;
 
@@ -492,6 +497,14 @@ private:
                                                  OplogUpdateEntryArgs* args,
                                                  const SnapshotId& sid);
 
+    /**
+     * Returns whether an update which changed 'modifiedIndexedPaths' may change the keys of the
+     * index described by 'descriptor'. A null 'modifiedIndexedPaths' may affect any index.
+     */
+    bool _updateAffectsIndex(OperationContext* txn,
+                             const IndexDescriptor* descriptor,
+                             const std::vector<std::string>* modifiedIndexedPaths) const;
+
     bool _enforceQuota(bool userEnforeQuota) const;
 
     int _magic;
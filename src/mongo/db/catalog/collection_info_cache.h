@@ -34,6 +34,7 @@
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -66,6 +67,12 @@ public:
     */
     const UpdateIndexData& getIndexKeys(OperationContext* txn) const;
 
+    /**
+     * Like getIndexKeys(), but only for the index named 'indexName'. Returns nullptr if the paths
+     * of that index are not known, in which case any update may affect it.
+     */
+    const UpdateIndexData* getIndexKeysForIndex(OperationContext* txn, StringData indexName) const;
+
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
@@ -113,6 +120,7 @@ private:
     // ---  index keys cache
     bool _keysComputed;
     UpdateIndexData _indexedPaths;
+    StringMap<UpdateIndexData> _indexedPathsByIndex;
 
     // A cache for query plans.
     std::unique_ptr<PlanCache> _planCache;
@@ -327,71 +327,82 @@ void CursorManager::invalidateAll(bool collectionGoingAway, const std::string& r
     vector<ClientCursor*> toDelete;
 
     {
-        stdx::lock_guard<SimpleMutex> lk(_mutex);
+        PartitionLocks locks = _lockAllPartitions();
         fassert(28819, !BackgroundOperation::inProgForNs(_nss));
 
-        for (ExecSet::iterator it = _nonCachedExecutors.begin(); it != _nonCachedExecutors.end();
-             ++it) {
-            // we kill the executor, but it deletes itself
-            PlanExecutor* exec = *it;
-            exec->kill(reason);
-        }
-        _nonCachedExecutors.clear();
-
-        if (collectionGoingAway) {
-            // we're going to wipe out the world
-            for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-                ClientCursor* cc = i->second;
-
-                cc->kill();
-
-                // If the CC is pinned, somebody is actively using it and we do not delete it.
-                // Instead we notify the holder that we killed it.  The holder will then delete the
-                // CC.
-                //
-                // If the CC is not pinned, there is nobody actively holding it.  We can safely
-                // delete it.
-                if (!cc->isPinned()) {
-                    toDelete.push_back(cc);
-                }
+        for (auto& partition : _executorPartitions) {
+            for (ExecSet::iterator it = partition.executors.begin();
+                 it != partition.executors.end();
+                 ++it) {
+                // we kill the executor, but it deletes itself
+                PlanExecutor* exec = *it;
+                exec->kill(reason);
             }
-        } else {
-            CursorMap newMap;
-
-            // collection will still be around, just all PlanExecutors are invalid
-            for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-                ClientCursor* cc = i->second;
-
-                // Note that a valid ClientCursor state is "no cursor no executor."  This is because
-                // the set of active cursor IDs in ClientCursor is used as representation of query
-                // state.  See sharding_block.h.  TODO(greg,hk): Move this out.
-                if (NULL == cc->getExecutor()) {
-                    newMap.insert(*i);
-                    continue;
-                }
+            partition.executors.clear();
+        }
+
+        for (auto& partition : _cursorPartitions) {
+            if (collectionGoingAway) {
+                // we're going to wipe out the world
+                for (CursorMap::const_iterator i = partition.cursors.begin();
+                     i != partition.cursors.end();
+                     ++i) {
+                    ClientCursor* cc = i->second;
 
-                if (cc->isPinned() || cc->isAggCursor()) {
-                    // Pinned cursors need to stay alive, so we leave them around.  Aggregation
-                    // cursors also can stay alive (since they don't have their lifetime bound to
-                    // the underlying collection).  However, if they have an associated executor, we
-                    // need to kill it, because it's now invalid.
-                    if (cc->getExecutor())
-                        cc->getExecutor()->kill(reason);
-                    newMap.insert(*i);
-                } else {
                     cc->kill();
-                    toDelete.push_back(cc);
+
+                    // If the CC is pinned, somebody is actively using it and we do not delete it.
+                    // Instead we notify the holder that we killed it.  The holder will then delete
+                    // the CC.
+                    //
+                    // If the CC is not pinned, there is nobody actively holding it.  We can safely
+                    // delete it.
+                    if (!cc->isPinned()) {
+                        toDelete.push_back(cc);
+                    }
+                }
+            } else {
+                CursorMap newMap;
+
+                // collection will still be around, just all PlanExecutors are invalid
+                for (CursorMap::const_iterator i = partition.cursors.begin();
+                     i != partition.cursors.end();
+                     ++i) {
+                    ClientCursor* cc = i->second;
+
+                    // Note that a valid ClientCursor state is "no cursor no executor."  This is
+                    // because the set of active cursor IDs in ClientCursor is used as
+                    // representation of query state.  See sharding_block.h.  TODO(greg,hk): Move
+                    // this out.
+                    if (NULL == cc->getExecutor()) {
+                        newMap.insert(*i);
+                        continue;
+                    }
+
+                    if (cc->isPinned() || cc->isAggCursor()) {
+                        // Pinned cursors need to stay alive, so we leave them around.  Aggregation
+                        // cursors also can stay alive (since they don't have their lifetime bound
+                        // to the underlying collection).  However, if they have an associated
+                        // executor, we need to kill it, because it's now invalid.
+                        if (cc->getExecutor())
+                            cc->getExecutor()->kill(reason);
+                        newMap.insert(*i);
+                    } else {
+                        cc->kill();
+                        toDelete.push_back(cc);
+                    }
                 }
-            }
 
-            _cursors = newMap;
+                partition.cursors.swap(newMap);
+            }
         }
     }
 
-    // ClientCursors must be destroyed without holding '_mutex'. This is because the destruction of
-    // a ClientCursor may itself require accessing another CursorManager (e.g. when deregistering a
-    // non-cached PlanExecutor from a $lookup stage). We won't access this CursorManger when
-    // destroying a ClientCursor because we've already killed all of its non-cached PlanExecutors.
+    // ClientCursors must be destroyed without holding the partition locks. This is because the
+    // destruction of a ClientCursor may itself require accessing another CursorManager (e.g. when
+    // deregistering a non-cached PlanExecutor from a $lookup stage). We won't access this
+    // CursorManger when destroying a ClientCursor because we've already killed all of its
+    // non-cached PlanExecutors.
     for (auto* cursor : toDelete) {
         delete cursor;
     }
@@ -406,18 +417,23 @@ void CursorManager::invalidateDocument(OperationContext* txn,
         return;
     }
 
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    PartitionLocks locks = _lockAllPartitions();
 
-    for (ExecSet::iterator it = _nonCachedExecutors.begin(); it != _nonCachedExecutors.end();
-         ++it) {
-        PlanExecutor* exec = *it;
-        exec->invalidate(txn, dl, type);
+    for (auto& partition : _executorPartitions) {
+        for (ExecSet::iterator it = partition.executors.begin(); it != partition.executors.end();
+             ++it) {
+            PlanExecutor* exec = *it;
+            exec->invalidate(txn, dl, type);
+        }
     }
 
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        PlanExecutor* exec = i->second->getExecutor();
-        if (exec) {
-            exec->invalidate(txn, dl, type);
+    for (auto& partition : _cursorPartitions) {
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
+            PlanExecutor* exec = i->second->getExecutor();
+            if (exec) {
+                exec->invalidate(txn, dl, type);
+            }
         }
     }
 }
@@ -425,25 +441,28 @@ void CursorManager::invalidateDocument(OperationContext* txn,
 std::size_t CursorManager::timeoutCursors(int millisSinceLastCall) {
     vector<ClientCursor*> toDelete;
 
-    {
-        stdx::lock_guard<SimpleMutex> lk(_mutex);
+    for (auto& partition : _cursorPartitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-        for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
+        const size_t firstTimedOut = toDelete.size();
+
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
             ClientCursor* cc = i->second;
             if (cc->shouldTimeout(millisSinceLastCall))
                 toDelete.push_back(cc);
         }
 
-        for (vector<ClientCursor*>::const_iterator i = toDelete.begin(); i != toDelete.end(); ++i) {
-            ClientCursor* cc = *i;
-            _deregisterCursor_inlock(cc);
+        for (size_t i = firstTimedOut; i < toDelete.size(); i++) {
+            ClientCursor* cc = toDelete[i];
+            _deregisterCursor_inlock(&partition, cc);
             cc->kill();
         }
     }
 
-    // ClientCursors must be destroyed without holding '_mutex'. This is because the destruction of
-    // a ClientCursor may itself require accessing this CursorManager (e.g. when deregistering a
-    // non-cached PlanExecutor).
+    // ClientCursors must be destroyed without holding the partition locks. This is because the
+    // destruction of a ClientCursor may itself require accessing this CursorManager (e.g. when
+    // deregistering a non-cached PlanExecutor).
     for (auto* cursor : toDelete) {
         delete cursor;
     }
@@ -452,20 +471,23 @@ std::size_t CursorManager::timeoutCursors(int millisSinceLastCall) {
 }
 
 void CursorManager::registerExecutor(PlanExecutor* exec) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    const std::pair<ExecSet::iterator, bool> result = _nonCachedExecutors.insert(exec);
+    ExecutorPartition& partition = _executorPartition(exec);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    const std::pair<ExecSet::iterator, bool> result = partition.executors.insert(exec);
     invariant(result.second);  // make sure this was inserted
 }
 
 void CursorManager::deregisterExecutor(PlanExecutor* exec) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    _nonCachedExecutors.erase(exec);
+    ExecutorPartition& partition = _executorPartition(exec);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    partition.executors.erase(exec);
 }
 
 ClientCursor* CursorManager::find(CursorId id, bool pin) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    CursorMap::const_iterator it = _cursors.find(id);
-    if (it == _cursors.end())
+    CursorPartition& partition = _cursorPartition(id);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    CursorMap::const_iterator it = partition.cursors.find(id);
+    if (it == partition.cursors.end())
         return NULL;
 
     ClientCursor* cursor = it->second;
@@ -478,7 +500,8 @@ ClientCursor* CursorManager::find(CursorId id, bool pin) {
 }
 
 void CursorManager::unpin(ClientCursor* cursor) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    CursorPartition& partition = _cursorPartition(cursor->cursorid());
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
     invariant(cursor->isPinned());
     cursor->unsetPinned();
@@ -489,50 +512,91 @@ bool CursorManager::ownsCursorId(CursorId cursorId) const {
 }
 
 void CursorManager::getCursorIds(std::set<CursorId>* openCursors) const {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    for (auto& partition : _cursorPartitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        ClientCursor* cc = i->second;
-        openCursors->insert(cc->cursorid());
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
+            ClientCursor* cc = i->second;
+            openCursors->insert(cc->cursorid());
+        }
     }
 }
 
 size_t CursorManager::numCursors() const {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    return _cursors.size();
+    size_t count = 0;
+
+    for (auto& partition : _cursorPartitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+        count += partition.cursors.size();
+    }
+
+    return count;
 }
 
-CursorId CursorManager::_allocateCursorId_inlock() {
-    for (int i = 0; i < 10000; i++) {
-        unsigned mypart = static_cast<unsigned>(_random->nextInt32());
-        CursorId id = cursorIdFromParts(_collectionCacheRuntimeId, mypart);
-        if (_cursors.count(id) == 0)
-            return id;
+CursorManager::ExecutorPartition& CursorManager::_executorPartition(PlanExecutor* exec) {
+    // An executor may be deregistered by a different thread than the one which registered it, so
+    // the partition is chosen by its address. The low bits are dropped, since they are the same
+    // for every heap allocation.
+    const uintptr_t address = reinterpret_cast<uintptr_t>(exec);
+    return _executorPartitions[(address >> 4) % kNumPartitions];
+}
+
+CursorManager::CursorPartition& CursorManager::_cursorPartition(CursorId id) {
+    // The low half of a cursor id is random, so it spreads the cursors evenly.
+    return _cursorPartitions[static_cast<uint64_t>(id) % kNumPartitions];
+}
+
+CursorManager::PartitionLocks CursorManager::_lockAllPartitions() {
+    PartitionLocks locks;
+    locks.reserve(2 * kNumPartitions);
+
+    for (auto& partition : _executorPartitions) {
+        locks.emplace_back(partition.mutex);
     }
-    fassertFailed(17360);
+
+    for (auto& partition : _cursorPartitions) {
+        locks.emplace_back(partition.mutex);
+    }
+
+    return locks;
+}
+
+CursorId CursorManager::_allocateCursorId() {
+    stdx::lock_guard<SimpleMutex> lk(_randomMutex);
+    unsigned mypart = static_cast<unsigned>(_random->nextInt32());
+    return cursorIdFromParts(_collectionCacheRuntimeId, mypart);
 }
 
 CursorId CursorManager::registerCursor(ClientCursor* cc) {
     invariant(cc);
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    CursorId id = _allocateCursorId_inlock();
-    _cursors[id] = cc;
-    return id;
+
+    for (int i = 0; i < 10000; i++) {
+        CursorId id = _allocateCursorId();
+
+        CursorPartition& partition = _cursorPartition(id);
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+        if (partition.cursors.insert(std::make_pair(id, cc)).second)
+            return id;
+    }
+    fassertFailed(17360);
 }
 
 void CursorManager::deregisterCursor(ClientCursor* cc) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    _deregisterCursor_inlock(cc);
+    CursorPartition& partition = _cursorPartition(cc->cursorid());
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    _deregisterCursor_inlock(&partition, cc);
 }
 
 Status CursorManager::eraseCursor(OperationContext* txn, CursorId id, bool shouldAudit) {
     ClientCursor* cursor;
 
     {
-        stdx::lock_guard<SimpleMutex> lk(_mutex);
+        CursorPartition& partition = _cursorPartition(id);
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-        CursorMap::iterator it = _cursors.find(id);
-        if (it == _cursors.end()) {
+        CursorMap::iterator it = partition.cursors.find(id);
+        if (it == partition.cursors.end()) {
             if (shouldAudit) {
                 audit::logKillCursorsAuthzCheck(
                     txn->getClient(), _nss, id, ErrorCodes::CursorNotFound);
@@ -556,19 +620,19 @@ Status CursorManager::eraseCursor(OperationContext* txn, CursorId id, bool shoul
         }
 
         cursor->kill();
-        _deregisterCursor_inlock(cursor);
+        _deregisterCursor_inlock(&partition, cursor);
     }
 
-    // ClientCursors must be destroyed without holding '_mutex'. This is because the destruction of
-    // a ClientCursor may itself require accessing this CursorManager (e.g. when deregistering a
-    // non-cached PlanExecutor).
+    // ClientCursors must be destroyed without holding the partition lock. This is because the
+    // destruction of a ClientCursor may itself require accessing this CursorManager (e.g. when
+    // deregistering a non-cached PlanExecutor).
     delete cursor;
     return Status::OK();
 }
 
-void CursorManager::_deregisterCursor_inlock(ClientCursor* cc) {
+void CursorManager::_deregisterCursor_inlock(CursorPartition* partition, ClientCursor* cc) {
     invariant(cc);
     CursorId id = cc->cursorid();
-    _cursors.erase(id);
+    partition->cursors.erase(id);
 }
 }
@@ -30,12 +30,16 @@
 
 #pragma once
 
+#include <array>
+#include <vector>
 
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/invalidation_type.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/record_id.h"
+#include "mongo/platform/unordered_map.h"
 #include "mongo/platform/unordered_set.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
 
 namespace mongo {
@@ -44,6 +48,15 @@ class OperationContext;
 class PseudoRandom;
 class PlanExecutor;
 
+/**
+ * Keeps track of the PlanExecutors and ClientCursors open on a collection.
+ *
+ * Both registries are split into partitions, each protected by its own mutex, so that queries
+ * registering executors for yielding and looking up cursors for getMore do not all contend on a
+ * single lock. Executors are assigned to a partition by their address and cursors by their id.
+ * Operations which need to see every executor or cursor, such as invalidation, fan out across
+ * all partitions.
+ */
 class CursorManager {
 public:
     CursorManager(StringData ns);
@@ -143,19 +156,43 @@ public:
     static std::size_t timeoutCursorsGlobal(OperationContext* txn, int millisSinceLastCall);
 
 private:
-    CursorId _allocateCursorId_inlock();
-    void _deregisterCursor_inlock(ClientCursor* cc);
+    static const size_t kNumPartitions = 16;
+
+    typedef unordered_set<PlanExecutor*> ExecSet;
+    typedef unordered_map<CursorId, ClientCursor*> CursorMap;
+
+    struct ExecutorPartition {
+        SimpleMutex mutex;
+        ExecSet executors;
+    };
+
+    struct CursorPartition {
+        SimpleMutex mutex;
+        CursorMap cursors;
+    };
+
+    typedef std::vector<stdx::unique_lock<SimpleMutex>> PartitionLocks;
+
+    ExecutorPartition& _executorPartition(PlanExecutor* exec);
+    CursorPartition& _cursorPartition(CursorId id);
+
+    /**
+     * Locks every executor partition followed by every cursor partition, always in the same
+     * order. The locks are released when the returned object goes out of scope.
+     */
+    PartitionLocks _lockAllPartitions();
+
+    CursorId _allocateCursorId();
+    void _deregisterCursor_inlock(CursorPartition* partition, ClientCursor* cc);
 
     NamespaceString _nss;
     unsigned _collectionCacheRuntimeId;
-    std::unique_ptr<PseudoRandom> _random;
 
-    mutable SimpleMutex _mutex;
-
-    typedef unordered_set<PlanExecutor*> ExecSet;
-    ExecSet _nonCachedExecutors;
+    // Protects '_random', which is only used to generate cursor ids
+    SimpleMutex _randomMutex;
+    std::unique_ptr<PseudoRandom> _random;
 
-    typedef std::map<CursorId, ClientCursor*> CursorMap;
-    CursorMap _cursors;
+    std::array<ExecutorPartition, kNumPartitions> _executorPartitions;
+    mutable std::array<CursorPartition, kNumPartitions> _cursorPartitions;
 };
 }
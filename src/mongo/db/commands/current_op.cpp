@@ -167,6 +167,11 @@ public:
                 Locker::LockerInfo lockerInfo;
                 opCtx->lockState()->getLockerInfo(&lockerInfo);
                 fillLockerInfo(lockerInfo, infoBuilder);
+
+                // RecoveryUnit
+                if (opCtx->recoveryUnit()) {
+                    opCtx->recoveryUnit()->reportState(&infoBuilder);
+                }
             }
 
             // If we want to include all results or if the filter is empty, then we can append
@@ -32,6 +32,7 @@
 
 #include "mongo/db/concurrency/lock_manager.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "mongo/base/simple_string_data_comparator.h"
@@ -39,6 +40,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/config.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stringutils.h"
@@ -403,11 +405,25 @@ void LockHead::migratePartitionedLockHeads() {
 // Have more buckets than CPUs to reduce contention on lock and caches
 const unsigned LockManager::_numLockBuckets(128);
 
-// Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+namespace {
+
+/**
+ * Balance scalability of intent locks against potential added cost of conflicting locks. Lockers
+ * that run at the same time should rarely share a partition, so use at least two partitions per
+ * core. The exact value doesn't appear very important, but should be power of two.
+ */
+unsigned numPartitionsForThisMachine() {
+    const unsigned wanted = 2 * std::max(1U, stdx::thread::hardware_concurrency());
+    unsigned numPartitions = 32;
+    while (numPartitions < wanted && numPartitions < 1024) {
+        numPartitions *= 2;
+    }
+    return numPartitions;
+}
+
+}  // namespace
 
-LockManager::LockManager() {
+LockManager::LockManager() : _numPartitions(numPartitionsForThisMachine()) {
     _lockBuckets = new LockBucket[_numLockBuckets];
     _partitions = new Partition[_numPartitions];
 }
@@ -138,13 +138,18 @@ private:
     // The lockheads need access to the partitions
     friend struct LockHead;
 
-    // These types describe the locks hash table
+    // These types describe the locks hash table. Buckets and partitions are padded to 128 bytes,
+    // as neighbouring ones are locked by unrelated threads and would otherwise falsely share the
+    // cache lines holding their mutexes. The arrays come from plain new[], so this spaces them
+    // apart rather than aligning them to cache lines.
 
     struct LockBucket {
         SimpleMutex mutex;
         typedef unordered_map<ResourceId, LockHead*> Map;
         Map data;
         LockHead* findOrInsert(ResourceId resId);
+
+        char _pad[128 - (sizeof(SimpleMutex) + sizeof(Map)) % 128];
     };
 
     // Each locker maps to a partition that is used for resources acquired in intent modes
@@ -156,6 +161,8 @@ private:
         typedef unordered_map<ResourceId, PartitionedLockHead*> Map;
         SimpleMutex mutex;
         Map data;
+
+        char _pad[128 - (sizeof(SimpleMutex) + sizeof(Map)) % 128];
     };
 
     /**
@@ -214,7 +221,7 @@ private:
     static const unsigned _numLockBuckets;
     LockBucket* _lockBuckets;
 
-    static const unsigned _numPartitions;
+    const unsigned _numPartitions;
     Partition* _partitions;
 };
 
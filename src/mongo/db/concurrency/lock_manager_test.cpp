@@ -951,4 +951,52 @@ TEST(LockManager, Fairness) {
     ASSERT(lockMgr.unlock(&requestIX1));
 }
 
+TEST(LockManager, ExclusiveConflictsWithPartitionedCollectionIntentLocks) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    // Intent locks from different lockers, which take the partitioned path
+    MMAPV1LockerImpl lockerIS;
+    LockRequestCombo requestIS(&lockerIS);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS, MODE_IS));
+
+    MMAPV1LockerImpl lockerIX;
+    LockRequestCombo requestIX(&lockerIX);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX, MODE_IX));
+
+    // An exclusive request must still see them
+    MMAPV1LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX, MODE_X));
+
+    MMAPV1LockerImpl lockerIX1;
+    LockRequestCombo requestIX1(&lockerIX1);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestIX1, MODE_IX));
+
+    ASSERT(lockMgr.unlock(&requestIS));
+    ASSERT(lockMgr.unlock(&requestIX));
+    ASSERT_EQ(LOCK_OK, requestX.lastResult);
+
+    ASSERT(lockMgr.unlock(&requestX));
+    ASSERT_EQ(LOCK_OK, requestIX1.lastResult);
+
+    // Only intent modes are granted again, so a new intent lock is partitioned again, and a
+    // second exclusive request must see it as well as the one granted on the lock head
+    MMAPV1LockerImpl lockerIX2;
+    LockRequestCombo requestIX2(&lockerIX2);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX2, MODE_IX));
+
+    MMAPV1LockerImpl lockerX2;
+    LockRequestCombo requestX2(&lockerX2);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX2, MODE_X));
+
+    ASSERT(lockMgr.unlock(&requestIX1));
+    ASSERT_EQ(0, requestX2.numNotifies);
+    ASSERT(lockMgr.unlock(&requestIX2));
+    ASSERT_EQ(LOCK_OK, requestX2.lastResult);
+    ASSERT_EQ(1, requestX2.numNotifies);
+
+    ASSERT(lockMgr.unlock(&requestX2));
+}
+
 }  // namespace mongo
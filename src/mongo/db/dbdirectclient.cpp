@@ -128,6 +128,9 @@ bool DBDirectClient::call(Message& toSend, Message& response, bool assertOk, str
     verify(!dbResponse.response.empty());
     response = std::move(dbResponse.response);
 
+    // The reply is read in place rather than sent, so it must be in a single buffer.
+    response.flatten();
+
     return true;
 }
 
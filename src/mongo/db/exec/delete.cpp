@@ -42,9 +42,11 @@
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/unordered_set.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -82,6 +84,8 @@ DeleteStage::DeleteStage(OperationContext* txn,
       _collection(collection),
       _idRetrying(WorkingSet::INVALID_ID),
       _idReturning(WorkingSet::INVALID_ID) {
+    invariant(!_params.batched ||
+              (_params.isMulti && !_params.returnDeleted && !_params.isExplain));
     _children.emplace_back(child);
 }
 
@@ -93,7 +97,7 @@ bool DeleteStage::isEOF() {
         return true;
     }
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
-        child()->isEOF();
+        _batch.empty() && child()->isEOF();
 }
 
 PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
@@ -116,6 +120,11 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
         return PlanStage::ADVANCED;
     }
 
+    // Write out the current batch before asking our child for more results.
+    if (_batchReady) {
+        return flushBatch(out);
+    }
+
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     if (_idRetrying != WorkingSet::INVALID_ID) {
@@ -149,6 +158,10 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
                 return status;
 
             case PlanStage::IS_EOF:
+                if (!_batch.empty()) {
+                    _batchReady = true;
+                    return flushBatch(out);
+                }
                 return status;
 
             default:
@@ -172,6 +185,20 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     // a fetch. We should always get fetched data, and never just key data.
     invariant(member->hasObj());
 
+    if (_params.batched) {
+        // Whether the document still matches is checked when the batch gets written. Our child
+        // may free the memory of the document as it advances.
+        member->makeObjOwnedIfNeeded();
+        memberFreer.Dismiss();
+        _batch.push_back(id);
+        if (_batch.size() < _batchSizer.getBatchSize()) {
+            return PlanStage::NEED_TIME;
+        }
+
+        _batchReady = true;
+        return flushBatch(out);
+    }
+
     // Ensure the document still exists and matches the predicate.
     bool docStillMatches;
     try {
@@ -201,9 +228,6 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
         member->obj.setValue(deletedDoc.getOwned());
     }
 
-    // TODO: Do we want to buffer docs and delete them in a group rather than saving/restoring state
-    // repeatedly?
-
     WorkingSetCommon::prepareForSnapshotChange(_ws);
     try {
         child()->saveState();
@@ -300,4 +324,73 @@ PlanStage::StageState DeleteStage::prepareToRetryWSM(WorkingSetID idToRetry, Wor
     return NEED_YIELD;
 }
 
+PlanStage::StageState DeleteStage::flushBatch(WorkingSetID* out) {
+    invariant(_batchReady && !_batch.empty());
+
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException& wce) {
+        std::terminate();
+    }
+
+    Timer timer;
+    size_t numDeleted = 0;
+    try {
+        WriteUnitOfWork wunit(getOpCtx());
+        unordered_set<RecordId, RecordId::Hasher> batchRecordIds;
+        for (auto id : _batch) {
+            const RecordId recordId = _ws->get(id)->recordId;
+
+            // A yield may make our child return a document again. The queued copy would not be
+            // refetched, so it must not be deleted twice.
+            if (!batchRecordIds.insert(recordId).second) {
+                continue;
+            }
+
+            // Ensure the document still exists and matches the predicate. This re-fetches the
+            // document if we yielded since it was returned by our child.
+            if (!write_stage_common::ensureStillMatches(
+                    _collection, getOpCtx(), _ws, id, _params.canonicalQuery)) {
+                continue;
+            }
+
+            _collection->deleteDocument(getOpCtx(), recordId, _params.opDebug, _params.fromMigrate);
+            ++numDeleted;
+
+            if (numDeleted == 1 &&
+                MONGO_FAIL_POINT(write_stage_common::writeConflictInWriteBatch)) {
+                throw WriteConflictException();
+            }
+        }
+        wunit.commit();
+    } catch (const WriteConflictException& wce) {
+        // Nothing was deleted. Keep the batch around so we can retry deleting it.
+        _batchSizer.onWriteConflict();
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    _batchSizer.onBatchCommitted(_batch.size(), Microseconds(timer.micros()));
+    _specificStats.docsDeleted += numDeleted;
+
+    for (auto id : _batch) {
+        _ws->free(id);
+    }
+    _batch.clear();
+    _batchReady = false;
+
+    // As restoreState may restore (recreate) cursors, make sure to restore the state outside of
+    // the WriteUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException& wce) {
+        // The batch was committed, so there is nothing to retry.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 }  // namespace mongo
@@ -28,8 +28,10 @@
 
 #pragma once
 
+#include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/write_stage_common.h"
 #include "mongo/db/jsobj.h"
 
 namespace mongo {
@@ -45,6 +47,7 @@ struct DeleteStageParams {
           fromMigrate(false),
           isExplain(false),
           returnDeleted(false),
+          batched(false),
           canonicalQuery(nullptr),
           opDebug(nullptr) {}
 
@@ -62,6 +65,11 @@ struct DeleteStageParams {
     // Should we return the document we just deleted?
     bool returnDeleted;
 
+    // Should we delete several documents per write unit of work? Only valid for multi deletes
+    // which neither return the deleted documents nor are explained, and only if
+    // write_stage_common::canBatchWrites().
+    bool batched;
+
     // The parsed query predicate for this delete. Not owned here.
     CanonicalQuery* canonicalQuery;
 
@@ -119,6 +127,13 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Deletes all the documents in '_batch' within a single write unit of work. If it fails with a
+     * write conflict, the whole batch is kept to be retried on the next call to work() and
+     * NEED_YIELD is returned.
+     */
+    StageState flushBatch(WorkingSetID* out);
+
     DeleteStageParams _params;
 
     // Not owned by us.
@@ -135,6 +150,14 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // In batched mode, the documents waiting to be deleted.
+    std::vector<WorkingSetID> _batch;
+
+    // In batched mode, whether '_batch' must be deleted before asking our child for more results.
+    bool _batchReady = false;
+
+    write_stage_common::WriteBatchSizer _batchSizer;
+
     // Stats
     DeleteStats _specificStats;
 };
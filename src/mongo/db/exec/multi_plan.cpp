@@ -45,6 +45,7 @@
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -208,6 +209,7 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
 
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), _collection);
     size_t numResults = getTrialPeriodNumToReturn(*_query);
+    const bool earlyCutoff = internalQueryPlanEvaluationEarlyCutoff.load();
 
     // Work the plans, stopping when a plan hits EOF or returns some
     // fixed number of results.
@@ -216,6 +218,17 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
         if (!moreToDo) {
             break;
         }
+
+        // Stop spending trial works on plans which are clearly going to lose. The remaining
+        // plans keep running, so the winner still buffers a full batch of results.
+        if (earlyCutoff) {
+            cutOffUnproductivePlans();
+        }
+    }
+
+    _specificStats.trialWorksLimit = numWorks;
+    for (const auto& candidate : _candidates) {
+        _specificStats.trialWorks += candidate.root->getCommonStats()->works;
     }
 
     if (_failure) {
@@ -335,7 +348,7 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
 
     for (size_t ix = 0; ix < _candidates.size(); ++ix) {
         CandidatePlan& candidate = _candidates[ix];
-        if (candidate.failed) {
+        if (candidate.failed || candidate.cutOff) {
             continue;
         }
 
@@ -397,6 +410,11 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
                 _failure = true;
                 return false;
             }
+
+            // If only plans which were cut off remain, rank those.
+            if (_failureCount + _specificStats.plansCutOff == _candidates.size()) {
+                return false;
+            }
         }
     }
 
@@ -405,6 +423,68 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
 
 namespace {
 
+// The probability with which a confidence bound on the productivity of a plan may be wrong.
+const double kCutoffErrorProbability = 0.01;
+
+/**
+ * Returns the half-width of the Hoeffding confidence interval around the productivity (results
+ * per work) of a plan which was worked 'works' times.
+ */
+double productivityBoundWidth(size_t works) {
+    return std::sqrt(std::log(2 / kCutoffErrorProbability) / (2 * static_cast<double>(works)));
+}
+
+double productivity(const CommonStats* stats) {
+    return static_cast<double>(stats->advanced) / stats->works;
+}
+
+}  // namespace
+
+void MultiPlanStage::cutOffUnproductivePlans() {
+    const size_t minWorks = static_cast<size_t>(internalQueryPlanEvaluationCutoffMinWorks.load());
+
+    // Find the highest lower bound on the productivity of the remaining plans.
+    double bestLowerBound = 0;
+    size_t numRemaining = 0;
+    for (const auto& candidate : _candidates) {
+        if (candidate.failed || candidate.cutOff) {
+            continue;
+        }
+
+        const CommonStats* stats = candidate.root->getCommonStats();
+        if (stats->works == 0 || stats->works < minWorks) {
+            return;
+        }
+
+        bestLowerBound =
+            std::max(bestLowerBound, productivity(stats) - productivityBoundWidth(stats->works));
+        ++numRemaining;
+    }
+
+    for (size_t ix = 0; ix < _candidates.size() && numRemaining > 1; ++ix) {
+        CandidatePlan& candidate = _candidates[ix];
+        if (candidate.failed || candidate.cutOff || candidate.solution->hasBlockingStage) {
+            continue;
+        }
+
+        const CommonStats* stats = candidate.root->getCommonStats();
+        const double upperBound = productivity(stats) + productivityBoundWidth(stats->works);
+        if (upperBound >= bestLowerBound) {
+            continue;
+        }
+
+        LOG(2) << "Cutting off query plan " << Explain::getPlanSummary(candidate.root)
+               << " after " << stats->works << " works, productivity " << productivity(stats)
+               << " is below " << bestLowerBound;
+
+        candidate.cutOff = true;
+        ++_specificStats.plansCutOff;
+        --numRemaining;
+    }
+}
+
+namespace {
+
 void invalidateHelper(OperationContext* txn,
                       WorkingSet* ws,  // may flag for review
                       const RecordId& recordId,
@@ -168,6 +168,16 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Stops working the candidate plans whose productivity so far is, with high confidence, below
+     * that of another candidate. Plans with a blocking stage are never cut off, since they do not
+     * produce results until they become unblocked.
+     *
+     * Does nothing until every remaining candidate was worked
+     * 'internalQueryPlanEvaluationCutoffMinWorks' times.
+     */
+    void cutOffUnproductivePlans();
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
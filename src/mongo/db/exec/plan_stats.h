@@ -473,11 +473,21 @@ struct MockStats : public SpecificStats {
 };
 
 struct MultiPlanStats : public SpecificStats {
-    MultiPlanStats() {}
+    MultiPlanStats() : trialWorks(0), trialWorksLimit(0), plansCutOff(0) {}
 
     SpecificStats* clone() const final {
         return new MultiPlanStats(*this);
     }
+
+    // The total number of times the candidate plans were worked during the trial period.
+    size_t trialWorks;
+
+    // The number of times each candidate plan may be worked during the trial period.
+    size_t trialWorksLimit;
+
+    // The number of candidate plans which stopped being worked before the end of the trial
+    // period, because they were clearly less productive than another candidate.
+    size_t plansCutOff;
 };
 
 struct OrStats : public SpecificStats {
@@ -52,6 +52,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -544,6 +545,9 @@ UpdateStage::UpdateStage(OperationContext* txn,
       _idReturning(WorkingSet::INVALID_ID),
       _updatedRecordIds(params.request->isMulti() ? new RecordIdSet() : NULL),
       _doc(params.driver->getDocument()) {
+    invariant(!params.batched ||
+              (params.request->isMulti() && !params.request->shouldReturnAnyDocs() &&
+               !params.request->isExplain()));
     _children.emplace_back(child);
     // We are an update until we fall into the insert case.
     params.driver->setContext(ModifierInterface::ExecInfo::UPDATE_CONTEXT);
@@ -693,14 +697,16 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                 args.update = logObj;
                 args.criteria = idQuery;
                 args.fromMigrate = request->isFromMigration();
-                StatusWith<RecordId> res = _collection->updateDocument(getOpCtx(),
-                                                                       recordId,
-                                                                       oldObj,
-                                                                       newObj,
-                                                                       true,
-                                                                       driver->modsAffectIndices(),
-                                                                       _params.opDebug,
-                                                                       &args);
+                StatusWith<RecordId> res =
+                    _collection->updateDocument(getOpCtx(),
+                                                recordId,
+                                                oldObj,
+                                                newObj,
+                                                true,
+                                                driver->modsAffectIndices(),
+                                                _params.opDebug,
+                                                &args,
+                                                driver->modifiedIndexedPaths());
                 uassertStatusOK(res.getStatus());
                 newRecordId = res.getValue();
             }
@@ -716,9 +722,13 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         // it again.  For an example, see the comment above near declaration of
         // updatedRecordIds.
         //
-        // This must be done after the wunit commits so we are sure we won't be rolling back.
+        // This must be done after the wunit commits so we are sure we won't be rolling back. In
+        // batched mode the enclosing write unit of work may still roll back, so remember what was
+        // added.
         if (_updatedRecordIds && (newRecordId != recordId || driver->modsAffectIndices())) {
-            _updatedRecordIds->insert(newRecordId);
+            if (_updatedRecordIds->insert(newRecordId).second && _params.batched) {
+                _batchUpdatedRecordIds.push_back(newRecordId);
+            }
         }
     }
 
@@ -854,6 +864,7 @@ bool UpdateStage::doneUpdating() {
     // We're done updating if either the child has no more results to give us, or we've
     // already gotten a result back and we're not a multi-update.
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
+        _batch.empty() &&
         (child()->isEOF() || (_specificStats.nMatched > 0 && !_params.request->isMulti()));
 }
 
@@ -923,6 +934,11 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
         return PlanStage::ADVANCED;
     }
 
+    // Write out the current batch before asking our child for more results.
+    if (_batchReady) {
+        return flushBatch(out);
+    }
+
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
@@ -963,6 +979,20 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
             return PlanStage::NEED_TIME;
         }
 
+        if (_params.batched) {
+            // Whether the document still matches is checked when the batch gets written. Our
+            // child may free the memory of the document as it advances.
+            member->makeObjOwnedIfNeeded();
+            memberFreer.Dismiss();
+            _batch.push_back(id);
+            if (_batch.size() < _batchSizer.getBatchSize()) {
+                return PlanStage::NEED_TIME;
+            }
+
+            _batchReady = true;
+            return flushBatch(out);
+        }
+
         bool docStillMatches;
         try {
             docStillMatches = write_stage_common::ensureStillMatches(
@@ -1058,6 +1088,11 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
 
         return PlanStage::NEED_TIME;
     } else if (PlanStage::IS_EOF == status) {
+        if (!_batch.empty()) {
+            _batchReady = true;
+            return flushBatch(out);
+        }
+
         // The child is out of results, but we might not be done yet because we still might
         // have to do an insert.
         return PlanStage::NEED_TIME;
@@ -1154,4 +1189,88 @@ PlanStage::StageState UpdateStage::prepareToRetryWSM(WorkingSetID idToRetry, Wor
     return NEED_YIELD;
 }
 
+PlanStage::StageState UpdateStage::flushBatch(WorkingSetID* out) {
+    invariant(_batchReady && !_batch.empty());
+
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException& wce) {
+        std::terminate();
+    }
+
+    // If the write unit of work does not commit, none of the documents in the batch were updated,
+    // so neither count them nor skip them if they are seen again.
+    const UpdateStats statsBeforeBatch = _specificStats;
+    _batchUpdatedRecordIds.clear();
+    ScopeGuard batchRollback = MakeGuard([&] {
+        _specificStats = statsBeforeBatch;
+        for (const auto& recordId : _batchUpdatedRecordIds) {
+            _updatedRecordIds->erase(recordId);
+        }
+        _batchUpdatedRecordIds.clear();
+    });
+
+    Timer timer;
+    try {
+        WriteUnitOfWork wunit(getOpCtx());
+        RecordIdSet batchRecordIds;
+        for (auto id : _batch) {
+            WorkingSetMember* member = _ws->get(id);
+            RecordId recordId = member->recordId;
+
+            // A yield may make our child return a document again, possibly after it was updated
+            // by an earlier batch or by this one. The queued copy would not be refetched, so it
+            // must not be updated twice.
+            if (!batchRecordIds.insert(recordId).second ||
+                (_updatedRecordIds && _updatedRecordIds->count(recordId) > 0)) {
+                continue;
+            }
+
+            // Ensure the document still exists and matches the predicate. This re-fetches the
+            // document if we yielded since it was returned by our child.
+            if (!write_stage_common::ensureStillMatches(
+                    _collection, getOpCtx(), _ws, id, _params.canonicalQuery)) {
+                continue;
+            }
+
+            transformAndUpdate(member->obj, recordId);
+            ++_specificStats.nMatched;
+
+            if (_specificStats.nMatched == statsBeforeBatch.nMatched + 1 &&
+                MONGO_FAIL_POINT(write_stage_common::writeConflictInWriteBatch)) {
+                throw WriteConflictException();
+            }
+        }
+        wunit.commit();
+    } catch (const WriteConflictException& wce) {
+        // Keep the batch around so we can retry updating it.
+        _batchSizer.onWriteConflict();
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    batchRollback.Dismiss();
+    _batchUpdatedRecordIds.clear();
+    _batchSizer.onBatchCommitted(_batch.size(), Microseconds(timer.micros()));
+
+    for (auto id : _batch) {
+        _ws->free(id);
+    }
+    _batch.clear();
+    _batchReady = false;
+
+    // As restoreState may restore (recreate) cursors, make sure to restore the state outside of
+    // the WriteUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException& wce) {
+        // The batch was committed, so there is nothing to retry.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 }  // namespace mongo
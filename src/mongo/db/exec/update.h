@@ -28,9 +28,11 @@
 
 #pragma once
 
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/write_stage_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/ops/update_driver.h"
 #include "mongo/db/ops/update_request.h"
@@ -44,7 +46,7 @@ struct PlanSummaryStats;
 
 struct UpdateStageParams {
     UpdateStageParams(const UpdateRequest* r, UpdateDriver* d, OpDebug* o)
-        : request(r), driver(d), opDebug(o), canonicalQuery(NULL) {}
+        : request(r), driver(d), opDebug(o), canonicalQuery(NULL), batched(false) {}
 
     // Contains update parameters like whether it's a multi update or an upsert. Not owned.
     // Must outlive the UpdateStage.
@@ -60,6 +62,11 @@ struct UpdateStageParams {
     // Not owned here.
     CanonicalQuery* canonicalQuery;
 
+    // Should we update several documents per write unit of work? Only valid for multi updates
+    // which neither return documents nor are explained, and only if
+    // write_stage_common::canBatchWrites().
+    bool batched;
+
 private:
     // Default constructor not allowed.
     UpdateStageParams();
@@ -181,6 +188,13 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Updates all the documents in '_batch' within a single write unit of work. If it fails with
+     * a write conflict, the whole batch is kept to be retried on the next call to work() and
+     * NEED_YIELD is returned.
+     */
+    StageState flushBatch(WorkingSetID* out);
+
     UpdateStageParams _params;
 
     // Not owned by us.
@@ -213,6 +227,18 @@ private:
     typedef unordered_set<RecordId, RecordId::Hasher> RecordIdSet;
     const std::unique_ptr<RecordIdSet> _updatedRecordIds;
 
+    // In batched mode, the documents waiting to be updated.
+    std::vector<WorkingSetID> _batch;
+
+    // In batched mode, whether '_batch' must be updated before asking our child for more results.
+    bool _batchReady = false;
+
+    // In batched mode, the RecordIds added to '_updatedRecordIds' by the batch being written, which
+    // must be removed again if its write unit of work rolls back.
+    std::vector<RecordId> _batchUpdatedRecordIds;
+
+    write_stage_common::WriteBatchSizer _batchSizer;
+
     // These get reused for each update.
     mutablebson::Document& _doc;
     mutablebson::DamageVector _damages;
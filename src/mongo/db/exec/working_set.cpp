@@ -28,10 +28,12 @@
 
 #include "mongo/db/exec/working_set.h"
 
+#include "mongo/base/init.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_fetcher.h"
+#include "mongo/util/concurrency/threadlocal.h"
 
 namespace mongo {
 
@@ -39,6 +41,70 @@ using std::string;
 
 namespace dps = ::mongo::dotted_path_support;
 
+namespace {
+
+/**
+ * WorkingSetMembers released by the working sets a thread destroys, handed out again to the next
+ * working sets it creates. Short queries such as point reads by _id then allocate no members.
+ */
+struct WorkingSetMemberCache {
+    static const size_t kMaxMembers = 32;
+
+    std::vector<std::unique_ptr<WorkingSetMember>> members;
+};
+
+bool isWorkingSetMemberCacheInitialized = false;
+
+MONGO_INITIALIZER(WorkingSetMemberCache)(InitializerContext*) {
+    isWorkingSetMemberCacheInitialized = true;
+    return Status::OK();
+}
+
+}  // namespace
+
+TSP_DECLARE(WorkingSetMemberCache, workingSetMemberCache);
+TSP_DEFINE(WorkingSetMemberCache, workingSetMemberCache);
+
+namespace {
+
+// During unittests, where we don't use quickExit(), static finalization may destroy the
+// cache before its last use, so mark it as not initialized in that case.
+// This must be after the TSP_DEFINE so that it is destroyed first.
+struct WorkingSetMemberCacheFinalizer {
+    ~WorkingSetMemberCacheFinalizer() {
+        isWorkingSetMemberCacheInitialized = false;
+    }
+} workingSetMemberCacheFinalizer;
+
+WorkingSetMember* makeMember() {
+    if (isWorkingSetMemberCacheInitialized) {
+        auto& members = workingSetMemberCache.getMake()->members;
+        if (!members.empty()) {
+            WorkingSetMember* member = members.back().release();
+            members.pop_back();
+            return member;
+        }
+    }
+    return new WorkingSetMember();
+}
+
+void releaseMember(WorkingSetMember* member) {
+    if (isWorkingSetMemberCacheInitialized) {
+        auto& members = workingSetMemberCache.getMake()->members;
+        if (members.size() < WorkingSetMemberCache::kMaxMembers) {
+            member->clear();
+            member->recordId = RecordId();
+            member->isSuspicious = false;
+            member->setFetcher(nullptr);
+            members.emplace_back(member);
+            return;
+        }
+    }
+    delete member;
+}
+
+}  // namespace
+
 WorkingSet::MemberHolder::MemberHolder() : member(NULL) {}
 WorkingSet::MemberHolder::~MemberHolder() {}
 
@@ -46,7 +112,7 @@ WorkingSet::WorkingSet() : _freeList(INVALID_ID) {}
 
 WorkingSet::~WorkingSet() {
     for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
+        releaseMember(_data[i].member);
     }
 }
 
@@ -58,7 +124,7 @@ WorkingSetID WorkingSet::allocate() {
         WorkingSetID id = _data.size();
         _data.resize(_data.size() + 1);
         _data.back().nextFreeOrSelf = id;
-        _data.back().member = new WorkingSetMember();
+        _data.back().member = makeMember();
         return id;
     }
 
@@ -97,7 +163,7 @@ bool WorkingSet::isFlagged(WorkingSetID id) const {
 
 void WorkingSet::clear() {
     for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
+        releaseMember(_data[i].member);
     }
     _data.clear();
 
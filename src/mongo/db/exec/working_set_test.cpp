@@ -154,4 +154,28 @@ TEST_F(WorkingSetFixture, getDottedFieldFromIndex) {
     ASSERT_FALSE(member->getFieldDotted("y", &elt));
 }
 
+TEST(WorkingSetTest, MembersOfDestroyedWorkingSetsAreReusedCleared) {
+    WorkingSetMember* released;
+    {
+        WorkingSet ws;
+        WorkingSetID id = ws.allocate();
+        released = ws.get(id);
+        released->recordId = RecordId(42);
+        released->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("a" << 1));
+        released->keyData.push_back(IndexKeyDatum(BSON("a" << 1), BSON("" << 1), NULL));
+        released->isSuspicious = true;
+        ws.transitionToOwnedObj(id);
+    }
+
+    WorkingSet ws;
+    WorkingSetMember* member = ws.get(ws.allocate());
+    ASSERT_EQUALS(released, member);
+    ASSERT_EQUALS(WorkingSetMember::INVALID, member->getState());
+    ASSERT_TRUE(member->recordId.isNull());
+    ASSERT_TRUE(member->obj.value().isEmpty());
+    ASSERT_TRUE(member->keyData.empty());
+    ASSERT_FALSE(member->isSuspicious);
+    ASSERT_FALSE(member->hasFetcher());
+}
+
 }  // namespace
@@ -29,12 +29,16 @@
 
 #include "mongo/db/exec/write_stage_common.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
 
 namespace mongo {
 namespace write_stage_common {
@@ -68,5 +72,43 @@ bool ensureStillMatches(const Collection* collection,
     return true;
 }
 
+MONGO_FP_DECLARE(writeConflictInWriteBatch);
+
+bool canBatchWrites() {
+    return internalQueryExecWriteBatchMaxDocs.load() > 1 && supportsDocLocking();
+}
+
+namespace {
+
+size_t maxWriteBatchSize() {
+    return static_cast<size_t>(std::max(1, internalQueryExecWriteBatchMaxDocs.load()));
+}
+
+}  // namespace
+
+WriteBatchSizer::WriteBatchSizer() : _batchSize(std::min<size_t>(16, maxWriteBatchSize())) {}
+
+void WriteBatchSizer::onBatchCommitted(size_t numDocs, Microseconds elapsed) {
+    if (numDocs == 0) {
+        return;
+    }
+
+    const long long target = std::max(1, internalQueryExecWriteBatchTargetMicros.load());
+    const long long perDoc =
+        std::max(1LL, durationCount<Microseconds>(elapsed) / static_cast<long long>(numDocs));
+
+    // Move towards the size which would take the target time, but at most doubling or halving per
+    // batch so that a single slow commit does not collapse the batch size
+    size_t desired = static_cast<size_t>(std::max(1LL, target / perDoc));
+    desired = std::min(desired, _batchSize * 2);
+    desired = std::max(desired, _batchSize / 2);
+
+    _batchSize = std::max<size_t>(1, std::min(desired, maxWriteBatchSize()));
+}
+
+void WriteBatchSizer::onWriteConflict() {
+    _batchSize = std::max<size_t>(1, _batchSize / 2);
+}
+
 }  // namespace write_stage_common
 }  // namespace mongo
@@ -32,6 +32,8 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/exec/working_set.h"
+#include "mongo/util/fail_point_service.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -54,5 +56,45 @@ bool ensureStillMatches(const Collection* collection,
                         WorkingSet* ws,
                         WorkingSetID id,
                         const CanonicalQuery* cq);
-}
-}
+
+// Throws a WriteConflictException after the first document of a batch has been written, leaving
+// the rest of the batch unwritten.
+MONGO_FP_FORWARD_DECLARE(writeConflictInWriteBatch);
+
+/**
+ * Returns true if a multi-update or multi-delete may group the documents it writes into batches,
+ * several per WriteUnitOfWork. Batching requires a storage engine with document-level locking,
+ * because the documents waiting in a batch would not be notified of invalidations.
+ */
+bool canBatchWrites();
+
+/**
+ * Chooses how many documents a batched multi-update or multi-delete writes in a single
+ * WriteUnitOfWork. The size follows the observed per-document write latency so that writing a
+ * batch takes about internalQueryExecWriteBatchTargetMicros, bounded by
+ * internalQueryExecWriteBatchMaxDocs, and is halved on every write conflict.
+ */
+class WriteBatchSizer {
+public:
+    WriteBatchSizer();
+
+    size_t getBatchSize() const {
+        return _batchSize;
+    }
+
+    /**
+     * Records that a batch of 'numDocs' documents was written and committed in 'elapsed'.
+     */
+    void onBatchCommitted(size_t numDocs, Microseconds elapsed);
+
+    /**
+     * Records that writing a batch failed with a write conflict.
+     */
+    void onWriteConflict();
+
+private:
+    size_t _batchSize;
+};
+
+}  // namespace write_stage_common
+}  // namespace mongo
@@ -245,19 +245,22 @@ Status IndexAccessMethod::touch(OperationContext* txn) const {
     return _newInterface->touch(txn);
 }
 
+BSONObj IndexAccessMethod::_singleKey(const BSONObj& requestedKey) const {
+    if (!_btreeState->getCollator()) {
+        return requestedKey;
+    }
+
+    // For performance, call get keys only if there is a non-simple collation.
+    BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    MultikeyPaths* multikeyPaths = nullptr;
+    getKeys(requestedKey, GetKeysMode::kEnforceConstraints, &keys, multikeyPaths);
+    invariant(keys.size() == 1);
+    return *keys.begin();
+}
+
 RecordId IndexAccessMethod::findSingle(OperationContext* txn, const BSONObj& requestedKey) const {
     // Generate the key for this index.
-    BSONObj actualKey;
-    if (_btreeState->getCollator()) {
-        // For performance, call get keys only if there is a non-simple collation.
-        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
-        MultikeyPaths* multikeyPaths = nullptr;
-        getKeys(requestedKey, GetKeysMode::kEnforceConstraints, &keys, multikeyPaths);
-        invariant(keys.size() == 1);
-        actualKey = *keys.begin();
-    } else {
-        actualKey = requestedKey;
-    }
+    const BSONObj actualKey = _singleKey(requestedKey);
 
     std::unique_ptr<SortedDataInterface::Cursor> cursor(_newInterface->newCursor(txn));
     const auto requestedInfo = kDebugBuild ? SortedDataInterface::Cursor::kKeyAndLoc
@@ -274,6 +277,21 @@ RecordId IndexAccessMethod::findSingle(OperationContext* txn, const BSONObj& req
     return RecordId();
 }
 
+StatusWith<RecordId> IndexAccessMethod::prefetchSingle(OperationContext* txn,
+                                                       const BSONObj& requestedKey) const {
+    return _newInterface->prefetch(txn, _singleKey(requestedKey));
+}
+
+Status IndexAccessMethod::estimateSplitKeys(OperationContext* txn,
+                                            const BSONObj& startKey,
+                                            const BSONObj& endKey,
+                                            long long numEntries,
+                                            long long keysPerRange,
+                                            std::vector<BSONObj>* splitKeys) const {
+    return _newInterface->estimateSplitKeys(
+        txn, startKey, endKey, numEntries, keysPerRange, splitKeys);
+}
+
 Status IndexAccessMethod::validate(OperationContext* txn,
                                    int64_t* numKeys,
                                    ValidateResults* fullResults) {
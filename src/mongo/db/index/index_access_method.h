@@ -186,6 +186,27 @@ public:
 
     RecordId findSingle(OperationContext* txn, const BSONObj& key) const;
 
+    /**
+     * Asks the storage engine to bring the entry findSingle() would look up for 'key' into its
+     * cache. See prefetch.cpp.
+     *
+     * @return the RecordId of the entry, a null RecordId if there is none, or
+     *         ErrorCodes::CommandNotSupported if the storage engine cannot prefetch.
+     */
+    StatusWith<RecordId> prefetchSingle(OperationContext* txn, const BSONObj& key) const;
+
+    /**
+     * Estimates keys that split [startKey, endKey) into ranges of about 'keysPerRange' of the
+     * index's 'numEntries' entries, without scanning the range. See
+     * SortedDataInterface::estimateSplitKeys().
+     */
+    Status estimateSplitKeys(OperationContext* txn,
+                             const BSONObj& startKey,
+                             const BSONObj& endKey,
+                             long long numEntries,
+                             long long keysPerRange,
+                             std::vector<BSONObj>* splitKeys) const;
+
     /**
      * Attempt compaction to regain disk space if the indexed record store supports
      * compaction-in-place.
@@ -317,6 +338,12 @@ private:
                       const RecordId& loc,
                       bool dupsAllowed);
 
+    /**
+     * Returns the key of this index that findSingle() and prefetchSingle() look up for
+     * 'requestedKey'.
+     */
+    BSONObj _singleKey(const BSONObj& requestedKey) const;
+
     const std::unique_ptr<SortedDataInterface> _newInterface;
 };
 
@@ -243,6 +243,7 @@ Status UpdateDriver::update(StringData matchedField,
     }
 
     _affectIndices = (isDocReplacement() && (_indexedFields != NULL));
+    _modifiedIndexedPaths.clear();
 
     _logDoc.reset();
     LogBuilder logBuilder(_logDoc.root());
@@ -297,14 +298,21 @@ Status UpdateDriver::update(StringData matchedField,
             // because if there is an index {"a.b": 1}, and we set "a.1.c" and implicitly create an
             // array element in "a", then we may need to add a null key to the index {"a.b": 1},
             // even though "a.1.c" does not appear to affect the index.
-            if (!_affectIndices && !execInfo.noOp && _indexedFields) {
+            //
+            // Every such path is remembered, so that indexes which cover none of them can skip
+            // generating keys.
+            if (!isDocReplacement() && !execInfo.noOp && _indexedFields) {
                 auto pathLengthForIndexCheck = execInfo.indexOfArrayWithNewElement[i]
                     ? *execInfo.indexOfArrayWithNewElement[i] + 1
                     : execInfo.fieldRef[i]->numParts();
-                if (_indexedFields->mightBeIndexed(
-                        execInfo.fieldRef[i]->dottedSubstring(0, pathLengthForIndexCheck))) {
-                    _affectIndices = true;
-                    doc->disableInPlaceUpdates();
+                StringData pathForIndexCheck =
+                    execInfo.fieldRef[i]->dottedSubstring(0, pathLengthForIndexCheck);
+                if (_indexedFields->mightBeIndexed(pathForIndexCheck)) {
+                    _modifiedIndexedPaths.push_back(pathForIndexCheck.toString());
+                    if (!_affectIndices) {
+                        _affectIndices = true;
+                        doc->disableInPlaceUpdates();
+                    }
                 }
             }
         }
@@ -351,6 +359,10 @@ void UpdateDriver::refreshIndexKeys(const UpdateIndexData* indexedFields) {
     _indexedFields = indexedFields;
 }
 
+const std::vector<std::string>* UpdateDriver::modifiedIndexedPaths() const {
+    return isDocReplacement() ? nullptr : &_modifiedIndexedPaths;
+}
+
 bool UpdateDriver::logOp() const {
     return _logOp;
 }
@@ -115,6 +115,13 @@ public:
     bool modsAffectIndices() const;
     void refreshIndexKeys(const UpdateIndexData* indexedFields);
 
+    /**
+     * Returns the paths changed by the last call to update() which might be indexed, so that
+     * indexes covering none of them can be left alone. Returns nullptr if any index may have been
+     * affected, as is the case for a replacement-style update.
+     */
+    const std::vector<std::string>* modifiedIndexedPaths() const;
+
     bool logOp() const;
     void setLogOp(bool logOp);
 
@@ -180,6 +187,9 @@ private:
     // at each call to update.
     bool _affectIndices;
 
+    // The paths which made '_affectIndices' true. Is set anew at each call to update.
+    std::vector<std::string> _modifiedIndexedPaths;
+
     // Do any of the mods require positional match details when calling 'prepare'?
     bool _positional;
 
@@ -152,6 +152,58 @@ TEST(Collator, SetCollationUpdatesModifierInterfaces) {
     ASSERT_TRUE(modified);
 }
 
+TEST(IndexedPaths, OnlyIndexedPathsAreReported) {
+    UpdateIndexData indexedFields;
+    indexedFields.addPath("a");
+    indexedFields.addPath("b");
+
+    UpdateDriver::Options opts;
+    UpdateDriver driver(opts);
+    ASSERT_OK(driver.parse(fromjson("{$set: {a: 2, c: 2}}")));
+    driver.refreshIndexKeys(&indexedFields);
+
+    Document doc(fromjson("{a: 1, b: 1, c: 1}"));
+    ASSERT_OK(driver.update(StringData(), &doc));
+
+    ASSERT_TRUE(driver.modsAffectIndices());
+    ASSERT(driver.modifiedIndexedPaths());
+    ASSERT_EQUALS(driver.modifiedIndexedPaths()->size(), 1U);
+    ASSERT_EQUALS(driver.modifiedIndexedPaths()->front(), "a");
+}
+
+TEST(IndexedPaths, NoOpModsAreNotReported) {
+    UpdateIndexData indexedFields;
+    indexedFields.addPath("a");
+
+    UpdateDriver::Options opts;
+    UpdateDriver driver(opts);
+    ASSERT_OK(driver.parse(fromjson("{$set: {a: 1, c: 2}}")));
+    driver.refreshIndexKeys(&indexedFields);
+
+    Document doc(fromjson("{a: 1, c: 1}"));
+    ASSERT_OK(driver.update(StringData(), &doc));
+
+    ASSERT_FALSE(driver.modsAffectIndices());
+    ASSERT(driver.modifiedIndexedPaths());
+    ASSERT_TRUE(driver.modifiedIndexedPaths()->empty());
+}
+
+TEST(IndexedPaths, ReplacementAffectsAllIndexes) {
+    UpdateIndexData indexedFields;
+    indexedFields.addPath("a");
+
+    UpdateDriver::Options opts;
+    UpdateDriver driver(opts);
+    ASSERT_OK(driver.parse(fromjson("{c: 2}")));
+    driver.refreshIndexKeys(&indexedFields);
+
+    Document doc(fromjson("{a: 1, c: 1}"));
+    ASSERT_OK(driver.update(StringData(), &doc));
+
+    ASSERT_TRUE(driver.modsAffectIndices());
+    ASSERT_FALSE(driver.modifiedIndexedPaths());
+}
+
 //
 // Tests of creating a base for an upsert from a query document
 // $or, $and, $all get special handling, as does the _id field
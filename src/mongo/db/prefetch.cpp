@@ -208,6 +208,63 @@ void prefetchPagesForReplicatedOp(OperationContext* txn, Database* db, const BSO
     }
 }
 
+ReplPrefetchResult prefetchRecordsForReplicatedOp(OperationContext* txn,
+                                                  Database* db,
+                                                  const BSONObj& op) {
+    invariant(db);
+    const char* opField;
+    const char* opType = op.getStringField("op");
+    switch (*opType) {
+        case 'd':  // delete
+            opField = "o";
+            break;
+        case 'u':  // update
+            opField = "o2";
+            break;
+        default:
+            // inserts have nothing to warm yet and other ops are ignored
+            return ReplPrefetchResult::kNotPrefetched;
+    }
+
+    BSONElement _id;
+    if (!op.getObjectField(opField).getObjectID(_id)) {
+        return ReplPrefetchResult::kNotPrefetched;
+    }
+
+    // Unlike prefetchPagesForReplicatedOp, only an intent lock is needed: the engine does its
+    // own concurrency control, and we only read.
+    const char* ns = op.getStringField("ns");
+    Lock::CollectionLock collLock(txn->lockState(), ns, MODE_IS);
+
+    Collection* collection = db->getCollection(ns);
+    if (!collection) {
+        return ReplPrefetchResult::kNotPrefetched;
+    }
+
+    IndexCatalog* catalog = collection->getIndexCatalog();
+    const IndexDescriptor* desc = catalog->findIdIndex(txn);
+    if (!desc) {
+        return ReplPrefetchResult::kNotPrefetched;
+    }
+
+    TimerHolder timer(&prefetchDocStats);
+    StatusWith<RecordId> loc = catalog->getIndex(desc)->prefetchSingle(txn, _id.wrap(""));
+    if (loc.getStatus() == ErrorCodes::CommandNotSupported) {
+        return ReplPrefetchResult::kNotPrefetched;
+    }
+    uassertStatusOK(loc.getStatus());
+    if (loc.getValue().isNull()) {
+        return ReplPrefetchResult::kNotFound;
+    }
+
+    StatusWith<bool> found = collection->getRecordStore()->prefetch(txn, loc.getValue());
+    if (found.getStatus() == ErrorCodes::CommandNotSupported) {
+        return ReplPrefetchResult::kNotPrefetched;
+    }
+    uassertStatusOK(found.getStatus());
+    return found.getValue() ? ReplPrefetchResult::kFound : ReplPrefetchResult::kNotFound;
+}
+
 class ReplIndexPrefetch : public ServerParameter {
 public:
     ReplIndexPrefetch() : ServerParameter(ServerParameterSet::getGlobal(), "replIndexPrefetch") {}
@@ -35,5 +35,18 @@ namespace repl {
 
 // page in possible index and/or data pages for an op from the oplog
 void prefetchPagesForReplicatedOp(OperationContext* txn, Database* db, const BSONObj& op);
+
+// outcome of warming the storage engine's cache for an op from the oplog
+enum class ReplPrefetchResult {
+    kNotPrefetched,  // not an update or delete by _id, or the engine cannot prefetch
+    kFound,          // the _id index entry and the document were brought into the cache
+    kNotFound,       // there is no document with the op's _id
+};
+
+// warm the storage engine's cache with the _id index entry and the document an update or delete
+// from the oplog targets, for engines where StorageEngine::supportsPrefetch() is true
+ReplPrefetchResult prefetchRecordsForReplicatedOp(OperationContext* txn,
+                                                  Database* db,
+                                                  const BSONObj& op);
 }  // namespace repl
 }  // namespace mongo
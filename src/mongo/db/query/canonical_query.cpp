@@ -33,6 +33,7 @@
 #include "mongo/db/query/canonical_query.h"
 
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
@@ -97,6 +98,20 @@ bool matchExpressionLessThan(const MatchExpression* lhs, const MatchExpression*
     return matchExpressionComparator(lhs, rhs) < 0;
 }
 
+/**
+ * Returns true if 'filter' is a single equality on _id to a scalar, the filter of a point read,
+ * for which the MatchExpressionParser would produce nothing but an EqualityMatchExpression.
+ */
+bool isScalarIdEquality(const BSONObj& filter) {
+    BSONObjIterator it(filter);
+    if (!it.more()) {
+        return false;
+    }
+    BSONElement elt = it.next();
+    return !it.more() && str::equals("_id", elt.fieldName()) &&
+        Indexability::isExactBoundsGenerating(elt);
+}
+
 }  // namespace
 
 // static
@@ -131,13 +146,24 @@ StatusWith<std::unique_ptr<CanonicalQuery>> CanonicalQuery::canonicalize(
         collator = std::move(statusWithCollator.getValue());
     }
 
-    // Make MatchExpression.
-    StatusWithMatchExpression statusWithMatcher =
-        MatchExpressionParser::parse(qr->getFilter(), extensionsCallback, collator.get());
-    if (!statusWithMatcher.isOK()) {
-        return statusWithMatcher.getStatus();
+    // Make MatchExpression. Point reads by _id are common enough to build it without the parser.
+    std::unique_ptr<MatchExpression> me;
+    if (isScalarIdEquality(qr->getFilter())) {
+        auto eq = stdx::make_unique<EqualityMatchExpression>();
+        Status eqStatus = eq->init("_id", qr->getFilter().firstElement());
+        if (!eqStatus.isOK()) {
+            return eqStatus;
+        }
+        eq->setCollator(collator.get());
+        me = std::move(eq);
+    } else {
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(qr->getFilter(), extensionsCallback, collator.get());
+        if (!statusWithMatcher.isOK()) {
+            return statusWithMatcher.getStatus();
+        }
+        me = std::move(statusWithMatcher.getValue());
     }
-    std::unique_ptr<MatchExpression> me = std::move(statusWithMatcher.getValue());
 
     // Make the CQ we'll hopefully return.
     std::unique_ptr<CanonicalQuery> cq(new CanonicalQuery());
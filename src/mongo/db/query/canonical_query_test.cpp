@@ -694,5 +694,31 @@ TEST(CanonicalQueryTest, NorWithOneChildNormalizedAfterNormalizingChild) {
     ASSERT_EQ(MatchExpression::EQ, root->getChild(0)->matchType());
 }
 
+TEST(CanonicalQueryTest, IdEqualityMatchesParsedExpression) {
+    for (auto queryStr :
+         {"{_id: 1}", "{_id: 'abc'}", "{_id: {$oid: '000000000000000000000001'}}"}) {
+        unique_ptr<CanonicalQuery> cq(canonicalize(queryStr));
+        unique_ptr<MatchExpression> parsed(parseMatchExpression(fromjson(queryStr)));
+        ASSERT_EQ(MatchExpression::EQ, cq->root()->matchType());
+        ASSERT_TRUE(cq->root()->equivalent(parsed.get()));
+    }
+}
+
+TEST(CanonicalQueryTest, IdEqualityUsesQueryCollator) {
+    QueryTestServiceContext serviceContext;
+    auto txn = serviceContext.makeOperationContext();
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(fromjson("{_id: 'abc'}"));
+    qr->setCollation(BSON("locale"
+                          << "reverse"));
+    auto cq = assertGet(CanonicalQuery::canonicalize(
+        txn.get(), std::move(qr), ExtensionsCallbackDisallowExtensions()));
+    ASSERT_EQ(MatchExpression::EQ, cq->root()->matchType());
+    ASSERT(cq->getCollator());
+    ASSERT_EQUALS(static_cast<EqualityMatchExpression*>(cq->root())->getCollator(),
+                  cq->getCollator());
+}
+
 }  // namespace
 }  // namespace mongo
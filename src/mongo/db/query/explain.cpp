@@ -766,6 +766,16 @@ void Explain::explainStages(PlanExecutor* exec,
         long long totalTimeMillis = CurOp::get(opCtx)->elapsedMicros() / 1000;
         generateExecStats(winningStats.get(), verbosity, &execBob, totalTimeMillis);
 
+        // If we ranked multiple plans against each other, report what the trial period cost.
+        if (mps) {
+            const auto* mpsStats = static_cast<const MultiPlanStats*>(mps->getSpecificStats());
+            BSONObjBuilder trialBob(execBob.subobjStart("trialPeriod"));
+            trialBob.appendNumber("works", mpsStats->trialWorks);
+            trialBob.appendNumber("worksLimit", mpsStats->trialWorksLimit);
+            trialBob.appendNumber("plansCutOff", mpsStats->plansCutOff);
+            trialBob.doneFast();
+        }
+
         // Also generate exec stats for all plans, if the verbosity level is high enough.
         // These stats reflect what happened during the trial period that ranked the plans.
         if (verbosity >= ExplainCommon::EXEC_ALL_PLANS) {
@@ -177,7 +177,7 @@ namespace {
  */
 void generateBatch(int ntoreturn,
                    ClientCursor* cursor,
-                   BufBuilder* bb,
+                   SegmentedMessageBuilder* mb,
                    int* numResults,
                    Timestamp* slaveReadTill,
                    PlanExecutor::ExecState* state) {
@@ -187,13 +187,19 @@ void generateBatch(int ntoreturn,
     while (!FindCommon::enoughForGetMore(ntoreturn, *numResults) &&
            PlanExecutor::ADVANCED == (*state = exec->getNext(&obj, NULL))) {
         // If we can't fit this result inside the current batch, then we stash it for later.
-        if (!FindCommon::haveSpaceForNext(obj, *numResults, bb->len())) {
+        if (!FindCommon::haveSpaceForNext(obj, *numResults, mb->len())) {
             exec->enqueue(obj);
             break;
         }
 
-        // Add result to output buffer.
-        bb->appendBuf((void*)obj.objdata(), obj.objsize());
+        // Add result to the reply. A large result which owns its buffer, such as one produced by a
+        // sort or a projection, is sent from that buffer rather than copied. Anything else may
+        // point into storage engine memory that is only valid until the executor moves on.
+        if (obj.isOwned() && obj.objsize() >= FindCommon::kMinResultSizeToReference) {
+            mb->appendReference(obj.sharedBuffer(), obj.objdata(), obj.objsize());
+        } else {
+            mb->appendCopy(obj.objdata(), obj.objsize());
+        }
 
         // Count the result.
         (*numResults)++;
@@ -306,8 +312,8 @@ Message getMore(OperationContext* txn,
     const int InitialBufSize =
         512 + sizeof(QueryResult::Value) + FindCommon::kMaxBytesToReturnToClientAtOnce;
 
-    BufBuilder bb(InitialBufSize);
-    bb.skip(sizeof(QueryResult::Value));
+    SegmentedMessageBuilder mb(InitialBufSize);
+    mb.buf().skip(sizeof(QueryResult::Value));
 
     if (NULL == cc) {
         cursorid = 0;
@@ -389,7 +395,7 @@ Message getMore(OperationContext* txn,
         PlanSummaryStats preExecutionStats;
         Explain::getSummaryStats(*exec, &preExecutionStats);
 
-        generateBatch(ntoreturn, cc, &bb, &numResults, &slaveReadTill, &state);
+        generateBatch(ntoreturn, cc, &mb, &numResults, &slaveReadTill, &state);
 
         // If this is an await data cursor, and we hit EOF without generating any results, then
         // we block waiting for new data to arrive.
@@ -413,7 +419,7 @@ Message getMore(OperationContext* txn,
 
             // We woke up because either the timed_wait expired, or there was more data. Either
             // way, attempt to generate another batch of results.
-            generateBatch(ntoreturn, cc, &bb, &numResults, &slaveReadTill, &state);
+            generateBatch(ntoreturn, cc, &mb, &numResults, &slaveReadTill, &state);
         }
 
         PlanSummaryStats postExecutionStats;
@@ -488,15 +494,15 @@ Message getMore(OperationContext* txn,
         }
     }
 
-    QueryResult::View qr = bb.buf();
-    qr.msgdata().setLen(bb.len());
+    QueryResult::View qr = mb.buf().buf();
+    qr.msgdata().setLen(mb.len());
     qr.msgdata().setOperation(opReply);
     qr.setResultFlags(resultFlags);
     qr.setCursorId(cursorid);
     qr.setStartingFrom(startingResult);
     qr.setNReturned(numResults);
     LOG(5) << "getMore returned " << numResults << " results\n";
-    return Message(bb.release());
+    return mb.release();
 }
 
 std::string runQuery(OperationContext* txn,
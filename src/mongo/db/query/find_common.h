@@ -55,6 +55,10 @@ public:
     // The initial size of the query response buffer.
     static const int kInitReplyBufferSize = 32768;
 
+    // Results at least this large which own their buffer are sent from that buffer by OP_REPLY
+    // messages instead of being copied into the reply. Smaller ones are cheaper to copy.
+    static const int kMinResultSizeToReference = 1024;
+
     /**
      * Returns true if the batchSize for the initial find has been satisfied.
      *
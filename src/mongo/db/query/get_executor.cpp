@@ -255,10 +255,16 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
             std::move(canonicalQuery), std::move(querySolution), std::move(root));
     }
 
-    // Fill out the planning params.  We use these for both cached solutions and non-cached.
+    const IndexDescriptor* descriptor = collection->getIndexCatalog()->findIdIndex(opCtx);
+
+    // Fill out the planning params.  We use these for both cached solutions and non-cached. An
+    // idhack plan needs none of the index entries, so they are not collected for a query which can
+    // already use one. Applying the collection default collation below never prevents that.
     QueryPlannerParams plannerParams;
     plannerParams.options = plannerOptions;
-    fillOutPlannerParams(opCtx, collection, canonicalQuery.get(), &plannerParams);
+    if (!descriptor || !IDHackStage::supportsQuery(collection, *canonicalQuery)) {
+        fillOutPlannerParams(opCtx, collection, canonicalQuery.get(), &plannerParams);
+    }
 
     // If the canonical query does not have a user-specified collation, set it from the collection
     // default.
@@ -267,21 +273,20 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         canonicalQuery->setCollator(collection->getDefaultCollator()->clone());
     }
 
-    const IndexDescriptor* descriptor = collection->getIndexCatalog()->findIdIndex(opCtx);
-
     // If we have an _id index we can use an idhack plan.
     if (descriptor && IDHackStage::supportsQuery(collection, *canonicalQuery)) {
         LOG(2) << "Using idhack: " << redact(canonicalQuery->toStringShort());
 
         root = make_unique<IDHackStage>(opCtx, collection, canonicalQuery.get(), ws, descriptor);
 
-        // Might have to filter out orphaned docs.
+        // Might have to filter out orphaned docs. There is no shard filter without metadata.
         if (plannerParams.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
-            root = make_unique<ShardFilterStage>(
-                opCtx,
-                CollectionShardingState::get(opCtx, canonicalQuery->nss())->getMetadata(),
-                ws,
-                root.release());
+            auto metadata =
+                CollectionShardingState::get(opCtx, canonicalQuery->nss())->getMetadata();
+            if (metadata) {
+                root =
+                    make_unique<ShardFilterStage>(opCtx, std::move(metadata), ws, root.release());
+            }
         }
 
         // There might be a projection. The idhack stage will always fetch the full
@@ -718,6 +723,8 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorDelete(OperationContext* txn,
     deleteStageParams.returnDeleted = request->shouldReturnDeleted();
     deleteStageParams.sort = request->getSort();
     deleteStageParams.opDebug = opDebug;
+    deleteStageParams.batched = request->isMulti() && !request->shouldReturnDeleted() &&
+        !request->isExplain() && write_stage_common::canBatchWrites();
 
     unique_ptr<WorkingSet> ws = make_unique<WorkingSet>();
     const PlanExecutor::YieldPolicy policy = parsedDelete->yieldPolicy();
@@ -886,6 +893,8 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorUpdate(OperationContext* txn,
 
     unique_ptr<WorkingSet> ws = make_unique<WorkingSet>();
     UpdateStageParams updateStageParams(request, driver, opDebug);
+    updateStageParams.batched = request->isMulti() && !request->shouldReturnAnyDocs() &&
+        !request->isExplain() && write_stage_common::canBatchWrites();
 
     if (!parsedUpdate->hasParsedQuery()) {
         // This is the idhack fast-path for getting a PlanExecutor without doing the work
@@ -70,7 +70,7 @@ public:
  */
 struct CandidatePlan {
     CandidatePlan(QuerySolution* s, PlanStage* r, WorkingSet* w)
-        : solution(s), root(r), ws(w), failed(false) {}
+        : solution(s), root(r), ws(w), failed(false), cutOff(false) {}
 
     std::unique_ptr<QuerySolution> solution;
     PlanStage* root;  // Not owned here.
@@ -80,6 +80,10 @@ struct CandidatePlan {
     std::list<WorkingSetID> results;
 
     bool failed;
+
+    // True if the plan stopped being worked before the end of the trial period, because it was
+    // clearly less productive than another candidate.
+    bool cutOff;
 };
 
 /**
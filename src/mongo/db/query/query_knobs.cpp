@@ -44,6 +44,10 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationCollFraction, double, 0
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxResults, int, 101);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationEarlyCutoff, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationCutoffMinWorks, int, 50);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSize, int, 5000);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheFeedbacksStored, int, 20);
@@ -78,6 +82,10 @@ MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize,
                               int,
                               internalQueryExecYieldIterations / 2);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecWriteBatchMaxDocs, int, 128);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecWriteBatchTargetMicros, int, 5000);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceCursorBatchSizeBytes, int, 4 * 1024 * 1024);
 
 }  // namespace mongo
@@ -49,6 +49,15 @@ extern AtomicDouble internalQueryPlanEvaluationCollFraction;  // NOLINT
 // Stop working plans once a plan returns this many results.
 extern std::atomic<int> internalQueryPlanEvaluationMaxResults;  // NOLINT
 
+// Stop working a candidate plan before the end of the trial period once its productivity is
+// confidently below that of another candidate. Off by default: the bounds are checked after every
+// round of works and across all pairs of plans, so the chance of cutting off the best plan is
+// higher than the confidence of a single bound suggests.
+extern std::atomic<bool> internalQueryPlanEvaluationEarlyCutoff;  // NOLINT
+
+// Number of times every candidate plan is worked before any of them may be cut off early.
+extern std::atomic<int> internalQueryPlanEvaluationCutoffMinWorks;  // NOLINT
+
 // Do we give a big ranking bonus to intersection plans?
 extern std::atomic<bool> internalQueryForceIntersectionPlans;  // NOLINT
 
@@ -113,6 +122,14 @@ extern std::atomic<int> internalQueryFacetBufferSizeBytes;  // NOLINT
 
 extern std::atomic<int> internalInsertMaxBatchSize;  // NOLINT
 
+// Maximum number of documents a multi-update or multi-delete writes in a single write unit of work.
+// Setting it to 1 makes these operations write each document in its own write unit of work.
+extern std::atomic<int> internalQueryExecWriteBatchMaxDocs;  // NOLINT
+
+// Target duration of writing one batch of a multi-update or multi-delete. The batch size adapts
+// to the observed per-document write latency so that each batch takes about this long.
+extern std::atomic<int> internalQueryExecWriteBatchTargetMicros;  // NOLINT
+
 extern std::atomic<int> internalDocumentSourceCursorBatchSizeBytes;  // NOLINT
 
 }  // namespace mongo
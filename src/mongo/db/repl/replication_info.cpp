@@ -46,8 +46,10 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplogreader.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/repl/sync_tail.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/executor/network_interface.h"
@@ -169,6 +171,11 @@ public:
         appendReplicationInfo(txn, result, level);
         getGlobalReplicationCoordinator()->processReplSetGetRBID(&result);
 
+        if (getGlobalServiceContext()->getGlobalStorageEngine()->supportsPrefetch()) {
+            BSONObjBuilder prefetch(result.subobjStart("prefetch"));
+            appendReplPrefetchStats(&prefetch);
+        }
+
         return result.obj();
     }
 
@@ -30,17 +30,68 @@
 
 #include "mongo/db/repl/rollback_source_impl.h"
 
+#include <algorithm>
+
+#include "mongo/client/dbclientcursor.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/cloner.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/repl/oplogreader.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace repl {
 
+namespace {
+
+// The maximum number of _id values sent to the sync source in a single $in query when refetching
+// documents during rollback.
+MONGO_EXPORT_SERVER_PARAMETER(rollbackRefetchBatchSize, int, 5000);
+// The maximum number of connections to the sync source used to refetch documents in parallel.
+MONGO_EXPORT_SERVER_PARAMETER(rollbackRefetchMaxStreams, int, 4);
+
+// Keeps each refetch query well below the maximum BSON object size when _id values are large.
+const int kMaxRefetchQueryBytes = 8 * 1024 * 1024;
+
+/**
+ * Splits 'ids' into {_id: {$in: [...]}} queries of at most rollbackRefetchBatchSize values each.
+ */
+std::vector<BSONObj> makeRefetchQueries(const std::vector<BSONElement>& ids) {
+    const int batchSize = std::max(1, rollbackRefetchBatchSize.load());
+    std::vector<BSONObj> queries;
+    auto it = ids.begin();
+    while (it != ids.end()) {
+        BSONArrayBuilder inBuilder;
+        for (int n = 0; it != ids.end() && n < batchSize && inBuilder.len() < kMaxRefetchQueryBytes;
+             ++it, ++n) {
+            inBuilder.append(*it);
+        }
+        queries.push_back(BSON("_id" << BSON("$in" << inBuilder.arr())));
+    }
+    return queries;
+}
+
+void runRefetchQuery(DBClientBase* conn,
+                     const NamespaceString& nss,
+                     const BSONObj& query,
+                     std::vector<BSONObj>* docs) {
+    auto cursor = conn->query(nss.ns(), query, 0, 0, nullptr, QueryOption_SlaveOk);
+    uassert(ErrorCodes::HostUnreachable,
+            str::stream() << "rollback failed to query " << nss.ns() << " on sync source",
+            cursor);
+    while (cursor->more()) {
+        docs->push_back(cursor->nextSafe().getOwned());
+    }
+}
+
+}  // namespace
+
 RollbackSourceImpl::RollbackSourceImpl(GetConnectionFn getConnection,
                                        const HostAndPort& source,
                                        const std::string& collectionName)
@@ -68,17 +119,78 @@ BSONObj RollbackSourceImpl::findOne(const NamespaceString& nss, const BSONObj& f
     return _getConnection()->findOne(nss.toString(), filter, NULL, QueryOption_SlaveOk).getOwned();
 }
 
-void RollbackSourceImpl::copyCollectionFromRemote(OperationContext* txn,
-                                                  const NamespaceString& nss) const {
+std::vector<BSONObj> RollbackSourceImpl::findByIds(const NamespaceString& nss,
+                                                   const std::vector<BSONElement>& ids) const {
+    const auto queries = makeRefetchQueries(ids);
+    const size_t maxStreams = std::max(1, rollbackRefetchMaxStreams.load());
+    const size_t numStreams = std::min(queries.size(), maxStreams);
+
+    std::vector<std::vector<BSONObj>> streamDocs(numStreams);
+    std::vector<Status> streamStatuses(numStreams, Status::OK());
+    AtomicWord<size_t> nextQuery{0};
+
+    auto runStream = [&](size_t stream, DBClientBase* conn) {
+        try {
+            size_t i;
+            while ((i = nextQuery.fetchAndAdd(1)) < queries.size()) {
+                runRefetchQuery(conn, nss, queries[i], &streamDocs[stream]);
+            }
+        } catch (const DBException& ex) {
+            streamStatuses[stream] = ex.toStatus();
+        }
+    };
+
+    // The first stream runs on this thread over the existing connection to the sync source. Every
+    // additional stream opens its own connection, since a connection cannot be shared.
+    std::vector<stdx::thread> threads;
+    ON_BLOCK_EXIT([&threads] {
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+    });
+    for (size_t stream = 1; stream < numStreams; ++stream) {
+        threads.emplace_back([&, stream] {
+            try {
+                auto conn = _connectToSource();
+                runStream(stream, conn.get());
+            } catch (const DBException& ex) {
+                streamStatuses[stream] = ex.toStatus();
+            }
+        });
+    }
+    if (numStreams > 0) {
+        runStream(0, _getConnection());
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+
+    std::vector<BSONObj> docs;
+    for (size_t stream = 0; stream < numStreams; ++stream) {
+        uassertStatusOK(streamStatuses[stream]);
+        docs.insert(docs.end(), streamDocs[stream].begin(), streamDocs[stream].end());
+    }
+    return docs;
+}
+
+std::unique_ptr<DBClientConnection> RollbackSourceImpl::_connectToSource() const {
     std::string errmsg;
-    std::unique_ptr<DBClientConnection> tmpConn(new DBClientConnection());
+    std::unique_ptr<DBClientConnection> conn(new DBClientConnection());
     uassert(15908,
             errmsg,
-            tmpConn->connect(_source, StringData(), errmsg) && replAuthenticate(tmpConn.get()));
+            conn->connect(_source, StringData(), errmsg) && replAuthenticate(conn.get()));
+    return conn;
+}
+
+void RollbackSourceImpl::copyCollectionFromRemote(OperationContext* txn,
+                                                  const NamespaceString& nss) const {
+    std::unique_ptr<DBClientConnection> tmpConn = _connectToSource();
 
     // cloner owns _conn in unique_ptr
     Cloner cloner;
     cloner.setConnection(tmpConn.release());
+    std::string errmsg;
     uassert(15909,
             str::stream() << "replSet rollback error resyncing collection " << nss.ns() << ' '
                           << errmsg,
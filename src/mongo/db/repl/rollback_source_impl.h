@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "mongo/db/repl/oplog_interface_remote.h"
 #include "mongo/db/repl/rollback_source.h"
@@ -38,6 +40,7 @@
 namespace mongo {
 
 class DBClientBase;
+class DBClientConnection;
 
 namespace repl {
 
@@ -64,10 +67,24 @@ public:
 
     BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const override;
 
+    /**
+     * Refetches the documents with $in queries on _id, spread over up to
+     * rollbackRefetchMaxStreams connections to the sync source.
+     */
+    std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                   const std::vector<BSONElement>& ids) const override;
+
     void copyCollectionFromRemote(OperationContext* txn, const NamespaceString& nss) const override;
 
     StatusWith<BSONObj> getCollectionInfo(const NamespaceString& nss) const override;
 
+protected:
+    /**
+     * Opens and authenticates a new connection to the sync source.
+     * Virtual for testing.
+     */
+    virtual std::unique_ptr<DBClientConnection> _connectToSource() const;
+
 private:
     GetConnectionFn _getConnection;
     HostAndPort _source;
@@ -0,0 +1,189 @@
+/**
+ *    Copyright 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/repl/rollback_source_impl.h"
+#include "mongo/dbtests/mock/mock_dbclient_connection.h"
+#include "mongo/dbtests/mock/mock_dbclient_cursor.h"
+#include "mongo/dbtests/mock/mock_remote_db_server.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+const HostAndPort kSource("source:27017");
+const NamespaceString kNss("test.t");
+
+/**
+ * Tracks the _id values that the sync source was queried for, over every connection.
+ */
+class RefetchLog {
+public:
+    void record(int id) {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        ++_fetched[id];
+    }
+
+    std::map<int, int> fetched() const {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        return _fetched;
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+    std::map<int, int> _fetched;
+};
+
+/**
+ * Connection to the sync source that answers {_id: {$in: [...]}} queries with a document for
+ * every _id, and records each of them in 'log'.
+ */
+class RefetchConnection : public MockDBClientConnection {
+public:
+    RefetchConnection(MockRemoteDBServer* server, RefetchLog* log)
+        : MockDBClientConnection(server), _log(log) {}
+
+    std::unique_ptr<DBClientCursor> query(const std::string& ns,
+                                          Query query,
+                                          int nToReturn,
+                                          int nToSkip,
+                                          const BSONObj* fieldsToReturn,
+                                          int queryOptions,
+                                          int batchSize) override {
+        ASSERT_EQUALS(kNss.ns(), ns);
+        BSONArrayBuilder docs;
+        for (auto&& id : query.getFilter()["_id"]["$in"].Obj()) {
+            _log->record(id.numberInt());
+            docs.append(BSON("_id" << id.numberInt() << "x" << 1));
+        }
+        return stdx::make_unique<MockDBClientCursor>(this, docs.arr());
+    }
+
+private:
+    RefetchLog* const _log;
+};
+
+/**
+ * RollbackSourceImpl that opens its additional connections to a RefetchConnection.
+ */
+class RollbackSourceWithRefetchConnections : public RollbackSourceImpl {
+public:
+    RollbackSourceWithRefetchConnections(DBClientBase* conn,
+                                         MockRemoteDBServer* server,
+                                         RefetchLog* log)
+        : RollbackSourceImpl([conn] { return conn; }, kSource, "local.oplog.rs"),
+          _server(server),
+          _log(log) {}
+
+    int getConnectionsOpened() const {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        return _connectionsOpened;
+    }
+
+protected:
+    std::unique_ptr<DBClientConnection> _connectToSource() const override {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        ++_connectionsOpened;
+        return stdx::make_unique<RefetchConnection>(_server, _log);
+    }
+
+private:
+    MockRemoteDBServer* const _server;
+    RefetchLog* const _log;
+
+    mutable stdx::mutex _mutex;
+    mutable int _connectionsOpened = 0;
+};
+
+TEST(RollbackSourceImplTest, FindByIdsFetchesEveryIdOnceOverSeveralStreams) {
+    MockRemoteDBServer server(kSource.toString());
+    RefetchLog log;
+    RefetchConnection conn(&server, &log);
+    RollbackSourceWithRefetchConnections rollbackSource(&conn, &server, &log);
+
+    // More ids than fit in the refetch queries of all the streams together, with the default
+    // rollbackRefetchBatchSize of 5000 and rollbackRefetchMaxStreams of 4.
+    const int numIds = 4 * 5000 + 123;
+    BSONArrayBuilder idsBuilder;
+    for (int i = 0; i < numIds; ++i) {
+        idsBuilder.append(i);
+    }
+    const BSONObj idsObj = idsBuilder.obj();
+    std::vector<BSONElement> ids;
+    for (auto&& id : idsObj) {
+        ids.push_back(id);
+    }
+
+    const std::vector<BSONObj> docs = rollbackSource.findByIds(kNss, ids);
+
+    // One connection per stream besides the existing one.
+    ASSERT_EQUALS(3, rollbackSource.getConnectionsOpened());
+
+    const std::map<int, int> fetched = log.fetched();
+    ASSERT_EQUALS(static_cast<size_t>(numIds), fetched.size());
+    for (auto&& entry : fetched) {
+        ASSERT_EQUALS(1, entry.second) << "_id: " << entry.first;
+    }
+
+    ASSERT_EQUALS(static_cast<size_t>(numIds), docs.size());
+    std::vector<int> returned(numIds, 0);
+    for (auto&& doc : docs) {
+        const int id = doc["_id"].numberInt();
+        ASSERT_GTE(id, 0);
+        ASSERT_LT(id, numIds);
+        ++returned[id];
+        ASSERT_EQUALS(1, doc["x"].numberInt());
+    }
+    for (int i = 0; i < numIds; ++i) {
+        ASSERT_EQUALS(1, returned[i]) << "_id: " << i;
+    }
+}
+
+TEST(RollbackSourceImplTest, FindByIdsWithoutIdsQueriesNothing) {
+    MockRemoteDBServer server(kSource.toString());
+    RefetchLog log;
+    RefetchConnection conn(&server, &log);
+    RollbackSourceWithRefetchConnections rollbackSource(&conn, &server, &log);
+
+    ASSERT_TRUE(rollbackSource.findByIds(kNss, {}).empty());
+    ASSERT_EQUALS(0, rollbackSource.getConnectionsOpened());
+    ASSERT_TRUE(log.fetched().empty());
+}
+
+}  // namespace
@@ -64,10 +64,13 @@
 #include "mongo/db/repl/rslog.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/s/shard_identity_rollback_notifier.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 /* Scenarios
  *
@@ -125,6 +128,9 @@ namespace repl {
 MONGO_FP_DECLARE(rollbackHangBeforeFinish);
 MONGO_FP_DECLARE(rollbackHangThenFailAfterWritingMinValid);
 
+// The number of refetched documents re-applied under a single WriteUnitOfWork during rollback.
+MONGO_EXPORT_SERVER_PARAMETER(rollbackApplyBatchSize, int, 1000);
+
 using namespace rollback_internal;
 
 bool DocID::operator<(const DocID& other) const {
@@ -375,6 +381,43 @@ void checkRbidAndUpdateMinValid(OperationContext* opCtx,
     }
 }
 
+/**
+ * Holds the database lock and, unless the collection is capped, the WriteUnitOfWork shared by a
+ * batch of refetched documents being re-applied to a single namespace, so that the storage engine
+ * commits one transaction per batch instead of one per document. Capped collections are rolled
+ * back by truncation, which must not run inside an enclosing WriteUnitOfWork.
+ */
+class RollbackApplyBatch {
+    MONGO_DISALLOW_COPYING(RollbackApplyBatch);
+
+public:
+    RollbackApplyBatch(OperationContext* opCtx, const std::string& ns)
+        : _transaction(opCtx, MODE_IX),
+          _dbLock(opCtx->lockState(), nsToDatabaseSubstring(ns), MODE_X),
+          _ctx(opCtx, ns) {
+        Collection* collection = _ctx.db()->getCollection(ns);
+        if (!collection || !collection->isCapped()) {
+            _wunit.emplace(opCtx);
+        }
+    }
+
+    Database* db() const {
+        return _ctx.db();
+    }
+
+    void commit() {
+        if (_wunit) {
+            _wunit->commit();
+        }
+    }
+
+private:
+    ScopedTransaction _transaction;
+    Lock::DBLock _dbLock;
+    OldClientContext _ctx;
+    boost::optional<WriteUnitOfWork> _wunit;
+};
+
 void syncFixUp(OperationContext* opCtx,
                const FixUpInfo& fixUpInfo,
                const RollbackSource& rollbackSource,
@@ -387,34 +430,62 @@ void syncFixUp(OperationContext* opCtx,
     // namespace -> doc id -> doc
     map<string, map<DocID, BSONObj>> goodVersions;
 
-    // fetch all the goodVersions of each document from current primary
+    // Fetch all the goodVersions of each document from current primary. docsToRefetch is ordered
+    // by namespace, so each namespace is refetched with a few batched queries on _id instead of
+    // one round trip per document.
     unsigned long long numFetched = 0;
-    for (auto&& doc : fixUpInfo.docsToRefetch) {
-        invariant(!doc._id.eoo());  // This is checked when we insert to the set.
+    Timer refetchTimer;
+    auto docIt = fixUpInfo.docsToRefetch.begin();
+    while (docIt != fixUpInfo.docsToRefetch.end()) {
+        const char* ns = docIt->ns;
+        auto& nsGoodVersions = goodVersions[ns];
+        std::vector<BSONElement> ids;
+        for (; docIt != fixUpInfo.docsToRefetch.end() && strcmp(docIt->ns, ns) == 0; ++docIt) {
+            invariant(!docIt->_id.eoo());  // This is checked when we insert to the set.
+            ids.push_back(docIt->_id);
+
+            // An empty document means it wasn't found on the primary and we should delete it.
+            nsGoodVersions[*docIt] = BSONObj();
+        }
 
+        std::vector<BSONObj> goodDocs;
         try {
-            // TODO : slow.  lots of round trips.
-            numFetched++;
-            BSONObj good = rollbackSource.findOne(NamespaceString(doc.ns), doc._id.wrap());
-            totalSize += good.objsize();
-            if (totalSize >= 300 * 1024 * 1024) {
-                throw RSFatalException("replSet too much data to roll back");
-            }
-
-            // Note good might be empty, indicating we should delete it.
-            goodVersions[doc.ns][doc] = good;
+            goodDocs = rollbackSource.findByIds(NamespaceString(ns), ids);
         } catch (const DBException& ex) {
             // If the collection turned into a view, we might get an error trying to
             // refetch documents, but these errors should be ignored, as we'll be creating
             // the view during oplog replay.
-            if (ex.getCode() == ErrorCodes::CommandNotSupportedOnView)
+            if (ex.getCode() == ErrorCodes::CommandNotSupportedOnView) {
+                goodVersions.erase(ns);
+                numFetched += ids.size();
                 continue;
+            }
 
-            log() << "rollback couldn't re-get from ns: " << doc.ns << " _id: " << redact(doc._id)
+            log() << "rollback couldn't re-get " << ids.size() << " documents from ns: " << ns
                   << ' ' << numFetched << '/' << fixUpInfo.docsToRefetch.size() << ": "
                   << redact(ex);
             throw;
         }
+        numFetched += ids.size();
+
+        for (const auto& good : goodDocs) {
+            totalSize += good.objsize();
+            if (totalSize >= 300 * 1024 * 1024) {
+                throw RSFatalException("replSet too much data to roll back");
+            }
+
+            // The sync source may return extra documents whose _id only matches one of ours under
+            // the collection's collation; those are not ours to restore.
+            auto goodIt = nsGoodVersions.find(DocID{good, ns, good["_id"]});
+            if (goodIt != nsGoodVersions.end()) {
+                goodIt->second = good;
+            }
+        }
+
+        const long long elapsedMillis = std::max(refetchTimer.millis(), 1);
+        log() << "rollback refetched " << numFetched << '/' << fixUpInfo.docsToRefetch.size()
+              << " documents (" << totalSize << " bytes) in " << elapsedMillis << "ms, "
+              << (numFetched * 1000 / elapsedMillis) << " docs/sec";
     }
 
     log() << "rollback 3.5";
@@ -613,8 +684,14 @@ void syncFixUp(OperationContext* opCtx,
 
     log() << "rollback 4.7";
     unsigned deletes = 0, updates = 0;
+    size_t numDocsToFix = 0;
+    for (const auto& nsAndGoodVersionsByDocID : goodVersions) {
+        numDocsToFix += nsAndGoodVersionsByDocID.second.size();
+    }
+    const size_t applyBatchSize = std::max(1, rollbackApplyBatchSize.load());
     time_t lastProgressUpdate = time(0);
     time_t progressUpdateGap = 10;
+    Timer applyTimer;
     for (const auto& nsAndGoodVersionsByDocID : goodVersions) {
         // Keep an archive of items rolled back if the collection has not been dropped
         // while rolling back createCollection operations.
@@ -624,12 +701,16 @@ void syncFixUp(OperationContext* opCtx,
         removeSaver.reset(new Helpers::RemoveSaver("rollback", "", ns));
 
         const auto& goodVersionsByDocID = nsAndGoodVersionsByDocID.second;
+        std::unique_ptr<RollbackApplyBatch> batch;
+        size_t numInBatch = 0;
         for (const auto& idAndDoc : goodVersionsByDocID) {
             time_t now = time(0);
             if (now - lastProgressUpdate > progressUpdateGap) {
                 log() << deletes << " delete and " << updates
-                      << " update operations processed out of " << goodVersions.size()
-                      << " total operations";
+                      << " update operations processed out of " << numDocsToFix
+                      << " total operations, "
+                      << (deletes + updates) * 1000ULL / std::max(applyTimer.millis(), 1)
+                      << " ops/sec";
                 lastProgressUpdate = now;
             }
             const DocID& doc = idAndDoc.first;
@@ -638,13 +719,13 @@ void syncFixUp(OperationContext* opCtx,
                 verify(doc.ns && *doc.ns);
                 invariant(!fixUpInfo.collectionsToResyncData.count(doc.ns));
 
-                // TODO: Lots of overhead in context. This can be faster.
-                const NamespaceString docNss(doc.ns);
-                ScopedTransaction transaction(opCtx, MODE_IX);
-                Lock::DBLock docDbLock(opCtx->lockState(), docNss.db(), MODE_X);
-                OldClientContext ctx(opCtx, doc.ns);
+                if (!batch) {
+                    batch = stdx::make_unique<RollbackApplyBatch>(opCtx, ns);
+                }
 
-                Collection* collection = ctx.db()->getCollection(doc.ns);
+                // Look the collection up for every document, since an upsert in this batch may
+                // have created it.
+                Collection* collection = batch->db()->getCollection(doc.ns);
 
                 // Add the doc to our rollback file if the collection was not dropped while
                 // rolling back createCollection operations.
@@ -743,7 +824,13 @@ void syncFixUp(OperationContext* opCtx,
                     UpdateLifecycleImpl updateLifecycle(requestNs);
                     request.setLifecycle(&updateLifecycle);
 
-                    update(opCtx, ctx.db(), request);
+                    update(opCtx, batch->db(), request);
+                }
+
+                if (++numInBatch == applyBatchSize) {
+                    batch->commit();
+                    batch.reset();
+                    numInBatch = 0;
                 }
             } catch (const DBException& e) {
                 log() << "exception in rollback ns:" << doc.ns << ' ' << pattern.toString() << ' '
@@ -751,9 +838,14 @@ void syncFixUp(OperationContext* opCtx,
                 throw;
             }
         }
+
+        if (batch) {
+            batch->commit();
+        }
     }
 
-    log() << "rollback 5 d:" << deletes << " u:" << updates;
+    log() << "rollback 5 d:" << deletes << " u:" << updates << " in " << applyTimer.millis()
+          << "ms";
     log() << "rollback 6";
 
     // clean up oplog
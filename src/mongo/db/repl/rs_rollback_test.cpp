@@ -957,6 +957,75 @@ TEST_F(RSRollbackTest, RollbackApplyOpsCommand) {
         << result;
 }
 
+TEST_F(RSRollbackTest, RollbackRefetchesDocumentsInOneBatchPerNamespace) {
+    createOplog(_opCtx.get());
+    auto commonOperation =
+        std::make_pair(BSON("ts" << Timestamp(Seconds(1), 0) << "h" << 1LL), RecordId(1));
+    auto makeInsertOperation = [](int seconds, StringData ns, int id) {
+        return std::make_pair(BSON("ts" << Timestamp(Seconds(seconds), 0) << "h" << 1LL << "op"
+                                        << "i"
+                                        << "ns"
+                                        << ns
+                                        << "o"
+                                        << BSON("_id" << id)),
+                              RecordId(seconds));
+    };
+
+    class RollbackSourceLocal : public RollbackSourceMock {
+    public:
+        RollbackSourceLocal(std::unique_ptr<OplogInterface> oplog)
+            : RollbackSourceMock(std::move(oplog)) {}
+
+        BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const override {
+            FAIL("Unexpected findOne request") << filter;
+            return {};  // Unreachable.
+        }
+
+        std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                       const std::vector<BSONElement>& ids) const override {
+            batches.emplace(nss.ns(), ids.size());
+            std::vector<BSONObj> docs;
+            for (const auto& id : ids) {
+                // Only the document with _id 2 still exists on the sync source.
+                if (id.numberInt() == 2) {
+                    docs.push_back(BSON("_id" << 2 << "v" << 1));
+                }
+            }
+            return docs;
+        }
+
+        // Namespace -> number of _id values in each batch requested for that namespace.
+        mutable std::multimap<std::string, size_t> batches;
+    } rollbackSource(std::unique_ptr<OplogInterface>(new OplogInterfaceMock({commonOperation})));
+
+    _createCollection(_opCtx.get(), "test.t", CollectionOptions());
+    _createCollection(_opCtx.get(), "test.u", CollectionOptions());
+    ASSERT_OK(syncRollback(_opCtx.get(),
+                           OplogInterfaceMock({makeInsertOperation(5, "test.u", 1),
+                                               makeInsertOperation(4, "test.t", 3),
+                                               makeInsertOperation(3, "test.t", 2),
+                                               makeInsertOperation(2, "test.t", 1),
+                                               commonOperation}),
+                           rollbackSource,
+                           {},
+                           _coordinator,
+                           &_storageInterface));
+    ASSERT_EQUALS(2U, rollbackSource.batches.size());
+    ASSERT_EQUALS(1U, rollbackSource.batches.count("test.t"));
+    ASSERT_EQUALS(3U, rollbackSource.batches.find("test.t")->second);
+    ASSERT_EQUALS(1U, rollbackSource.batches.count("test.u"));
+    ASSERT_EQUALS(1U, rollbackSource.batches.find("test.u")->second);
+
+    AutoGetCollectionForRead acr(_opCtx.get(), "test.t");
+    BSONObj result;
+    ASSERT_FALSE(Helpers::findOne(_opCtx.get(), acr.getCollection(), BSON("_id" << 1), result))
+        << result;
+    ASSERT(Helpers::findOne(_opCtx.get(), acr.getCollection(), BSON("_id" << 2), result));
+    ASSERT_EQUALS(1, result["v"].numberInt()) << result;
+    ASSERT_FALSE(Helpers::findOne(_opCtx.get(), acr.getCollection(), BSON("_id" << 3), result))
+        << result;
+}
+
 TEST_F(RSRollbackTest, RollbackCreateCollectionCommand) {
     createOplog(_opCtx.get());
     auto commonOperation =
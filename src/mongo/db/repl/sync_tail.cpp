@@ -139,6 +139,11 @@ public:
     }
 } exportedBatchLimitOperationsParam;
 
+// Number of threads that warm the storage engine's cache for the next batch of updates and
+// deletes while the current batch is applied. Only used by engines that support prefetch, and
+// 0 disables it.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replPrefetchThreadCount, int, 16);
+
 // The oplog entries applied
 Counter64 opsAppliedStats;
 ServerStatusMetricField<Counter64> displayOpsApplied("repl.apply.ops", &opsAppliedStats);
@@ -151,6 +156,15 @@ ServerStatusMetricField<Counter64> displayAttemptsToBecomeSecondary(
 // Number and time of each ApplyOps worker pool round
 TimerStats applyBatchStats;
 ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches", &applyBatchStats);
+
+// Batches prefetched ahead of application, batches skipped because the prefetcher was still busy
+// with the previous one, and the prefetched ops that did and did not find their document. Whether
+// the lookups were served from the engine's cache is not known here. Reported in serverStatus.repl.
+Counter64 prefetchBatches;
+Counter64 prefetchBatchesSkipped;
+Counter64 prefetchFound;
+Counter64 prefetchNotFound;
+
 void initializePrefetchThread() {
     if (!Client::getCurrent()) {
         Client::initThreadIfNotAlready();
@@ -678,7 +692,8 @@ class SyncTail::OpQueueBatcher {
     MONGO_DISALLOW_COPYING(OpQueueBatcher);
 
 public:
-    OpQueueBatcher(SyncTail* syncTail) : _syncTail(syncTail), _thread([this] { run(); }) {}
+    OpQueueBatcher(SyncTail* syncTail)
+        : _syncTail(syncTail), _prefetcher(ReplPrefetcher::make()), _thread([this] { run(); }) {}
     ~OpQueueBatcher() {
         invariant(_isDead);
         _thread.join();
@@ -753,6 +768,11 @@ private:
                 continue;  // Don't emit empty batches.
             }
 
+            // The previous batch is being applied while we wait for it to be taken below.
+            if (_prefetcher) {
+                _prefetcher->prefetchAhead(ops.getBatch());
+            }
+
             stdx::unique_lock<stdx::mutex> lk(_mutex);
             // Block until the previous batch has been taken.
             _cv.wait(lk, [&] { return _ops.empty(); });
@@ -775,6 +795,9 @@ private:
     // TODO remove once we trust noexcept enough to mark oplogApplication() as noexcept.
     bool _isDead = false;
 
+    // Null unless the storage engine supports prefetch.
+    std::unique_ptr<ReplPrefetcher> _prefetcher;
+
     stdx::thread _thread;  // Must be last so all other members are initialized before starting.
 };
 
@@ -1292,6 +1315,98 @@ Status multiInitialSyncApply_noAbort(OperationContext* txn,
     return Status::OK();
 }
 
+ReplPrefetcher::ReplPrefetcher(std::size_t numThreads, PrefetchOpFn prefetchOp)
+    : _prefetchOp(std::move(prefetchOp)), _pool(numThreads, "repl prefetch worker ") {
+    invariant(numThreads > 0);
+}
+
+ReplPrefetcher::~ReplPrefetcher() {
+    join();
+}
+
+std::unique_ptr<ReplPrefetcher> ReplPrefetcher::make() {
+    StorageEngine* storageEngine = getGlobalServiceContext()->getGlobalStorageEngine();
+    if (replPrefetchThreadCount <= 0 || !storageEngine || !storageEngine->supportsPrefetch()) {
+        return nullptr;
+    }
+    return stdx::make_unique<ReplPrefetcher>(replPrefetchThreadCount);
+}
+
+bool ReplPrefetcher::prefetchAhead(const std::vector<OplogEntry>& ops) {
+    if (_tasksInFlight.load() != 0) {
+        prefetchBatchesSkipped.increment();
+        return false;
+    }
+
+    auto raw = std::make_shared<std::vector<BSONObj>>();
+    for (auto&& op : ops) {
+        if (op.opType == "u" || op.opType == "d") {
+            raw->push_back(op.raw);
+        }
+    }
+    if (raw->empty()) {
+        return true;
+    }
+
+    prefetchBatches.increment();
+    const std::size_t numTasks = std::min(_pool.getNumThreads(), raw->size());
+    _tasksInFlight.store(numTasks);
+    for (std::size_t i = 0; i < numTasks; ++i) {
+        _pool.schedule([this, raw, i, numTasks] {
+            _prefetchOps(*raw, i, numTasks);
+            _tasksInFlight.subtractAndFetch(1);
+        });
+    }
+    return true;
+}
+
+void ReplPrefetcher::join() {
+    _pool.join();
+}
+
+void ReplPrefetcher::_prefetchOps(const std::vector<BSONObj>& ops,
+                                  std::size_t first,
+                                  std::size_t stride) {
+    initializePrefetchThread();
+
+    const ServiceContext::UniqueOperationContext txnPtr = cc().makeOperationContext();
+    OperationContext& txn = *txnPtr;
+
+    // Like the writer threads, read while the previous batch is being applied.
+    txn.lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+
+    for (std::size_t i = first; i < ops.size(); i += stride) {
+        const char* ns = ops[i].getStringField("ns");
+        try {
+            AutoGetDb autoDb(&txn, nsToDatabaseSubstring(ns), MODE_IS);
+            Database* db = autoDb.getDb();
+            if (!db) {
+                continue;
+            }
+
+            switch (_prefetchOp(&txn, db, ops[i])) {
+                case ReplPrefetchResult::kFound:
+                    prefetchFound.increment();
+                    break;
+                case ReplPrefetchResult::kNotFound:
+                    prefetchNotFound.increment();
+                    break;
+                case ReplPrefetchResult::kNotPrefetched:
+                    break;
+            }
+        } catch (const DBException& e) {
+            LOG(2) << "ignoring exception in ReplPrefetcher: " << redact(e);
+        }
+    }
+}
+
+void appendReplPrefetchStats(BSONObjBuilder* builder) {
+    builder->append("batches", static_cast<long long>(prefetchBatches.get()));
+    builder->append("batchesSkipped", static_cast<long long>(prefetchBatchesSkipped.get()));
+    builder->append("found", static_cast<long long>(prefetchFound.get()));
+    builder->append("notFound", static_cast<long long>(prefetchNotFound.get()));
+}
+
 StatusWith<OpTime> multiApply(OperationContext* txn,
                               OldThreadPool* workerPool,
                               MultiApplier::Operations ops,
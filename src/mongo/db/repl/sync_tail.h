@@ -33,13 +33,16 @@
 
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/db/prefetch.h"
 #include "mongo/db/repl/multiapplier.h"
 #include "mongo/db/repl/oplog_entry.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/concurrency/old_thread_pool.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class Database;
 class OperationContext;
 
@@ -243,6 +246,62 @@ private:
     std::unique_ptr<OldThreadPool> _writerPool;
 };
 
+/**
+ * Warms the storage engine's cache for the updates and deletes of the next batch on a pool of
+ * threads, so that their index and record lookups overlap with the application of the batch
+ * before it. If the previous batch is still being prefetched, the next one is skipped rather than
+ * letting the prefetcher fall further behind the applier.
+ */
+class ReplPrefetcher {
+    MONGO_DISALLOW_COPYING(ReplPrefetcher);
+
+public:
+    /**
+     * Type of function that warms the cache for a single op from the oplog.
+     * 'db' is the database the op targets.
+     */
+    using PrefetchOpFn =
+        stdx::function<ReplPrefetchResult(OperationContext* txn, Database* db, const BSONObj& op)>;
+
+    ReplPrefetcher(std::size_t numThreads,
+                   PrefetchOpFn prefetchOp = prefetchRecordsForReplicatedOp);
+    ~ReplPrefetcher();
+
+    /**
+     * Returns a prefetcher with replPrefetchThreadCount threads, or nullptr if that is 0 or the
+     * storage engine does not support prefetch.
+     */
+    static std::unique_ptr<ReplPrefetcher> make();
+
+    /**
+     * Schedules the prefetch of the updates and deletes in 'ops' and returns without waiting for
+     * it. Returns false if 'ops' was skipped because the previous batch is still being prefetched.
+     */
+    bool prefetchAhead(const std::vector<OplogEntry>& ops);
+
+    /**
+     * Waits until all scheduled prefetches have finished.
+     */
+    void join();
+
+private:
+    // Prefetches every 'stride'th op of 'ops', starting at 'first'. Runs on the pool threads.
+    void _prefetchOps(const std::vector<BSONObj>& ops, std::size_t first, std::size_t stride);
+
+    const PrefetchOpFn _prefetchOp;
+
+    // Number of _pool tasks still working on the last scheduled batch.
+    AtomicWord<std::size_t> _tasksInFlight{0};
+
+    OldThreadPool _pool;  // Must be last so the tasks never outlive the members above.
+};
+
+/**
+ * Appends the counters of the ReplPrefetcher: the number of batches prefetched and skipped, and
+ * how many of the prefetched updates and deletes found their document. Used by serverStatus.
+ */
+void appendReplPrefetchStats(BSONObjBuilder* builder);
+
 /**
  * Applies the operations described in the oplog entries contained in "ops" using the
  * "applyOperation" function.
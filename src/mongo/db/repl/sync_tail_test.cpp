@@ -56,6 +56,7 @@
 #include "mongo/db/repl/sync_tail.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
@@ -251,6 +252,21 @@ OplogEntry makeUpdateDocumentOplogEntry(OpTime opTime,
     return OplogEntry(bob.obj());
 }
 
+/**
+ * Creates a delete oplog entry with given optime and namespace.
+ */
+OplogEntry makeDeleteDocumentOplogEntry(OpTime opTime,
+                                        const NamespaceString& nss,
+                                        const BSONObj& documentToDelete) {
+    BSONObjBuilder bob;
+    bob.appendElements(opTime.toBSON());
+    bob.append("h", 1LL);
+    bob.append("op", "d");
+    bob.append("ns", nss.ns());
+    bob.append("o", documentToDelete);
+    return OplogEntry(bob.obj());
+}
+
 /**
  * Creates an index creation entry with given optime and namespace.
  */
@@ -519,6 +535,113 @@ TEST_F(SyncTailTest, MultiApplyReturnsBadValueOnNullApplyOperation) {
     ASSERT_STRING_CONTAINS(status.reason(), "invalid apply operation function");
 }
 
+/**
+ * Returns the counters reported by appendReplPrefetchStats().
+ */
+BSONObj getReplPrefetchStats() {
+    BSONObjBuilder bob;
+    appendReplPrefetchStats(&bob);
+    return bob.obj();
+}
+
+TEST_F(SyncTailTest, ReplPrefetcherPrefetchesEachUpdateAndDeleteOnce) {
+    NamespaceString nss("test.t");
+    createCollection(_opCtx.get(), nss, CollectionOptions());
+
+    const int numDocs = 100;
+    std::vector<OplogEntry> ops;
+    for (int i = 0; i < numDocs; ++i) {
+        OpTime opTime(Timestamp(Seconds(1), i), 1LL);
+        ops.push_back(makeInsertDocumentOplogEntry(opTime, nss, BSON("_id" << i)));
+        if (i % 2) {
+            ops.push_back(makeDeleteDocumentOplogEntry(opTime, nss, BSON("_id" << i)));
+        } else {
+            ops.push_back(makeUpdateDocumentOplogEntry(
+                opTime, nss, BSON("_id" << i), BSON("$set" << BSON("a" << i))));
+        }
+    }
+    // There is no database to prefetch from, so this is never handed to the prefetch function.
+    ops.push_back(makeUpdateDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL},
+                                               NamespaceString("nodb.t"),
+                                               BSON("_id" << 0),
+                                               BSON("$set" << BSON("a" << 0))));
+
+    // Ids below numDocs / 2 are reported as found.
+    stdx::mutex mutex;
+    std::vector<int> prefetched(numDocs, 0);
+    std::vector<std::string> badOps;
+    auto prefetchOp = [&](OperationContext* txn, Database* db, const BSONObj& op) {
+        const char* opField = *op.getStringField("op") == 'u' ? "o2" : "o";
+        const int id = op.getObjectField(opField)["_id"].numberInt();
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        if (!txn || !db || db->name() != nss.db() || id < 0 || id >= numDocs) {
+            badOps.push_back(op.toString());
+            return ReplPrefetchResult::kNotPrefetched;
+        }
+        ++prefetched[id];
+        return id < numDocs / 2 ? ReplPrefetchResult::kFound : ReplPrefetchResult::kNotFound;
+    };
+
+    const BSONObj before = getReplPrefetchStats();
+    {
+        ReplPrefetcher prefetcher(4, prefetchOp);
+        ASSERT_TRUE(prefetcher.prefetchAhead(ops));
+        prefetcher.join();
+    }
+    const BSONObj after = getReplPrefetchStats();
+
+    ASSERT_EQUALS(0U, badOps.size());
+    for (int i = 0; i < numDocs; ++i) {
+        ASSERT_EQUALS(1, prefetched[i]) << "_id: " << i;
+    }
+    ASSERT_EQUALS(1, after["batches"].numberLong() - before["batches"].numberLong());
+    ASSERT_EQUALS(0, after["batchesSkipped"].numberLong() - before["batchesSkipped"].numberLong());
+    ASSERT_EQUALS(numDocs / 2, after["found"].numberLong() - before["found"].numberLong());
+    ASSERT_EQUALS(numDocs / 2, after["notFound"].numberLong() - before["notFound"].numberLong());
+}
+
+TEST_F(SyncTailTest, ReplPrefetcherSkipsBatchWhilePreviousBatchIsPrefetched) {
+    NamespaceString nss("test.t");
+    createCollection(_opCtx.get(), nss, CollectionOptions());
+    auto op = makeDeleteDocumentOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 0));
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    bool released = false;
+    int numPrefetched = 0;
+    auto prefetchOp = [&](OperationContext*, Database*, const BSONObj&) {
+        stdx::unique_lock<stdx::mutex> lock(mutex);
+        cv.wait(lock, [&] { return released; });
+        ++numPrefetched;
+        return ReplPrefetchResult::kFound;
+    };
+
+    const BSONObj before = getReplPrefetchStats();
+    ReplPrefetcher prefetcher(2, prefetchOp);
+
+    // Batches without updates or deletes are never scheduled.
+    ASSERT_TRUE(prefetcher.prefetchAhead({makeInsertDocumentOplogEntry(
+        {Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 0))}));
+
+    ASSERT_TRUE(prefetcher.prefetchAhead({op}));
+    ASSERT_FALSE(prefetcher.prefetchAhead({op}));
+    {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        released = true;
+    }
+    cv.notify_all();
+    prefetcher.join();
+
+    ASSERT_TRUE(prefetcher.prefetchAhead({op}));
+    prefetcher.join();
+
+    const BSONObj after = getReplPrefetchStats();
+    ASSERT_EQUALS(2, numPrefetched);
+    ASSERT_EQUALS(2, after["batches"].numberLong() - before["batches"].numberLong());
+    ASSERT_EQUALS(1, after["batchesSkipped"].numberLong() - before["batchesSkipped"].numberLong());
+    ASSERT_EQUALS(2, after["found"].numberLong() - before["found"].numberLong());
+}
+
 bool _testOplogEntryIsForCappedCollection(OperationContext* txn,
                                           const NamespaceString& nss,
                                           const CollectionOptions& options) {
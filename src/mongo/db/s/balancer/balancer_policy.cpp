@@ -52,6 +52,45 @@ namespace {
 const size_t kDefaultImbalanceThreshold = 2;
 const size_t kAggressiveImbalanceThreshold = 1;
 
+// How far above the average load across all shards a shard's load for a collection needs to be
+// for a load balancing migration to be initiated.
+const double kLoadImbalanceThreshold = 0.25;
+
+// Collections, which keep the cluster busy for less than this many microseconds per second, are
+// balanced by chunk counts.
+const double kMinCollectionLoadToBalance = 10000;
+
+double getCollectionLoad(const ClusterStatistics::ShardStatistics& stat,
+                         const NamespaceString& nss) {
+    const auto it = stat.collectionLoad.find(nss.ns());
+    return (it == stat.collectionLoad.end()) ? 0 : it->second.busyMicrosPerSec;
+}
+
+/**
+ * Returns the ceiling of the optimal number of chunks per shard for the specified zone, or zero if
+ * the zone has no shards assigned to it.
+ */
+size_t idealNumberOfChunksPerShardForTag(const ShardStatisticsVector& shardStats,
+                                         const DistributionStatus& distribution,
+                                         const string& tag) {
+    size_t totalNumberOfShardsWithTag = 0;
+
+    for (const auto& stat : shardStats) {
+        if (tag.empty() || stat.shardTags.count(tag)) {
+            totalNumberOfShardsWithTag++;
+        }
+    }
+
+    if (totalNumberOfShardsWithTag == 0)
+        return 0;
+
+    const size_t totalNumberOfChunksWithTag =
+        (tag.empty() ? distribution.totalChunks() : distribution.totalChunksWithTag(tag));
+
+    return (totalNumberOfChunksWithTag / totalNumberOfShardsWithTag) +
+        (totalNumberOfChunksWithTag % totalNumberOfShardsWithTag ? 1 : 0);
+}
+
 }  // namespace
 
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
@@ -387,13 +426,25 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
         }
     }
 
-    // 3) for each tag balance
     const size_t imbalanceThreshold = (shouldAggressivelyBalance || distribution.totalChunks() < 20)
         ? kAggressiveImbalanceThreshold
         : kDefaultImbalanceThreshold;
 
+    // 3) If the shards report enough load for the collection, balance the load of the chunks
+    // outside of any zone instead of their counts. Zoned chunks only move between the shards of
+    // their zone and never far enough to trigger a chunk count migration back in step 4.
+    const bool balanceByLoad = _hasLoadStatistics(shardStats, distribution);
+    if (balanceByLoad) {
+        while (_singleLoadBalance(
+            shardStats, distribution, imbalanceThreshold, &migrations, usedShards))
+            ;
+    }
+
+    // 4) for each tag balance
     vector<string> tagsPlusEmpty(distribution.tags().begin(), distribution.tags().end());
-    tagsPlusEmpty.push_back("");
+    if (!balanceByLoad) {
+        tagsPlusEmpty.push_back("");
+    }
 
     for (const auto& tag : tagsPlusEmpty) {
         const size_t totalNumberOfChunksWithTag =
@@ -452,6 +503,123 @@ boost::optional<MigrateInfo> BalancerPolicy::balanceSingleChunk(
     return MigrateInfo(newShardId, chunk);
 }
 
+bool BalancerPolicy::_hasLoadStatistics(const ShardStatisticsVector& shardStats,
+                                        const DistributionStatus& distribution) {
+    double totalLoad = 0;
+
+    for (const auto& stat : shardStats) {
+        totalLoad += getCollectionLoad(stat, distribution.nss());
+    }
+
+    return totalLoad >= kMinCollectionLoadToBalance;
+}
+
+bool BalancerPolicy::_singleLoadBalance(const ShardStatisticsVector& shardStats,
+                                        const DistributionStatus& distribution,
+                                        size_t imbalanceThreshold,
+                                        vector<MigrateInfo>* migrations,
+                                        set<ShardId>* usedShards) {
+    double totalLoad = 0;
+
+    for (const auto& stat : shardStats) {
+        totalLoad += getCollectionLoad(stat, distribution.nss());
+    }
+
+    const double averageLoad = totalLoad / shardStats.size();
+
+    // A shard with a single chunk cannot shed part of its load by moving it
+    ShardId from;
+    double maxLoad = 0;
+
+    for (const auto& stat : shardStats) {
+        if (usedShards->count(stat.shardId))
+            continue;
+
+        if (distribution.numberOfChunksInShard(stat.shardId) < 2)
+            continue;
+
+        const double load = getCollectionLoad(stat, distribution.nss());
+        if (load <= maxLoad)
+            continue;
+
+        from = stat.shardId;
+        maxLoad = load;
+    }
+
+    if (!from.isValid() || maxLoad <= averageLoad * (1 + kLoadImbalanceThreshold))
+        return false;
+
+    // The load of the individual chunks is not known, so assume the donor's load is spread
+    // evenly over its chunks
+    const double chunkLoad = maxLoad / distribution.numberOfChunksInShard(from);
+
+    bool foundReceiver = false;
+
+    for (const auto& chunk : distribution.getChunks(from)) {
+        if (chunk.getJumbo())
+            continue;
+
+        const string tag = distribution.getTagForChunk(chunk);
+
+        // A zoned chunk must stay within its zone and must not push the receiver's chunk count for
+        // the zone to the point where the per-zone balancing would move it back
+        const size_t maxNumberOfChunksForTag = tag.empty()
+            ? numeric_limits<size_t>::max()
+            : idealNumberOfChunksPerShardForTag(shardStats, distribution, tag) + imbalanceThreshold;
+
+        const ClusterStatistics::ShardStatistics* to = nullptr;
+        double minLoad = numeric_limits<double>::max();
+
+        for (const auto& stat : shardStats) {
+            if (usedShards->count(stat.shardId) || stat.shardId == from)
+                continue;
+
+            if (!isShardSuitableReceiver(stat, tag).isOK())
+                continue;
+
+            if (!tag.empty() &&
+                distribution.numberOfChunksInShardWithTag(stat.shardId, tag) + 1 >=
+                    maxNumberOfChunksForTag)
+                continue;
+
+            const double load = getCollectionLoad(stat, distribution.nss());
+            if (load >= minLoad)
+                continue;
+
+            to = &stat;
+            minLoad = load;
+        }
+
+        if (!to)
+            continue;
+
+        foundReceiver = true;
+
+        // Moving the chunk must not make the receiver busier than the donor, otherwise the next
+        // round would move the load right back
+        if (minLoad + chunkLoad >= maxLoad - chunkLoad)
+            continue;
+
+        LOG(1) << "collection : " << distribution.nss().ns();
+        LOG(1) << "zone       : " << tag;
+        LOG(1) << "donor      : " << from << " load " << maxLoad;
+        LOG(1) << "receiver   : " << to->shardId << " load " << minLoad;
+        LOG(1) << "average    : " << averageLoad;
+        LOG(1) << "chunk load : " << chunkLoad;
+
+        migrations->emplace_back(to->shardId, chunk);
+        invariant(usedShards->insert(chunk.getShard()).second);
+        invariant(usedShards->insert(to->shardId).second);
+        return true;
+    }
+
+    if (!foundReceiver && migrations->empty()) {
+        log() << "No available shards to take load of collection " << distribution.nss().ns();
+    }
+
+    return false;
+}
+
 bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
                                         const DistributionStatus& distribution,
                                         const string& tag,
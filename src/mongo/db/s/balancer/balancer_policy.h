@@ -180,6 +180,13 @@ public:
      * any of the shards have chunks, which are sufficiently higher than this number, suggests
      * moving chunks to shards, which are under this number.
      *
+     * If the shards report enough load for the collection (see ClusterStatisticsImpl), the
+     * policy evens out that load instead of the counts of the chunks outside of any zone. A chunk
+     * is only moved off a shard, which is loaded sufficiently above the average, and only if the
+     * receiver is expected to remain less loaded than the donor, so that load does not bounce
+     * between shards. Zoned chunks are only moved to shards in their zone and the chunk counts of
+     * the zones are still balanced.
+     *
      * The shouldAggressivelyBalance parameter causes the threshold for chunk could disparity
      * between shards to be lowered.
      *
@@ -219,6 +226,28 @@ private:
                                            const std::string& chunkTag,
                                            const std::set<ShardId>& excludedShards);
 
+    /**
+     * Returns true if the shards report enough load for the collection to balance it by load
+     * rather than by chunk counts.
+     */
+    static bool _hasLoadStatistics(const ShardStatisticsVector& shardStats,
+                                   const DistributionStatus& distribution);
+
+    /**
+     * Selects one chunk to be moved from the most loaded shard of the collection to the least
+     * loaded shard in the chunk's zone, if the imbalance warrants it. A zoned chunk is not moved to
+     * a shard, which would then exceed the ideal chunk count for the zone by 'imbalanceThreshold'.
+     * Takes into account and updates the shards, which have already been used for migrations.
+     *
+     * Returns true if a migration was suggested, false otherwise. This method is intented to be
+     * called multiple times until all posible migrations have been selected.
+     */
+    static bool _singleLoadBalance(const ShardStatisticsVector& shardStats,
+                                   const DistributionStatus& distribution,
+                                   size_t imbalanceThreshold,
+                                   std::vector<MigrateInfo>* migrations,
+                                   std::set<ShardId>* usedShards);
+
     /**
      * Selects one chunk for the specified zone (if appropriate) to be moved in order to bring the
      * deviation of the shards chunk contents closer to even across all shards in the specified
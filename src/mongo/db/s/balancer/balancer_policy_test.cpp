@@ -30,6 +30,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/s/balancer/balancer_policy.h"
 #include "mongo/platform/random.h"
@@ -609,6 +612,193 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(balanceChunks(cluster.first, distribution, false).empty());
 }
 
+/**
+ * A recorded distribution of load over the chunks of a collection. Contains the load of every
+ * chunk in microseconds per second, grouped by the shard which owns it.
+ */
+struct RecordedLoadDistribution {
+    std::string name;
+    vector<vector<double>> chunkLoadsPerShard;
+};
+
+struct LoadSimulationResult {
+    vector<double> shardLoads;
+    double maxChunkLoad{0};
+    size_t numMigrations{0};
+    size_t numRounds{0};
+};
+
+/**
+ * Replays a recorded load distribution through the balancer policy, one balancing round at a
+ * time. The migrations suggested in each round are applied to the simulated cluster and the
+ * shard loads recomputed from the loads of the chunks they own, until the policy stops
+ * suggesting migrations.
+ */
+LoadSimulationResult simulateLoadBalancing(const RecordedLoadDistribution& recorded) {
+    const ShardId shardIds[] = {kShardId0, kShardId1, kShardId2, kShardId3, kShardId4, kShardId5};
+    const size_t kMaxRounds = 100;
+
+    vector<std::pair<ShardStatistics, size_t>> shardsAndNumChunks;
+    for (size_t i = 0; i < recorded.chunkLoadsPerShard.size(); i++) {
+        shardsAndNumChunks.emplace_back(
+            ShardStatistics(shardIds[i], kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+            recorded.chunkLoadsPerShard[i].size());
+    }
+
+    auto cluster = generateCluster(shardsAndNumChunks);
+    ShardToChunksMap& chunkMap = cluster.second;
+
+    LoadSimulationResult result;
+
+    auto chunkLoads = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<double>();
+    for (size_t i = 0; i < recorded.chunkLoadsPerShard.size(); i++) {
+        for (size_t j = 0; j < recorded.chunkLoadsPerShard[i].size(); j++) {
+            const double load = recorded.chunkLoadsPerShard[i][j];
+            chunkLoads[chunkMap[shardIds[i]][j].getMin()] = load;
+            result.maxChunkLoad = std::max(result.maxChunkLoad, load);
+        }
+    }
+
+    for (; result.numRounds < kMaxRounds; result.numRounds++) {
+        ShardStatisticsVector shardStats = cluster.first;
+        result.shardLoads.clear();
+
+        for (auto& stat : shardStats) {
+            double load = 0;
+            for (const auto& chunk : chunkMap[stat.shardId]) {
+                load += chunkLoads[chunk.getMin()];
+            }
+
+            stat.collectionLoad[kNamespace.ns()].busyMicrosPerSec = load;
+            result.shardLoads.push_back(load);
+        }
+
+        const auto migrations =
+            balanceChunks(shardStats, DistributionStatus(kNamespace, chunkMap), false);
+        if (migrations.empty()) {
+            break;
+        }
+
+        for (const auto& migration : migrations) {
+            auto& fromChunks = chunkMap[migration.from];
+            auto it = std::find_if(fromChunks.begin(), fromChunks.end(), [&](const ChunkType& c) {
+                return SimpleBSONObjComparator::kInstance.evaluate(c.getMin() == migration.minKey);
+            });
+            ASSERT(it != fromChunks.end());
+
+            ChunkType chunk = *it;
+            fromChunks.erase(it);
+            chunk.setShard(migration.to);
+            chunkMap[migration.to].push_back(std::move(chunk));
+
+            result.numMigrations++;
+        }
+    }
+
+    return result;
+}
+
+TEST(BalancerPolicy, LoadAwareBalancingSimulation) {
+    const vector<RecordedLoadDistribution> recordings = {
+        // A hot key range, which lives on a single shard
+        {"hotRange",
+         {vector<double>(8, 9000),
+          vector<double>(8, 500),
+          vector<double>(8, 500),
+          vector<double>(8, 500)}},
+        // Two busy shards and a newly added empty one
+        {"newShard",
+         {vector<double>(6, 4000), vector<double>(6, 4000), vector<double>(6, 200), {}}},
+        // A single very hot chunk, which cannot be split across shards
+        {"hotChunk",
+         {{50000, 1000, 1000, 1000, 1000, 1000, 1000, 1000}, vector<double>(8, 1000)}},
+    };
+
+    for (const auto& recorded : recordings) {
+        const auto result = simulateLoadBalancing(recorded);
+
+        log() << "load simulation " << recorded.name << ": " << result.numMigrations
+              << " migrations in " << result.numRounds << " rounds";
+
+        // The policy settles without moving chunks back and forth
+        ASSERT_LT(result.numRounds, 100U);
+
+        size_t numChunks = 0;
+        for (const auto& shardChunkLoads : recorded.chunkLoadsPerShard) {
+            numChunks += shardChunkLoads.size();
+        }
+        ASSERT_LTE(result.numMigrations, numChunks);
+
+        // No shard is left busier than the threshold above the average, short of one chunk
+        double totalLoad = 0;
+        for (double load : result.shardLoads) {
+            totalLoad += load;
+        }
+        const double averageLoad = totalLoad / result.shardLoads.size();
+        for (double load : result.shardLoads) {
+            ASSERT_LTE(load, averageLoad * 1.25 + result.maxChunkLoad);
+        }
+    }
+}
+
+TEST(BalancerPolicy, LoadAwareBalancingIgnoresChunkCountsWhenLoadIsEven) {
+    const auto result = simulateLoadBalancing(
+        {"evenLoad", {vector<double>(10, 1000), vector<double>(2, 5000), vector<double>(5, 2000)}});
+
+    ASSERT_EQ(0U, result.numMigrations);
+}
+
+TEST(BalancerPolicy, LoadAwareBalancingFallsBackToChunkCountsWhenIdle) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 4, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0}});
+    cluster.first[0].collectionLoad[kNamespace.ns()].busyMicrosPerSec = 10;
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+}
+
+TEST(BalancerPolicy, LoadAwareBalancingKeepsChunksInTheirZone) {
+    // shard2 is the least loaded shard, but it is not in the zone of the donor's chunks
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 4, false, {"a"}, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 3, false, {"a"}, emptyShardVersion), 3},
+         {ShardStatistics(kShardId2, kNoMaxSize, 4, false, emptyTagSet, emptyShardVersion), 4}});
+    cluster.first[0].collectionLoad[kNamespace.ns()].busyMicrosPerSec = 40000;
+    cluster.first[1].collectionLoad[kNamespace.ns()].busyMicrosPerSec = 10000;
+    cluster.first[2].collectionLoad[kNamespace.ns()].busyMicrosPerSec = 0;
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    ASSERT_OK(distribution.addRangeToZone(ZoneRange(kMinBSONKey, BSON("x" << 7), "a")));
+
+    const auto migrations(balanceChunks(cluster.first, distribution, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+}
+
+TEST(BalancerPolicy, LoadAwareBalancingStillBalancesZones) {
+    // The load is even, but all of zone a's chunks are on shard0
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 6, false, {"a"}, emptyShardVersion), 6},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, {"a"}, emptyShardVersion), 0},
+         {ShardStatistics(kShardId2, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2}});
+    for (auto& stat : cluster.first) {
+        stat.collectionLoad[kNamespace.ns()].busyMicrosPerSec = 10000;
+    }
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    ASSERT_OK(distribution.addRangeToZone(ZoneRange(kMinBSONKey, BSON("x" << 6), "a")));
+
+    const auto migrations(balanceChunks(cluster.first, distribution, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
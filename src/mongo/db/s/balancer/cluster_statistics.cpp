@@ -72,6 +72,18 @@ BSONObj ClusterStatistics::ShardStatistics::toBSON() const {
     }
 
     builder.append("version", mongoVersion);
+
+    if (!collectionLoad.empty()) {
+        BSONObjBuilder loadBuilder(builder.subobjStart("load"));
+        for (const auto& entry : collectionLoad) {
+            BSONObjBuilder collBuilder(loadBuilder.subobjStart(entry.first));
+            collBuilder.append("opsPerSec", entry.second.opsPerSec);
+            collBuilder.append("busyMicrosPerSec", entry.second.busyMicrosPerSec);
+            collBuilder.doneFast();
+        }
+        loadBuilder.doneFast();
+    }
+
     return builder.obj();
 }
 
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -57,6 +58,17 @@ public:
      */
     struct ShardStatistics {
     public:
+        /**
+         * Load a collection put on the shard over the last statistics interval.
+         */
+        struct CollectionLoad {
+            // Operations per second
+            double opsPerSec{0};
+
+            // Microseconds spent executing operations per second of wall clock time
+            double busyMicrosPerSec{0};
+        };
+
         ShardStatistics(ShardId shardId,
                         uint64_t maxSizeMB,
                         uint64_t currSizeMB,
@@ -92,6 +104,10 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // Load of each collection on the shard, keyed by namespace. Only filled in when
+        // load-aware balancing is enabled and an earlier sample of the shard's usage exists.
+        std::map<std::string, CollectionLoad> collectionLoad;
     };
 
     virtual ~ClusterStatistics();
@@ -37,6 +37,7 @@
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/read_preference.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
@@ -54,6 +55,10 @@ namespace {
 
 const char kVersionField[] = "version";
 
+// Whether to sample the per-collection load of the shards, so the balancer can even out load
+// instead of chunk counts. See BalancerPolicy::balance().
+MONGO_EXPORT_SERVER_PARAMETER(balancerLoadAware, bool, false);
+
 /**
  * Executes the serverStatus command against the specified shard and obtains the version of the
  * running MongoD service.
@@ -94,6 +99,55 @@ StatusWith<string> retrieveShardMongoDVersion(OperationContext* txn, ShardId sha
     return version;
 }
 
+/**
+ * Executes the top command against the specified shard and obtains the cumulative operation
+ * count and time of each collection.
+ */
+StatusWith<ClusterStatisticsImpl::UsageSample> retrieveShardUsage(OperationContext* txn,
+                                                                  ShardId shardId) {
+    auto shardRegistry = Grid::get(txn)->shardRegistry();
+    auto shardStatus = shardRegistry->getShard(txn, shardId);
+    if (!shardStatus.isOK()) {
+        return shardStatus.getStatus();
+    }
+    auto shard = shardStatus.getValue();
+
+    auto commandResponse =
+        shard->runCommandWithFixedRetryAttempts(txn,
+                                                ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+                                                "admin",
+                                                BSON("top" << 1),
+                                                Shard::RetryPolicy::kIdempotent);
+    if (!commandResponse.isOK()) {
+        return commandResponse.getStatus();
+    }
+    if (!commandResponse.getValue().commandStatus.isOK()) {
+        return commandResponse.getValue().commandStatus;
+    }
+
+    ClusterStatisticsImpl::UsageSample sample;
+    sample.takenAt = Date_t::now();
+
+    BSONElement totals;
+    Status status =
+        bsonExtractTypedField(commandResponse.getValue().response, "totals", Object, &totals);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    for (const auto& elem : totals.Obj()) {
+        if (elem.type() != Object) {
+            continue;
+        }
+
+        const BSONObj total = elem.Obj().getObjectField("total");
+        sample.usage[elem.fieldName()] =
+            std::make_pair(total["count"].safeNumberLong(), total["time"].safeNumberLong());
+    }
+
+    return sample;
+}
+
 }  // namespace
 
 using ShardStatistics = ClusterStatistics::ShardStatistics;
@@ -163,9 +217,57 @@ StatusWith<vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationCon
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+
+        if (balancerLoadAware.load()) {
+            auto usageStatus = retrieveShardUsage(txn, shard.getName());
+            if (usageStatus.isOK()) {
+                stats.back().collectionLoad =
+                    _updateUsage(shard.getName(), std::move(usageStatus.getValue()));
+            } else {
+                // Without load information the collection is balanced by chunk counts, so there
+                // is no need to fail the entire round
+                log() << "Unable to obtain collection usage for " << shard.getName()
+                      << causedBy(usageStatus.getStatus());
+            }
+        }
     }
 
     return stats;
 }
 
+std::map<string, ShardStatistics::CollectionLoad> ClusterStatisticsImpl::_updateUsage(
+    const ShardId& shardId, UsageSample sample) {
+    std::map<string, ShardStatistics::CollectionLoad> load;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _lastUsage.find(shardId);
+    if (it != _lastUsage.end()) {
+        const UsageSample& last = it->second;
+        const double secs =
+            durationCount<Milliseconds>(sample.takenAt - last.takenAt) / 1000.0;
+
+        for (const auto& entry : sample.usage) {
+            auto lastEntry = last.usage.find(entry.first);
+            if (secs <= 0 || lastEntry == last.usage.end()) {
+                continue;
+            }
+
+            // The counters start over when the shard restarts or the collection is dropped
+            const long long ops = entry.second.first - lastEntry->second.first;
+            const long long micros = entry.second.second - lastEntry->second.second;
+            if (ops < 0 || micros < 0) {
+                continue;
+            }
+
+            load[entry.first].opsPerSec = ops / secs;
+            load[entry.first].busyMicrosPerSec = micros / secs;
+        }
+    }
+
+    _lastUsage[shardId] = std::move(sample);
+
+    return load;
+}
+
 }  // namespace mongo
@@ -28,8 +28,14 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+#include <utility>
+
 #include "mongo/db/s/balancer/balancer_random.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -37,6 +43,9 @@ namespace mongo {
  * Default implementation for the cluster statistics gathering utility. Uses a blocking method to
  * fetch the statistics and does not perform any caching. If any of the shards fails to report
  * statistics fails the entire refresh.
+ *
+ * With load-aware balancing enabled, the per-collection usage counters of every shard are
+ * sampled as well and the load is computed from the difference to the previous sample.
  */
 class ClusterStatisticsImpl final : public ClusterStatistics {
 public:
@@ -45,9 +54,32 @@ public:
 
     StatusWith<std::vector<ShardStatistics>> getStats(OperationContext* txn) override;
 
+    /**
+     * Cumulative usage counters of one shard, as reported by the top command.
+     */
+    struct UsageSample {
+        Date_t takenAt;
+
+        // Operation count and time in microseconds, keyed by namespace
+        std::map<std::string, std::pair<long long, long long>> usage;
+    };
+
 private:
+    /**
+     * Stores 'sample' as the latest usage sample of 'shardId' and returns the load of each
+     * collection since the previous sample. Returns an empty map for the first sample.
+     */
+    std::map<std::string, ShardStatistics::CollectionLoad> _updateUsage(const ShardId& shardId,
+                                                                        UsageSample sample);
+
     // Source of randomness when metadata needs to be randomized.
     BalancerRandomSource& _random;
+
+    // Protects _lastUsage
+    stdx::mutex _mutex;
+
+    // The previous usage sample of each shard
+    std::map<ShardId, UsageSample> _lastUsage;
 };
 
 }  // namespace mongo
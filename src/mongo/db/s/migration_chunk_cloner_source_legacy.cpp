@@ -32,6 +32,8 @@
 
 #include "mongo/db/s/migration_chunk_cloner_source_legacy.h"
 
+#include <algorithm>
+
 #include "mongo/base/status.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/db/concurrency/locker.h"
@@ -97,7 +99,7 @@ public:
     void doInvalidate(OperationContext* txn, const RecordId& dl, InvalidationType type) override {
         if (type == INVALIDATION_DELETION) {
             stdx::lock_guard<stdx::mutex> sl(_cloner->_mutex);
-            _cloner->_cloneLocs.erase(dl);
+            _cloner->_invalidateCloneLoc_inlock(dl);
         }
     }
 
@@ -143,14 +145,14 @@ public:
         switch (_op) {
             case 'd': {
                 stdx::lock_guard<stdx::mutex> sl(_cloner->_mutex);
-                _cloner->_deleted.push_back(_idObj);
+                _cloner->_deleted.push(_idObj);
                 _cloner->_memoryUsed += _idObj.firstElement().size() + 5;
             } break;
 
             case 'i':
             case 'u': {
                 stdx::lock_guard<stdx::mutex> sl(_cloner->_mutex);
-                _cloner->_reload.push_back(_idObj);
+                _cloner->_reload.push(_idObj);
                 _cloner->_memoryUsed += _idObj.firstElement().size() + 5;
             } break;
 
@@ -251,7 +253,7 @@ Status MigrationChunkClonerSourceLegacy::awaitUntilCriticalSectionIsAppropriate(
 
         stdx::lock_guard<stdx::mutex> sl(_mutex);
 
-        const std::size_t cloneLocsRemaining = _cloneLocs.size();
+        const std::size_t cloneLocsRemaining = _cloneLocsRemaining;
 
         log() << "moveChunk data transfer progress: " << redact(res) << " mem used: " << _memoryUsed
               << " documents remaining to clone: " << cloneLocsRemaining;
@@ -399,7 +401,7 @@ uint64_t MigrationChunkClonerSourceLegacy::getCloneBatchBufferAllocationSize() {
     stdx::lock_guard<stdx::mutex> sl(_mutex);
 
     return std::min(static_cast<uint64_t>(BSONObjMaxUserSize),
-                    _averageObjectSizeForCloneLocs * _cloneLocs.size());
+                    _averageObjectSizeForCloneLocs * _cloneLocsRemaining);
 }
 
 Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* txn,
@@ -413,33 +415,65 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* txn,
 
     stdx::lock_guard<stdx::mutex> sl(_mutex);
 
-    std::set<RecordId>::iterator it;
+    // The record ids are sorted, so rather than doing a point lookup for each of them, walk a
+    // single forward cursor over the collection and only seek when the next record on the cursor
+    // is not the one we need (i.e., the chunk's records are not adjacent in the record store).
+    auto cursor = collection->getCursor(txn);
+    bool cursorPositioned = false;
+    bool lastNextMatched = false;
+    RecordId lastLoc;
 
-    for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
+    for (; _cloneLocsPos < _cloneLocs.size(); ++_cloneLocsPos) {
         // We must always make progress in this method by at least one document because empty return
         // indicates there is no more initial clone data.
         if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
             break;
         }
 
-        Snapshotted<BSONObj> doc;
-        if (collection->findDoc(txn, *it, &doc)) {
+        // Documents deleted since the chunk was scanned are already excluded from the remaining
+        // count
+        if (_cloneLocsDeleted[_cloneLocsPos]) {
+            continue;
+        }
+
+        const RecordId& loc = _cloneLocs[_cloneLocsPos];
+
+        boost::optional<Record> record;
+        if (cursorPositioned && (lastNextMatched || loc.repr() == lastLoc.repr() + 1)) {
+            record = cursor->next();
+            lastNextMatched = record && record->id == loc;
+            if (!lastNextMatched) {
+                record = boost::none;
+            }
+        }
+
+        if (!record) {
+            record = cursor->seekExact(loc);
+        }
+
+        cursorPositioned = bool(record);
+        lastLoc = loc;
+
+        if (record) {
+            const BSONObj doc = record->data.toBson();
+
             // Use the builder size instead of accumulating the document sizes directly so that we
             // take into consideration the overhead of BSONArray indices.
             if (arrBuilder->arrSize() &&
-                (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
+                (arrBuilder->len() + doc.objsize() + 1024) > BSONObjMaxUserSize) {
                 break;
             }
 
-            arrBuilder->append(doc.value());
+            arrBuilder->append(doc);
         }
-    }
 
-    _cloneLocs.erase(_cloneLocs.begin(), it);
+        --_cloneLocsRemaining;
+    }
 
     // If we have drained all the cloned data, there is no need to keep the delete notify executor
-    // around
-    if (_cloneLocs.empty()) {
+    // or the record ids around
+    if (_cloneLocsSorted && _cloneLocsPos == _cloneLocs.size()) {
+        _releaseCloneLocs_inlock();
         _deleteNotifyExec.reset();
     }
 
@@ -454,7 +488,7 @@ Status MigrationChunkClonerSourceLegacy::nextModsBatch(OperationContext* txn,
     stdx::lock_guard<stdx::mutex> sl(_mutex);
 
     // All clone data must have been drained before starting to fetch the incremental changes
-    invariant(_cloneLocs.empty());
+    invariant(_cloneLocsRemaining == 0);
 
     long long docSizeAccumulator = 0;
 
@@ -605,7 +639,7 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* txn
 
         if (!isLargeChunk) {
             stdx::lock_guard<stdx::mutex> lk(_mutex);
-            _cloneLocs.insert(recordId);
+            _cloneLocs.push_back(recordId);
         }
 
         if (++recCount > maxRecsWhenFull) {
@@ -646,19 +680,61 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* txn
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _averageObjectSizeForCloneLocs = collectionAverageObjectSize + 12;
 
+    // The shard key index returns the record ids in key order, so sort them once here in order to
+    // transfer the documents in storage order
+    std::sort(_cloneLocs.begin(), _cloneLocs.end());
+    _cloneLocs.erase(std::unique(_cloneLocs.begin(), _cloneLocs.end()), _cloneLocs.end());
+    _cloneLocs.shrink_to_fit();
+
+    _cloneLocsDeleted.assign(_cloneLocs.size(), false);
+    _cloneLocsPos = 0;
+    _cloneLocsRemaining = _cloneLocs.size();
+    _cloneLocsSorted = true;
+
+    for (const auto& loc : _cloneLocsDeletedDuringScan) {
+        _invalidateCloneLoc_inlock(loc);
+    }
+    _cloneLocsDeletedDuringScan.clear();
+
     return Status::OK();
 }
 
+void MigrationChunkClonerSourceLegacy::_invalidateCloneLoc_inlock(const RecordId& loc) {
+    if (!_cloneLocsSorted) {
+        _cloneLocsDeletedDuringScan.insert(loc);
+        return;
+    }
+
+    const auto begin = _cloneLocs.begin() + _cloneLocsPos;
+    const auto it = std::lower_bound(begin, _cloneLocs.end(), loc);
+    if (it == _cloneLocs.end() || *it != loc) {
+        return;
+    }
+
+    const size_t index = it - _cloneLocs.begin();
+    if (!_cloneLocsDeleted[index]) {
+        _cloneLocsDeleted[index] = true;
+        --_cloneLocsRemaining;
+    }
+}
+
+void MigrationChunkClonerSourceLegacy::_releaseCloneLocs_inlock() {
+    std::vector<RecordId>().swap(_cloneLocs);
+    std::vector<bool>().swap(_cloneLocsDeleted);
+    _cloneLocsPos = 0;
+    _cloneLocsRemaining = 0;
+}
+
 void MigrationChunkClonerSourceLegacy::_xfer(OperationContext* txn,
                                              Database* db,
-                                             std::list<BSONObj>* docIdList,
+                                             ModIdQueue* docIdList,
                                              BSONObjBuilder* builder,
                                              const char* fieldName,
                                              long long* sizeAccumulator,
                                              bool explode) {
     const long long maxSize = 1024 * 1024;
 
-    if (docIdList->size() == 0 || *sizeAccumulator > maxSize) {
+    if (docIdList->empty() || *sizeAccumulator > maxSize) {
         return;
     }
 
@@ -666,9 +742,8 @@ void MigrationChunkClonerSourceLegacy::_xfer(OperationContext* txn,
 
     BSONArrayBuilder arr(builder->subarrayStart(fieldName));
 
-    std::list<BSONObj>::iterator docIdIter = docIdList->begin();
-    while (docIdIter != docIdList->end() && *sizeAccumulator < maxSize) {
-        BSONObj idDoc = *docIdIter;
+    while (!docIdList->empty() && *sizeAccumulator < maxSize) {
+        BSONObj idDoc = docIdList->front();
         if (explode) {
             BSONObj fullDoc;
             if (Helpers::findById(txn, db, ns.c_str(), idDoc, fullDoc)) {
@@ -680,10 +755,40 @@ void MigrationChunkClonerSourceLegacy::_xfer(OperationContext* txn,
             *sizeAccumulator += idDoc.objsize();
         }
 
-        docIdIter = docIdList->erase(docIdIter);
+        docIdList->pop();
     }
 
     arr.done();
 }
 
+void MigrationChunkClonerSourceLegacy::ModIdQueue::push(const BSONObj& idObj) {
+    // Reclaim the space of the documents which have already been consumed, once they make up for
+    // at least half of the buffer, so that the buffer does not grow while mods are being drained
+    if (_readOffset > 0 && _readOffset >= _data.size() / 2) {
+        _data.erase(_data.begin(), _data.begin() + _readOffset);
+        _readOffset = 0;
+    }
+
+    _data.insert(_data.end(), idObj.objdata(), idObj.objdata() + idObj.objsize());
+}
+
+BSONObj MigrationChunkClonerSourceLegacy::ModIdQueue::front() const {
+    invariant(!empty());
+    return BSONObj(_data.data() + _readOffset);
+}
+
+void MigrationChunkClonerSourceLegacy::ModIdQueue::pop() {
+    _readOffset += front().objsize();
+
+    if (_readOffset == _data.size()) {
+        _data.clear();
+        _readOffset = 0;
+    }
+}
+
+void MigrationChunkClonerSourceLegacy::ModIdQueue::clear() {
+    std::vector<char>().swap(_data);
+    _readOffset = 0;
+}
+
 }  // namespace mongo
@@ -28,12 +28,13 @@
 
 #pragma once
 
-#include <list>
 #include <set>
+#include <vector>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/record_id.h"
 #include "mongo/db/s/migration_chunk_cloner_source.h"
 #include "mongo/db/s/migration_session_id.h"
 #include "mongo/s/move_chunk_request.h"
@@ -49,7 +50,6 @@ class BSONObjBuilder;
 class Collection;
 class Database;
 class PlanExecutor;
-class RecordId;
 
 class MigrationChunkClonerSourceLegacy final : public MigrationChunkClonerSource {
     MONGO_DISALLOW_COPYING(MigrationChunkClonerSourceLegacy);
@@ -128,6 +128,34 @@ private:
     // Represents the states in which the cloner can be
     enum State { kNew, kCloning, kDone };
 
+    /**
+     * FIFO of the _id documents of modified documents (xfer mods). The documents are stored back
+     * to back in a single buffer rather than as individually allocated BSONObjs, so tracking a
+     * modification costs little more than the size of its _id.
+     */
+    class ModIdQueue {
+    public:
+        bool empty() const {
+            return _readOffset == _data.size();
+        }
+
+        void push(const BSONObj& idObj);
+
+        /**
+         * Returns the oldest queued document. The returned object is not owned and is only valid
+         * until the queue is next modified.
+         */
+        BSONObj front() const;
+
+        void pop();
+
+        void clear();
+
+    private:
+        std::vector<char> _data;
+        size_t _readOffset{0};
+    };
+
     /**
      * Idempotent method, which cleans up any previously initialized state. It is safe to be called
      * at any time, but no methods should be called after it.
@@ -148,6 +176,18 @@ private:
      */
     Status _storeCurrentLocs(OperationContext* txn);
 
+    /**
+     * Called when the record at 'loc' is deleted, so that it is not part of the initial clone.
+     * Must be called with _mutex held.
+     */
+    void _invalidateCloneLoc_inlock(const RecordId& loc);
+
+    /**
+     * Releases the memory of the initial clone snapshot once it has been fully transferred. Must
+     * be called with _mutex held.
+     */
+    void _releaseCloneLocs_inlock();
+
     /**
      * Insert items from docIdList to a new array with the given fieldName in the given builder. If
      * explode is true, the inserted object will be the full version of the document. Note that
@@ -158,7 +198,7 @@ private:
      */
     void _xfer(OperationContext* txn,
                Database* db,
-               std::list<BSONObj>* docIdList,
+               ModIdQueue* docIdList,
                BSONObjBuilder* builder,
                const char* fieldName,
                long long* sizeAccumulator,
@@ -189,19 +229,36 @@ private:
     // The current state of the cloner
     State _state{kNew};
 
-    // List of record ids that needs to be transferred (initial clone)
-    std::set<RecordId> _cloneLocs;
+    // Record ids that need to be transferred (initial clone), sorted once the chunk has been
+    // scanned. Entries before _cloneLocsPos have already been transferred.
+    std::vector<RecordId> _cloneLocs;
+
+    // Parallel to _cloneLocs, marks the entries whose documents were deleted during the clone
+    std::vector<bool> _cloneLocsDeleted;
+
+    // Index of the next entry of _cloneLocs to transfer
+    size_t _cloneLocsPos{0};
+
+    // Number of entries at or after _cloneLocsPos, which are still to be transferred
+    size_t _cloneLocsRemaining{0};
+
+    // Whether _storeCurrentLocs has finished and sorted _cloneLocs
+    bool _cloneLocsSorted{false};
+
+    // Record ids deleted while _storeCurrentLocs was still scanning the chunk, applied to
+    // _cloneLocs once it is sorted
+    std::set<RecordId> _cloneLocsDeletedDuringScan;
 
     // The estimated average object size during the clone phase. Used for buffer size
     // pre-allocation (initial clone).
     uint64_t _averageObjectSizeForCloneLocs{0};
 
     // List of _id of documents that were modified that must be re-cloned (xfer mods)
-    std::list<BSONObj> _reload;
+    ModIdQueue _reload;
 
     // List of _id of documents that were deleted during clone that should be deleted later (xfer
     // mods)
-    std::list<BSONObj> _deleted;
+    ModIdQueue _deleted;
 
     // Total bytes in _reload + _deleted (xfer mods)
     uint64_t _memoryUsed{0};
@@ -58,6 +58,7 @@
 #include "mongo/db/s/move_timing_helper.h"
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/logger/ramlog.h"
 #include "mongo/s/catalog/type_chunk.h"
@@ -68,6 +69,7 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/producer_consumer_queue.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -217,6 +219,10 @@ MONGO_FP_DECLARE(migrateThreadHangAtStep6);
 
 MONGO_FP_DECLARE(failMigrationReceivedOutOfRangeOperation);
 
+// Number of _migrateClone batches which may be fetched from the donor ahead of the batch currently
+// being inserted
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneBatchPrefetchDepth, int, 2);
+
 }  // namespace
 
 MigrationDestinationManager::MigrationDestinationManager() = default;
@@ -354,7 +360,8 @@ void MigrationDestinationManager::cloneDocumentsFromDonor(
     stdx::function<void(OperationContext*, BSONObj)> insertBatchFn,
     stdx::function<BSONObj(OperationContext*)> fetchBatchFn) {
 
-    ProducerConsumerQueue<BSONObj> batches(1);
+    ProducerConsumerQueue<BSONObj> batches(
+        static_cast<size_t>(std::max(1, migrateCloneBatchPrefetchDepth.load())));
     stdx::thread inserterThread{[&] {
         Client::initThreadIfNotAlready("chunkInserter");
         auto inserterTxn = Client::getCurrent()->makeOperationContext();
@@ -712,12 +719,18 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
 
         const BSONObj migrateCloneRequest = createMigrateCloneRequest(_nss, *_sessionId);
 
+        // Fetching runs on this thread while the inserts run on the inserter thread, so each one
+        // only accumulates its own time. Both are only read after the inserter thread has joined.
+        Milliseconds cloneFetchTime{0};
+        Milliseconds cloneApplyTime{0};
+
         auto assertNotAborted = [&](OperationContext* opCtx) {
             opCtx->checkForInterrupt();
             uassert(40655, "Migration aborted while copying documents", getState() != ABORT);
         };
 
         auto insertBatchFn = [&](OperationContext* opCtx, BSONObj arr) {
+            Timer applyTimer;
             int batchNumCloned = 0;
             int batchClonedBytes = 0;
 
@@ -758,9 +771,12 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
                     uassertStatusOK(replStatus.status);
                 }
             }
+
+            cloneApplyTime += Milliseconds(applyTimer.millis());
         };
 
         auto fetchBatchFn = [&](OperationContext* txn) {
+            Timer fetchTimer;
             BSONObj res;
             if (!conn->runCommand("admin",
                                   migrateCloneRequest,
@@ -770,11 +786,15 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
                                                          << redact(res.toString());
                 uasserted(40656, errMsg);
             }
+            cloneFetchTime += Milliseconds(fetchTimer.millis());
             return res;
         };
 
         cloneDocumentsFromDonor(txn, insertBatchFn, fetchBatchFn);
 
+        timing.addPhaseTime("cloneFetch", cloneFetchTime);
+        timing.addPhaseTime("cloneApply", cloneApplyTime);
+
         timing.done(3);
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(migrateThreadHangAtStep3);
     }
@@ -790,6 +810,7 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
         setState(CATCHUP);
 
         while (true) {
+            Timer fetchTimer;
             BSONObj res;
             if (!conn->runCommand("admin", xferModsRequest, res)) {
                 setState(FAIL);
@@ -800,11 +821,20 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
                 return;
             }
 
+            timing.addPhaseTime("catchupFetch", Milliseconds(fetchTimer.millis()));
+
             if (res["size"].number() == 0) {
                 break;
             }
 
+            Timer applyTimer;
             _applyMigrateOp(txn, _nss.ns(), min, max, shardKeyPattern, res, &lastOpApplied);
+            timing.addPhaseTime("catchupApply", Milliseconds(applyTimer.millis()));
+
+            Timer replicationTimer;
+            ON_BLOCK_EXIT([&] {
+                timing.addPhaseTime("catchupReplication", Milliseconds(replicationTimer.millis()));
+            });
 
             const int maxIterations = 3600 * 50;
 
@@ -64,6 +64,15 @@ MoveTimingHelper::~MoveTimingHelper() {
     // even if logChange doesn't throw, bson does
     // sigh
     try {
+        if (!_phaseTimes.empty()) {
+            BSONObjBuilder phasesBuilder(_b.subobjStart("phases"));
+            for (const auto& phaseTime : _phaseTimes) {
+                phasesBuilder.appendNumber(phaseTime.first,
+                                           durationCount<Milliseconds>(phaseTime.second));
+            }
+            phasesBuilder.doneFast();
+        }
+
         if (_to.isValid()) {
             _b.append("to", _to.toString());
         }
@@ -110,4 +119,8 @@ void MoveTimingHelper::done(int step) {
     _t.reset();
 }
 
+void MoveTimingHelper::addPhaseTime(StringData phase, Milliseconds elapsed) {
+    _phaseTimes[phase.toString()] += elapsed;
+}
+
 }  // namespace mongo
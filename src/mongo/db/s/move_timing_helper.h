@@ -28,10 +28,13 @@
 
 #pragma once
 
+#include <map>
 #include <string>
 
+#include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/s/shard_id.h"
+#include "mongo/util/time_support.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -54,6 +57,12 @@ public:
 
     void done(int step);
 
+    /**
+     * Accumulates the time spent in a named phase of the migration (e.g. fetching versus applying
+     * the cloned documents). The totals are reported under "phases" along with the step timings.
+     */
+    void addPhaseTime(StringData phase, Milliseconds elapsed);
+
 private:
     // Measures how long the receiving of a chunk takes
     Timer _t;
@@ -68,6 +77,9 @@ private:
 
     int _nextStep;
     BSONObjBuilder _b;
+
+    // Total time spent in each phase reported through addPhaseTime
+    std::map<std::string, Milliseconds> _phaseTimes;
 };
 
 }  // namespace mongo
@@ -46,9 +46,11 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/util/log.h"
 #include "mongo/util/timer.h"
@@ -65,6 +67,12 @@ namespace {
 
 const int kMaxObjectPerChunk{250000};
 
+// Collections with at least this many records get their split points estimated from a few index
+// seeks, if the storage engine supports it, instead of from a scan of the chunk. The estimate
+// assumes the keys are spread evenly and can place split points far from the real quantiles of a
+// skewed key distribution, so it is disabled (0) unless explicitly enabled.
+MONGO_EXPORT_SERVER_PARAMETER(splitVectorEstimateMinRecords, long long, 0);
+
 BSONObj prettyKey(const BSONObj& keyPattern, const BSONObj& key) {
     return key.replaceFieldNames(keyPattern).clientReadable();
 }
@@ -249,9 +257,55 @@ public:
             }
 
             //
-            // 2. Traverse the index and add the keyCount-th key to the result vector. If that key
-            //    appeared in the vector before, we omit it. The invariant here is that all the
-            //    instances of a given key value live in the same chunk.
+            // 2.a Large chunks on storage engines that can estimate split points from a few seeks
+            //     skip the traversal below. A forced split needs the exact median.
+            //
+
+            const long long estimateMinRecords = splitVectorEstimateMinRecords.load();
+            if (!forceMedianSplit && estimateMinRecords > 0 && recCount >= estimateMinRecords) {
+                Timer timer;
+                vector<BSONObj> estimatedKeys;
+                const IndexAccessMethod* iam = collection->getIndexCatalog()->getIndex(idx);
+                Status status =
+                    iam->estimateSplitKeys(txn, min, max, recCount, keyCount, &estimatedKeys);
+
+                if (status.isOK() && !estimatedKeys.empty()) {
+                    // The chunk's min is a sentinel, as for the traversal below.
+                    splitKeys.push_back(dotted_path_support::extractElementsBasedOnTemplate(
+                        prettyKey(idx->keyPattern(), min), keyPattern));
+
+                    for (const auto& key : estimatedKeys) {
+                        BSONObj splitKey = dotted_path_support::extractElementsBasedOnTemplate(
+                            prettyKey(idx->keyPattern(), key), keyPattern);
+                        if (splitKey.woCompare(splitKeys.back()) <= 0)
+                            continue;
+
+                        splitKeys.push_back(splitKey.getOwned());
+                        if (maxSplitPoints &&
+                            static_cast<long long>(splitKeys.size()) > maxSplitPoints)
+                            break;
+                    }
+                    splitKeys.erase(splitKeys.begin());
+
+                    LOG(1) << "estimated " << splitKeys.size() << " split points for chunk "
+                           << nss.toString() << " " << redact(min) << " -->> " << redact(max)
+                           << " in " << timer.millis() << "ms";
+
+                    result.append("timeMillis", timer.millis());
+                    result.append("splitKeys", splitKeys);
+                    return true;
+                }
+
+                if (!status.isOK() && status != ErrorCodes::CommandNotSupported) {
+                    warning() << "failed to estimate split points for " << nss.toString() << ": "
+                              << redact(status);
+                }
+            }
+
+            //
+            // 2.b Traverse the index and add the keyCount-th key to the result vector. If that
+            //     key appeared in the vector before, we omit it. The invariant here is that all
+            //     the instances of a given key value live in the same chunk.
             //
 
             Timer timer;
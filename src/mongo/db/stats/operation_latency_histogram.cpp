@@ -120,6 +120,20 @@ void OperationLatencyHistogram::append(bool includeHistograms, BSONObjBuilder* b
     _append(_commands, "commands", includeHistograms, builder);
 }
 
+void OperationLatencyHistogram::_addData(const HistogramData& other, HistogramData* data) {
+    for (int i = 0; i < kMaxBuckets; i++) {
+        data->buckets[i] += other.buckets[i];
+    }
+    data->entryCount += other.entryCount;
+    data->sum += other.sum;
+}
+
+void OperationLatencyHistogram::add(const OperationLatencyHistogram& other) {
+    _addData(other._reads, &_reads);
+    _addData(other._writes, &_writes);
+    _addData(other._commands, &_commands);
+}
+
 // Computes the log base 2 of value, and checks for cases of split buckets.
 int OperationLatencyHistogram::_getBucket(uint64_t value) {
     // Zero is a special case since log(0) is undefined.
@@ -57,6 +57,11 @@ public:
      */
     void append(bool includeHistograms, BSONObjBuilder* builder) const;
 
+    /**
+     * Adds the counts and latency totals of 'other' to this histogram.
+     */
+    void add(const OperationLatencyHistogram& other);
+
 private:
     struct HistogramData {
         std::array<uint64_t, kMaxBuckets> buckets{};
@@ -75,6 +80,8 @@ private:
 
     void _incrementData(uint64_t latency, int bucket, HistogramData* data);
 
+    static void _addData(const HistogramData& other, HistogramData* data);
+
     HistogramData _reads, _writes, _commands;
 };
 }  // namespace mongo
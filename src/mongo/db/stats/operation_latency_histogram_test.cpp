@@ -89,4 +89,21 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
         ASSERT_EQUALS(bucket["count"].Long(), (i < kMaxBuckets - 1) ? 3 : 2);
     }
 }
+
+TEST(OperationLatencyHistogram, AddMatchesIncrementingOneHistogram) {
+    OperationLatencyHistogram combined, first, second;
+    for (int i = 0; i < kMaxBuckets; i++) {
+        combined.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        combined.increment(kLowerBounds[i] + 1, Command::ReadWriteType::kCommand);
+        first.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        second.increment(kLowerBounds[i] + 1, Command::ReadWriteType::kCommand);
+    }
+    first.add(second);
+
+    BSONObjBuilder combinedBuilder;
+    combined.append(true, &combinedBuilder);
+    BSONObjBuilder addedBuilder;
+    first.append(true, &addedBuilder);
+    ASSERT_BSONOBJ_EQ(combinedBuilder.obj(), addedBuilder.obj());
+}
 }  // namespace mongo
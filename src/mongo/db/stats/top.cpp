@@ -35,6 +35,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -67,6 +68,19 @@ Top::CollectionData::CollectionData(const CollectionData& older, const Collectio
       remove(older.remove, newer.remove),
       commands(older.commands, newer.commands) {}
 
+void Top::CollectionData::add(const CollectionData& other) {
+    total.add(other.total);
+    readLock.add(other.readLock);
+    writeLock.add(other.writeLock);
+    queries.add(other.queries);
+    getmore.add(other.getmore);
+    insert.add(other.insert);
+    update.add(other.update);
+    remove.add(other.remove);
+    commands.add(other.commands);
+    opLatencyHistogram.add(other.opLatencyHistogram);
+}
+
 // static
 Top& Top::get(ServiceContext* service) {
     return getTop(service);
@@ -82,15 +96,20 @@ void Top::record(OperationContext* txn,
     if (ns[0] == '?')
         return;
 
-    auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-
-    if ((command || logicalOp == LogicalOp::opQuery) && ns == _lastDropped) {
-        _lastDropped = "";
-        return;
+    if ((command || logicalOp == LogicalOp::opQuery) && _hasLastDropped.load()) {
+        stdx::lock_guard<SimpleMutex> lk(_lastDroppedLock);
+        if (ns == _lastDropped) {
+            _lastDropped = "";
+            _hasLastDropped.store(false);
+            return;
+        }
     }
 
-    CollectionData& coll = _usage[hashedNs];
+    auto hashedNs = UsageMap::HashedKey(ns);
+    Partition& partition = _partitionForThisThread();
+    stdx::lock_guard<SimpleMutex> lk(partition.lock);
+
+    CollectionData& coll = partition.usage[hashedNs];
     _record(txn, coll, logicalOp, lockType, micros, readWriteType);
 }
 
@@ -140,23 +159,42 @@ void Top::_record(OperationContext* txn,
 }
 
 void Top::collectionDropped(StringData ns, bool databaseDropped) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _usage.erase(ns);
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.lock);
+        partition.usage.erase(ns);
+    }
+
     if (!databaseDropped) {
         // If a collection drop occurred, there will be a subsequent call to record for this
         // collection namespace which must be ignored. This does not apply to a database drop.
+        stdx::lock_guard<SimpleMutex> lk(_lastDroppedLock);
         _lastDropped = ns.toString();
+        _hasLastDropped.store(true);
     }
 }
 
 void Top::cloneMap(Top::UsageMap& out) const {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    out = _usage;
+    out = _mergedUsage();
 }
 
 void Top::append(BSONObjBuilder& b) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _appendToUsageMap(b, _usage);
+    _appendToUsageMap(b, _mergedUsage());
+}
+
+Top::Partition& Top::_partitionForThisThread() {
+    const size_t hash = std::hash<stdx::thread::id>()(stdx::this_thread::get_id());
+    return _partitions[hash % kNumPartitions];
+}
+
+Top::UsageMap Top::_mergedUsage() const {
+    UsageMap merged;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.lock);
+        for (const auto& entry : partition.usage) {
+            merged[entry.first].add(entry.second);
+        }
+    }
+    return merged;
 }
 
 void Top::_appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const {
@@ -199,9 +237,23 @@ void Top::_appendStatsEntry(BSONObjBuilder& b, const char* statsName, const Usag
 
 void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder) {
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    OperationLatencyHistogram histogram;
+    {
+        // Asking for the latency of a collection makes it show up in top, as it always has.
+        Partition& partition = _partitionForThisThread();
+        stdx::lock_guard<SimpleMutex> lk(partition.lock);
+        partition.usage[hashedNs];
+    }
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.lock);
+        auto it = partition.usage.find(hashedNs);
+        if (it != partition.usage.end()) {
+            histogram.add(it->second.opLatencyHistogram);
+        }
+    }
+
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    histogram.append(includeHistograms, &latencyStatsBuilder);
     builder->append("ns", ns);
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
@@ -209,13 +261,18 @@ void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuild
 void Top::incrementGlobalLatencyStats(OperationContext* txn,
                                       uint64_t latency,
                                       Command::ReadWriteType readWriteType) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(txn, latency, &_globalHistogramStats, readWriteType);
+    Partition& partition = _partitionForThisThread();
+    stdx::lock_guard<SimpleMutex> guard(partition.lock);
+    _incrementHistogram(txn, latency, &partition.globalHistogramStats, readWriteType);
 }
 
 void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.append(includeHistograms, builder);
+    OperationLatencyHistogram globalHistogramStats;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> guard(partition.lock);
+        globalHistogramStats.add(partition.globalHistogramStats);
+    }
+    globalHistogramStats.append(includeHistograms, builder);
 }
 
 void Top::_incrementHistogram(OperationContext* txn,
@@ -29,11 +29,13 @@
 
 #pragma once
 
+#include <array>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/string_map.h"
@@ -44,6 +46,10 @@ class ServiceContext;
 
 /**
  * tracks usage by collection
+ *
+ * Usage is accumulated in a fixed number of partitions, each with its own lock. A thread always
+ * records into the same partition, so threads rarely contend with each other; readers merge the
+ * partitions to produce the same totals a single map would hold.
  */
 class Top {
 public:
@@ -61,6 +67,11 @@ public:
             count++;
             time += micros;
         }
+
+        void add(const UsageData& other) {
+            count += other.count;
+            time += other.time;
+        }
     };
 
     struct CollectionData {
@@ -70,6 +81,11 @@ public:
         CollectionData() {}
         CollectionData(const CollectionData& older, const CollectionData& newer);
 
+        /**
+         * Adds the usage recorded in 'other' to this.
+         */
+        void add(const CollectionData& other);
+
         UsageData total;
 
         UsageData readLock;
@@ -119,6 +135,24 @@ public:
     void appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder);
 
 private:
+    static const size_t kNumPartitions = 16;
+
+    struct Partition {
+        mutable SimpleMutex lock;
+        OperationLatencyHistogram globalHistogramStats;
+        UsageMap usage;
+    };
+
+    /**
+     * Returns the partition the current thread records into.
+     */
+    Partition& _partitionForThisThread();
+
+    /**
+     * Returns the usage of every partition added together.
+     */
+    UsageMap _mergedUsage() const;
+
     void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
 
     void _appendStatsEntry(BSONObjBuilder& b, const char* statsName, const UsageData& map) const;
@@ -135,9 +169,11 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
-    mutable SimpleMutex _lock;
-    OperationLatencyHistogram _globalHistogramStats;
-    UsageMap _usage;
+    std::array<Partition, kNumPartitions> _partitions;
+
+    // Set while '_lastDropped' is non-empty, so that recording need not take '_lastDroppedLock'.
+    AtomicWord<bool> _hasLastDropped{false};
+    SimpleMutex _lastDroppedLock;
     std::string _lastDropped;
 };
 
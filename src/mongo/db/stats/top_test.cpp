@@ -28,7 +28,12 @@
 
 #include "mongo/platform/basic.h"
 
+#include <string>
+#include <vector>
+
+#include "mongo/db/service_context_noop.h"
 #include "mongo/db/stats/top.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace {
@@ -39,4 +44,129 @@ TEST(TopTest, CollectionDropped) {
     Top().collectionDropped("coll");
 }
 
+// Records an insert on 'ns' from a thread of its own, so it lands in that thread's partition.
+void recordInsertOnOtherThread(ServiceContext* service, Top* top, StringData ns) {
+    stdx::thread thread([&] {
+        auto client = service->makeClient("TopTestOther");
+        auto txn = client->makeOperationContext();
+        top->record(
+            txn.get(), ns, LogicalOp::opInsert, 1, 1, false, Command::ReadWriteType::kWrite);
+    });
+    thread.join();
+}
+
+TEST(TopTest, RecordFromManyThreadsMatchesTotals) {
+    ServiceContextNoop service;
+    Top top;
+
+    // Each thread alternates between inserts into "test.a" that take 'thread + 1' microseconds
+    // and queries on "test.b" that take twice as long.
+    const int numThreads = 16;
+    const int opsPerThread = 2000;
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t] {
+            auto client = service.makeClient("TopTest" + std::to_string(t));
+            auto txn = client->makeOperationContext();
+            for (int i = 0; i < opsPerThread; ++i) {
+                if (i % 2) {
+                    top.record(txn.get(),
+                               "test.b",
+                               LogicalOp::opQuery,
+                               -1,
+                               2 * (t + 1),
+                               false,
+                               Command::ReadWriteType::kRead);
+                } else {
+                    top.record(txn.get(),
+                               "test.a",
+                               LogicalOp::opInsert,
+                               1,
+                               t + 1,
+                               false,
+                               Command::ReadWriteType::kWrite);
+                }
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    const long long countPerNs = numThreads * opsPerThread / 2;
+    const long long timeA = (opsPerThread / 2) * (numThreads * (numThreads + 1) / 2);
+    const long long timeB = 2 * timeA;
+
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_EQUALS(2U, usage.size());
+
+    const Top::CollectionData& a = usage["test.a"];
+    ASSERT_EQUALS(countPerNs, a.total.count);
+    ASSERT_EQUALS(timeA, a.total.time);
+    ASSERT_EQUALS(countPerNs, a.insert.count);
+    ASSERT_EQUALS(timeA, a.insert.time);
+    ASSERT_EQUALS(countPerNs, a.writeLock.count);
+    ASSERT_EQUALS(0, a.readLock.count);
+    ASSERT_EQUALS(0, a.queries.count);
+
+    const Top::CollectionData& b = usage["test.b"];
+    ASSERT_EQUALS(countPerNs, b.total.count);
+    ASSERT_EQUALS(timeB, b.total.time);
+    ASSERT_EQUALS(countPerNs, b.queries.count);
+    ASSERT_EQUALS(timeB, b.queries.time);
+    ASSERT_EQUALS(countPerNs, b.readLock.count);
+    ASSERT_EQUALS(0, b.writeLock.count);
+    ASSERT_EQUALS(0, b.insert.count);
+
+    BSONObjBuilder builder;
+    top.append(builder);
+    const BSONObj totals = builder.obj();
+    ASSERT_EQUALS(countPerNs, totals["test.a"]["total"]["count"].numberLong());
+    ASSERT_EQUALS(timeA, totals["test.a"]["total"]["time"].numberLong());
+    ASSERT_EQUALS(countPerNs, totals["test.a"]["insert"]["count"].numberLong());
+    ASSERT_EQUALS(timeA, totals["test.a"]["insert"]["time"].numberLong());
+    ASSERT_EQUALS(countPerNs, totals["test.b"]["total"]["count"].numberLong());
+    ASSERT_EQUALS(timeB, totals["test.b"]["total"]["time"].numberLong());
+    ASSERT_EQUALS(countPerNs, totals["test.b"]["queries"]["count"].numberLong());
+    ASSERT_EQUALS(timeB, totals["test.b"]["queries"]["time"].numberLong());
+}
+
+TEST(TopTest, RecordForJustDroppedCollectionIsIgnored) {
+    ServiceContextNoop service;
+    auto client = service.makeClient("TopTest");
+    auto txn = client->makeOperationContext();
+    Top top;
+    Top::UsageMap usage;
+
+    // The drop clears what every partition recorded for the collection.
+    top.record(
+        txn.get(), "test.a", LogicalOp::opInsert, 1, 1, false, Command::ReadWriteType::kWrite);
+    recordInsertOnOtherThread(&service, &top, "test.a");
+    top.collectionDropped("test.a");
+    top.cloneMap(usage);
+    ASSERT_TRUE(usage.find("test.a") == usage.end());
+
+    // The drop command records itself after the collection is gone, which must not bring it back.
+    top.record(
+        txn.get(), "test.a", LogicalOp::opCommand, 1, 1, true, Command::ReadWriteType::kCommand);
+    top.cloneMap(usage);
+    ASSERT_TRUE(usage.find("test.a") == usage.end());
+
+    // Only that one record is ignored.
+    top.record(
+        txn.get(), "test.a", LogicalOp::opQuery, -1, 1, false, Command::ReadWriteType::kRead);
+    top.cloneMap(usage);
+    ASSERT_EQUALS(1, usage["test.a"].total.count);
+
+    // After a database drop nothing is ignored.
+    recordInsertOnOtherThread(&service, &top, "test.b");
+    top.collectionDropped("test.b", true);
+    top.record(
+        txn.get(), "test.b", LogicalOp::opCommand, 1, 1, true, Command::ReadWriteType::kCommand);
+    top.cloneMap(usage);
+    ASSERT_EQUALS(1, usage["test.b"].total.count);
+    ASSERT_EQUALS(1, usage["test.b"].commands.count);
+}
+
 }  // namespace
@@ -326,6 +326,10 @@ public:
 
     virtual Status kvdb_sync() = 0;
 
+    virtual bool kvdb_mclass_is_configured(enum hse_mclass mclass) = 0;
+
+    virtual Status kvdb_mclass_info_get(enum hse_mclass mclass, struct hse_mclass_info* info) = 0;
+
     bool keyStartsWith(KVDBData key, const uint8_t* prefix, unsigned long pLen) {
         if (pLen <= key.len() && 0 == memcmp(key.data(), prefix, pLen)) {
             return true;
@@ -106,7 +106,7 @@ void KVDBCounterManager::sync(void) {
     _syncAllCounters();
 }
 
-void KVDBCounterManager::sync_for_rename(std::string& ident) {
+bool KVDBCounterManager::sync_for_rename(std::string& ident) {
     stdx::lock_guard<stdx::mutex> lk(_setLock);
     for (auto& rs : _recordStores) {
         if (ident.compare(rs->getIdent()) == 0) {
@@ -120,8 +120,30 @@ void KVDBCounterManager::sync_for_rename(std::string& ident) {
             // The caller (second instance) will fetch them from media shortly.
             rs->updateCounters();
             rs->overTake();
-            break;
+            return true;
         }
     }
+
+    return false;
+}
+
+void KVDBCounterManager::setStartupMetadata(KVDBRecordStoreMetadataMap metadata) {
+    stdx::lock_guard<stdx::mutex> lk(_startupMetadataLock);
+    _startupMetadata = std::move(metadata);
+}
+
+bool KVDBCounterManager::takeStartupMetadata(const std::string& ident,
+                                             KVDBRecordStoreMetadata* out) {
+    stdx::lock_guard<stdx::mutex> lk(_startupMetadataLock);
+    auto it = _startupMetadata.find(ident);
+    if (it == _startupMetadata.end())
+        return false;
+
+    // Once the record store is open it owns the metadata, a later open of the same ident reads
+    // what it flushed.
+    *out = it->second;
+    _startupMetadata.erase(it);
+
+    return true;
 }
 }
@@ -51,6 +51,21 @@ namespace mongo {
 class KVDBIdxBase;
 class KVDBRecordStore;
 
+// The counters and the last RecordId of a record store. sync() persists them in a single metadata
+// record per ident.
+struct KVDBRecordStoreMetadata {
+    int64_t numRecords = 0;
+    int64_t dataSize = 0;
+    int64_t storageSize = 0;
+    int64_t lastId = 0;
+
+    // Whether no record with a RecordId above lastId can exist, i.e. whether the record store can
+    // skip looking up its last RecordId.
+    bool lastIdCurrent = false;
+};
+
+typedef std::unordered_map<std::string, KVDBRecordStoreMetadata> KVDBRecordStoreMetadataMap;
+
 class KVDBCounterManager {
 public:
     KVDBCounterManager(bool crashSafe);
@@ -62,7 +77,17 @@ public:
 
     void syncPeriodic();
     void sync();
-    void sync_for_rename(std::string& ident);
+
+    // Returns true if a record store was open on 'ident' and has flushed its metadata.
+    bool sync_for_rename(std::string& ident);
+
+    /**
+     * Keeps the metadata records the engine read at startup, keyed by ident, for the record
+     * stores that open afterwards. takeStartupMetadata() hands out each one once, to the first
+     * record store opened on the ident, and returns false when there is none.
+     */
+    void setStartupMetadata(KVDBRecordStoreMetadataMap metadata);
+    bool takeStartupMetadata(const std::string& ident, KVDBRecordStoreMetadata* out);
 
 private:
     void _syncAllCounters();
@@ -79,5 +104,8 @@ private:
     std::atomic<bool> _syncing{false};
 
     std::mutex _setLock;
+
+    KVDBRecordStoreMetadataMap _startupMetadata;
+    std::mutex _startupMetadataLock;
 };
 }
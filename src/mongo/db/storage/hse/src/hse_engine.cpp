@@ -42,12 +42,15 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/db/catalog/collection.h"
 #include "mongo/db/client.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 
 #include "hse_engine.h"
 #include "hse_global_options.h"
@@ -84,6 +87,15 @@ uint32_t decodePrefix(const uint8_t* prefixPtr) {
     return endian::bigToNative(*bigEndianPrefix);
 }
 
+const std::pair<enum hse_mclass, const char*> kMclasses[] = {
+    {HSE_MCLASS_CAPACITY, "capacity"}, {HSE_MCLASS_STAGING, "staging"}, {HSE_MCLASS_PMEM, "pmem"}};
+
+// The default policy is left to HSE, so that KVSes are opened as before unless one is configured.
+void addMclassPolicy(vector<string>* rParams, const string& policy) {
+    if (policy != KVDBGlobalOptions::kDefaultMclassPolicyStr)
+        rParams->push_back("mclass.policy=" + policy);
+}
+
 }  // namespace
 
 /* Start KVDBEngine */
@@ -94,15 +106,26 @@ const string KVDBEngine::kLargeKvsName = "LargeKvs";
 const string KVDBEngine::kOplogKvsName = "OplogKvs";
 const string KVDBEngine::kOplogLargeKvsName = "OplogLargeKvs";
 const string KVDBEngine::kMetadataPrefix = KVDB_prefix + "meta-";
+const string KVDBEngine::kCleanShutdownKey = KVDB_prefix + "cleanshutdown";
+const size_t KVDBEngine::kMaxStartupThreads;
 
 
-KVDBEngine::KVDBEngine(const std::string& path, bool durable, int formatVersion, bool readOnly)
-    : _dbHome(path), _durable(durable), _formatVersion(formatVersion), _maxPrefix(0) {
+KVDBEngine::KVDBEngine(
+    const std::string& path, bool durable, int formatVersion, bool readOnly, bool inMemory)
+    : _dbHome(path),
+      _inMemory(inMemory),
+      _durable(durable && !inMemory),
+      _formatVersion(formatVersion),
+      _maxPrefix(0) {
     _setupDb();
 
-    _loadMaxPrefix();
+    // An in-memory KVDB is created empty on every start, so there is nothing to recover.
+    const bool cleanStart = _inMemory || _takeCleanShutdownMarker();
+
+    _loadMaxPrefix(cleanStart);
 
     _counterManager.reset(new KVDBCounterManager(kvdbGlobalOptions.getCrashSafeCounters()));
+    _counterManager->setStartupMetadata(_loadRecordStoreMetadata(cleanStart));
     _durabilityManager.reset(
         new KVDBDurabilityManager(_db, _durable, kvdbGlobalOptions.getForceLag()));
 
@@ -133,6 +156,12 @@ Status KVDBEngine::createRecordStore(OperationContext* opCtx,
         // HSE_REVIST: TBD when we have put options for compression.
     }
 
+    // Capped collections are ordered by insertion, which a clustered one cannot keep.
+    if (_isClustered(options) && (options.capped || iType == KVDBIdentType::OPLOG)) {
+        return Status(ErrorCodes::InvalidOptions,
+                      str::stream() << "capped collection " << ns << " cannot be clustered");
+    }
+
     return _createIdent(opCtx, ident, iType, &configBuilder);
 }
 
@@ -149,7 +178,10 @@ std::unique_ptr<RecordStore> KVDBEngine::getRecordStore(OperationContext* opCtx,
     KVDBCounterManager& counterRef = *(_counterManager.get());
 
 
-    if (!colOpts.capped) {
+    if (!colOpts.capped && _isClustered(colOpts)) {
+        recordStore = stdx::make_unique<KVDBClusteredRecordStore>(
+            opCtx, ns, ident, _db, _mainKvs, _largeKvs, prefix, durRef, counterRef);
+    } else if (!colOpts.capped) {
         recordStore = stdx::make_unique<KVDBRecordStore>(
             opCtx, ns, ident, _db, _mainKvs, _largeKvs, prefix, durRef, counterRef);
     } else {
@@ -187,10 +219,7 @@ std::unique_ptr<RecordStore> KVDBEngine::getRecordStore(OperationContext* opCtx,
         }
     }
 
-    {
-        stdx::lock_guard<stdx::mutex> lk(_identObjectMapMutex);
-        _identCollectionMap[ident] = recordStore.get();
-    }
+    _identCollectionMap.set(ident, recordStore.get());
 
     return std::move(recordStore);
 }
@@ -212,10 +241,19 @@ SortedDataInterface* KVDBEngine::getSortedDataInterface(OperationContext* opCtx,
     auto config = _getIdentConfig(ident);
     std::string prefix = encodePrefix(_extractPrefix(config));
 
-    KVDBIdxBase* index;
+    SortedDataInterface* index;
     const std::string indexSizeKey = KVDB_prefix + "indexsize-" + ident.toString();
 
-    if (desc->unique()) {
+    // The _id index of a clustered collection is served by the collection's record store.
+    const KVDBClusteredRecordStore* clusteredRs = nullptr;
+    if (desc->isIdIndex() && desc->getCollection()) {
+        clusteredRs =
+            dynamic_cast<const KVDBClusteredRecordStore*>(desc->getCollection()->getRecordStore());
+    }
+
+    if (clusteredRs) {
+        index = new KVDBClusteredIdIdx(*clusteredRs);
+    } else if (desc->unique()) {
         index = new KVDBUniqIdx(_db,
                                 _uniqIdxKvs,
                                 *(_counterManager.get()),
@@ -237,10 +275,7 @@ SortedDataInterface* KVDBEngine::getSortedDataInterface(OperationContext* opCtx,
                                desc->getNumFields(),
                                indexSizeKey);
     }
-    {
-        stdx::lock_guard<stdx::mutex> lk(_identObjectMapMutex);
-        _identIndexMap[ident] = index;
-    }
+    _identIndexMap.set(ident, index);
     return index;
 }
 
@@ -264,10 +299,12 @@ Status KVDBEngine::dropIdent(OperationContext* opCtx, StringData ident) {
         string dataSizeKeyStr = KVDB_prefix + "datasize-" + ident.toString();
         string storageSizeKeyStr = KVDB_prefix + "storagesize-" + ident.toString();
         string numRecordsKeyStr = KVDB_prefix + "numrecords-" + ident.toString();
+        string metadataKeyStr = KVDBRecordStore::kMetadataKeyPrefix + ident.toString();
 
         KVDBData dataSizeKey{dataSizeKeyStr};
         KVDBData storageSizeKey{storageSizeKeyStr};
         KVDBData numRecordsKey{numRecordsKeyStr};
+        KVDBData metadataKey{metadataKeyStr};
 
         s = _db.kvs_sub_txn_prefix_delete(_mainKvs, pKeyToDel);
         if (!s.ok()) {
@@ -293,6 +330,11 @@ Status KVDBEngine::dropIdent(OperationContext* opCtx, StringData ident) {
             return hseToMongoStatus(s);
         }
 
+        s = _db.kvs_sub_txn_delete(_mainKvs, metadataKey);
+        if (!s.ok()) {
+            return hseToMongoStatus(s);
+        }
+
         _identCollectionMap.erase(ident);
     } else if (KVDBIdentType::OPLOG == type) {
         _oplogBlkMgr->dropAllBlocks(opCtx, prefixVal);
@@ -327,24 +369,39 @@ Status KVDBEngine::dropIdent(OperationContext* opCtx, StringData ident) {
     }
 
     // remove from map
-    {
-        stdx::lock_guard<stdx::mutex> lk(_identMapMutex);
-        _identMap.erase(ident);
+    _identMap.erase(ident);
+
+    return Status::OK();
+}
+
+// static
+Status KVDBEngine::validateCollectionOptions(const BSONObj& options) {
+    BSONElement clustered = options[KVDBClusteredRecordStore::kClusteredFieldName];
+    if (!clustered.eoo() && !clustered.isBoolean()) {
+        return Status(ErrorCodes::InvalidOptions,
+                      str::stream() << "'" << KVDBClusteredRecordStore::kClusteredFieldName
+                                    << "' must be a boolean, got: "
+                                    << clustered);
     }
 
     return Status::OK();
 }
 
+// static
+bool KVDBEngine::_isClustered(const CollectionOptions& options) {
+    BSONObj engine = options.storageEngine.getObjectField("hse");
+
+    return engine[KVDBClusteredRecordStore::kClusteredFieldName].trueValue();
+}
+
 bool KVDBEngine::hasIdent(OperationContext* opCtx, StringData ident) const {
-    stdx::lock_guard<stdx::mutex> lk(_identMapMutex);
-    return _identMap.find(ident) != _identMap.end();
+    return _identMap.contains(ident);
 }
 
 std::vector<std::string> KVDBEngine::getAllIdents(OperationContext* opCtx) const {
     std::vector<std::string> indents;
-    for (auto& entry : _identMap) {
-        indents.push_back(entry.first);
-    }
+    _identMap.forEach(
+        [&](StringData ident, const BSONObj& config) { indents.push_back(ident.toString()); });
     return indents;
 }
 
@@ -375,19 +432,20 @@ bool KVDBEngine::isDurable() const {
 }
 
 bool KVDBEngine::isEphemeral() const {
-    return false;
+    return _inMemory;
 }
 
 int64_t KVDBEngine::getIdentSize(OperationContext* opCtx, StringData ident) {
-    stdx::lock_guard<stdx::mutex> lk(_identObjectMapMutex);
-
-    auto indexIter = _identIndexMap.find(ident);
-    if (indexIter != _identIndexMap.end()) {
-        return static_cast<int64_t>(indexIter->second->getSpaceUsedBytes(opCtx));
+    // The object stays locked in its shard while sized, so a concurrent dropIdent can't free it.
+    int64_t size = 0;
+    if (_identIndexMap.visit(ident, [&](SortedDataInterface* index) {
+            size = static_cast<int64_t>(index->getSpaceUsedBytes(opCtx));
+        })) {
+        return size;
     }
-    auto collectionIter = _identCollectionMap.find(ident);
-    if (collectionIter != _identCollectionMap.end()) {
-        return collectionIter->second->storageSize(opCtx);
+    if (_identCollectionMap.visit(
+            ident, [&](KVDBRecordStore* rs) { size = rs->storageSize(opCtx); })) {
+        return size;
     }
 
     // this can only happen if collection or index exists, but it's not opened (i.e.
@@ -470,14 +528,25 @@ void KVDBEngine::_prepareConfig() {
     string vCompr = kvdbGlobalOptions.getCompressionStr();
     string vComprMinBytes = kvdbGlobalOptions.getCompressionMinBytesStr();
 
+    const string collectionPolicy = kvdbGlobalOptions.getCollectionMclassPolicyStr();
+    const string largeValuePolicy = kvdbGlobalOptions.getLargeValueMclassPolicyStr();
+    const string oplogPolicy = kvdbGlobalOptions.getOplogMclassPolicyStr();
+    const string uniqueIndexPolicy = kvdbGlobalOptions.getUniqueIndexMclassPolicyStr();
+    const string indexPolicy = kvdbGlobalOptions.getIndexMclassPolicyStr();
+
     _kvdbRParams.push_back("txn_timeout=8589934591");
     _kvdbRParams.push_back("durability.interval_ms=" + std::to_string(ms));
+    if (_inMemory) {
+        // Nothing survives a restart, so there is no point in writing a journal.
+        _kvdbRParams.push_back("durability.enabled=false");
+    }
 
     _mainKvsCParams.push_back("prefix.length=" + std::to_string(DEFAULT_PFX_LEN));
     _mainKvsCParams.push_back("prefix.pivot=" + pfxPivot);
     _mainKvsRParams.push_back("transactions.enabled=true");
     _mainKvsRParams.push_back("compression.value.algorithm=" + vCompr);
     _mainKvsRParams.push_back("compression.value.min_length=" + vComprMinBytes);
+    addMclassPolicy(&_mainKvsRParams, collectionPolicy);
 
 
     _largeKvsCParams.push_back("prefix.length=" + std::to_string(DEFAULT_PFX_LEN));
@@ -485,17 +554,20 @@ void KVDBEngine::_prepareConfig() {
     _largeKvsRParams.push_back("transactions.enabled=true");
     _largeKvsRParams.push_back("compression.value.algorithm=" + vCompr);
     _largeKvsRParams.push_back("compression.value.min_length=" + vComprMinBytes);
+    addMclassPolicy(&_largeKvsRParams, largeValuePolicy);
 
 
     _oplogKvsCParams.push_back("prefix.length=" + std::to_string(OPLOG_PFX_LEN));
     _oplogKvsCParams.push_back("fanout=" + std::to_string(OPLOG_FANOUT));
     _oplogKvsCParams.push_back("kvs_ext01=1");
     _oplogKvsRParams.push_back("transactions.enabled=true");
+    addMclassPolicy(&_oplogKvsRParams, oplogPolicy);
 
     _oplogLargeKvsCParams.push_back("prefix.length=" + std::to_string(OPLOG_PFX_LEN));
     _oplogLargeKvsCParams.push_back("fanout=" + std::to_string(OPLOG_FANOUT));
     _oplogLargeKvsCParams.push_back("kvs_ext01=1");
     _oplogLargeKvsRParams.push_back("transactions.enabled=true");
+    addMclassPolicy(&_oplogLargeKvsRParams, oplogPolicy);
 
     _uniqIdxKvsCParams.push_back("prefix.length=" + std::to_string(DEFAULT_PFX_LEN));
     _uniqIdxKvsCParams.push_back("suffix.length=" + std::to_string(DEFAULT_SFX_LEN));
@@ -503,6 +575,7 @@ void KVDBEngine::_prepareConfig() {
     _uniqIdxKvsRParams.push_back("transactions.enabled=true");
     _uniqIdxKvsRParams.push_back("compression.value.algorithm=" + vCompr);
     _uniqIdxKvsRParams.push_back("compression.value.min_length=" + vComprMinBytes);
+    addMclassPolicy(&_uniqIdxKvsRParams, uniqueIndexPolicy);
 
     _stdIdxKvsCParams.push_back("prefix.length=" + std::to_string(DEFAULT_PFX_LEN));
     _stdIdxKvsCParams.push_back("suffix.length=" + std::to_string(STDIDX_SFX_LEN));
@@ -510,11 +583,63 @@ void KVDBEngine::_prepareConfig() {
     _stdIdxKvsRParams.push_back("transactions.enabled=true");
     _stdIdxKvsRParams.push_back("compression.value.algorithm=" + vCompr);
     _stdIdxKvsRParams.push_back("compression.value.min_length=" + vComprMinBytes);
+    addMclassPolicy(&_stdIdxKvsRParams, indexPolicy);
+}
+
+std::vector<std::pair<std::string, std::string>> KVDBEngine::_mclassPolicies() const {
+    return {{"collections", kvdbGlobalOptions.getCollectionMclassPolicyStr()},
+            {"largeValues", kvdbGlobalOptions.getLargeValueMclassPolicyStr()},
+            {"oplog", kvdbGlobalOptions.getOplogMclassPolicyStr()},
+            {"uniqueIndexes", kvdbGlobalOptions.getUniqueIndexMclassPolicyStr()},
+            {"indexes", kvdbGlobalOptions.getIndexMclassPolicyStr()}};
+}
+
+void KVDBEngine::_checkMclassPolicies() {
+    for (auto& policy : _mclassPolicies()) {
+        for (auto& mclass : kMclasses) {
+            // Policies are named after the media classes they place data on.
+            if (policy.second.find(mclass.second) == string::npos ||
+                _db.kvdb_mclass_is_configured(mclass.first))
+                continue;
+
+            severe() << "HSE: the " << policy.first << " media class policy " << policy.second
+                     << " needs a " << mclass.second << " media class, which the KVDB at "
+                     << _dbHome << " doesn't have";
+            fassertFailedNoTrace(40387);
+        }
+    }
+}
+
+void KVDBEngine::appendMediaClassStats(BSONObjBuilder* bob) {
+    BSONObjBuilder mclassBob(bob->subobjStart("mediaClasses"));
+    for (auto& mclass : kMclasses) {
+        if (!_db.kvdb_mclass_is_configured(mclass.first))
+            continue;
+
+        struct hse_mclass_info info;
+        auto st = _db.kvdb_mclass_info_get(mclass.first, &info);
+        if (!st.ok())
+            continue;
+
+        BSONObjBuilder infoBob(mclassBob.subobjStart(mclass.second));
+        infoBob.append("path", info.mi_path);
+        infoBob.append("allocatedBytes", static_cast<long long>(info.mi_allocated_bytes));
+        infoBob.append("usedBytes", static_cast<long long>(info.mi_used_bytes));
+    }
+    mclassBob.done();
+
+    BSONObjBuilder policyBob(bob->subobjStart("mclassPolicies"));
+    for (auto& policy : _mclassPolicies())
+        policyBob.append(policy.first, policy.second);
 }
 
 void KVDBEngine::_setupDb() {
     namespace fs = boost::filesystem;
     fs::path dbHomePath(_dbHome);
+    if (_inMemory) {
+        // Left behind if the previous in-memory engine didn't shut down cleanly.
+        fs::remove_all(dbHomePath);
+    }
     if (fs::create_directory(dbHomePath))
         fs::permissions(dbHomePath,
                         fs::perms::owner_all | fs::perms::group_read | fs::perms::group_exe);
@@ -531,6 +656,7 @@ void KVDBEngine::_setupDb() {
     }
 
     _open_kvdb(_dbHome, _kvdbCParams, _kvdbRParams);
+    _checkMclassPolicies();
 
     _open_kvs(kMainKvsName, _mainKvs, _mainKvsCParams, _mainKvsRParams);
     _open_kvs(kLargeKvsName, _largeKvs, _largeKvsCParams, _largeKvsRParams);
@@ -596,17 +722,16 @@ void KVDBEngine::_checkMaxPrefix() {
     // for now set the new _maxPrefix == maxPrefix.
     // this should be very rare, we could consider deleting the
     // orphan prefixes in a later release.
-    if (maxPrefix > _maxPrefix) {
+    if (maxPrefix > _maxPrefix.load()) {
         log() << "Orphan prefixes detected!!, increasing the _maxPrefix value to avoid prefix "
                  "pollution.";
-        _maxPrefix = maxPrefix;
+        _maxPrefix.store(maxPrefix);
     }
 }
 
-void KVDBEngine::_loadMaxPrefix() {
+void KVDBEngine::_loadMaxPrefix(bool cleanStart) {
     // load ident to prefix map. also update _maxPrefix if there's any prefix bigger than
-    // current _maxPrefix
-    stdx::lock_guard<stdx::mutex> lk(_identMapMutex);
+    // current _maxPrefix. Runs single threaded from the constructor.
     KVDBData kPrefix{(uint8_t*)kMetadataPrefix.c_str(), kMetadataPrefix.size()};
     KvsCursor* cursor;
 
@@ -638,29 +763,132 @@ void KVDBEngine::_loadMaxPrefix() {
 
         LOG(1) << "HSE: Loading Ident " << string((const char*)ident.data(), ident.len());
 
-        _identMap[StringData((const char*)ident.clone().data(), ident.len())] =
-            std::move(identConfig.getOwned());
+        _identMap.set(StringData((const char*)ident.data(), ident.len()), identConfig.getOwned());
 
-        _maxPrefix = std::max(_maxPrefix, identPrefix);
+        _maxPrefix.store(std::max(_maxPrefix.load(), identPrefix));
     }
     invariantHse(eof);
 
     delete cursor;
 
-    _checkMaxPrefix();
+    // Orphan prefixes can only be left behind by a crash.
+    if (!cleanStart)
+        _checkMaxPrefix();
+}
+
+bool KVDBEngine::_takeCleanShutdownMarker() {
+    KVDBData key{kCleanShutdownKey};
+    KVDBData val{};
+    bool found = false;
+
+    val.createOwned(1);
+    auto st = _db.kvs_get(_mainKvs, 0, key, val, found);
+    invariantHseSt(st);
+
+    if (found) {
+        // The marker must not outlive this run, or a crash would pass for a clean shutdown.
+        st = _db.kvs_sub_txn_delete(_mainKvs, key);
+        invariantHseSt(st);
+        st = _db.kvdb_sync();
+        invariantHseSt(st);
+    }
+
+    LOG(1) << "HSE: starting after " << (found ? "a clean" : "an unclean") << " shutdown";
+
+    return found;
+}
+
+KVDBRecordStoreMetadataMap KVDBEngine::_loadRecordStoreMetadata(bool cleanStart) {
+    KVDBRecordStoreMetadataMap metadata;
+    const std::string& metaPrefix = KVDBRecordStore::kMetadataKeyPrefix;
+    KVDBData kPrefix{metaPrefix};
+    KvsCursor* cursor;
+
+    // A single scan reads the metadata of all the collections, instead of a get per collection
+    // when it opens.
+    cursor = new KvsCursor(_mainKvs, kPrefix, true, 0);
+    invariantHse(cursor != 0);
+
+    KVDBData key{};
+    KVDBData val{};
+    bool eof = false;
+    while (true) {
+        auto st = cursor->read(key, val, eof);
+        invariantHseSt(st);
+        if (eof)
+            break;
+
+        KVDBRecordStoreMetadata meta;
+        if (!KVDBRecordStore::decodeMetadata(val, &meta))
+            continue;
+
+        meta.lastIdCurrent = cleanStart;
+        metadata.emplace(string((const char*)key.data() + metaPrefix.size(),
+                                key.len() - metaPrefix.size()),
+                         meta);
+    }
+
+    delete cursor;
+
+    if (!cleanStart)
+        _findLastIds(&metadata);
+
+    LOG(1) << "HSE: loaded the metadata of " << metadata.size() << " collections";
+
+    return metadata;
+}
+
+void KVDBEngine::_findLastIds(KVDBRecordStoreMetadataMap* metadata) {
+    // After an unclean shutdown records may have been written after their collection's metadata,
+    // so the last RecordIds are looked up with a reverse seek per collection. The seeks are
+    // independent and run on several threads rather than one at a time as the collections open.
+    std::vector<std::pair<KVDBRecordStoreMetadata*, uint32_t>> colls;
+    _identMap.forEach([&](StringData ident, const BSONObj& config) {
+        auto it = metadata->find(ident.toString());
+        if (it != metadata->end() && _extractType(config) == KVDBIdentType::COLL)
+            colls.emplace_back(&it->second, _extractPrefix(config));
+    });
+
+    const size_t nThreads =
+        std::min<size_t>(kMaxStartupThreads, std::max(1U, stdx::thread::hardware_concurrency()));
+    std::vector<stdx::thread> threads;
+
+    for (size_t t = 0; t < std::min(nThreads, colls.size()); t++) {
+        threads.emplace_back([this, &colls, nThreads, t]() {
+            for (size_t i = t; i < colls.size(); i += nThreads) {
+                RecordId lastId = KVDBRecordStore::lastIdInKvs(_mainKvs, colls[i].second);
+                colls[i].first->lastId = lastId.repr();
+                colls[i].first->lastIdCurrent = true;
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
 }
 
 void KVDBEngine::_cleanShutdown() {
     _durabilityManager->prepareForShutdown();
     _durabilityManager.reset();
 
+    // Every record store has just flushed its metadata, which the next startup can trust.
     _counterManager->sync();
     _counterManager.reset();
 
+    if (!_inMemory) {
+        KVDBData markerKey{kCleanShutdownKey};
+        KVDBData markerVal{(uint8_t*)"", 0};
+        auto st = _db.kvs_sub_txn_put(_mainKvs, markerKey, markerVal);
+        invariantHseSt(st);
+    }
+
     KVDBStatRate::finish();
 
     _db.kvdb_close();
     hse::fini();
+
+    if (_inMemory)
+        boost::filesystem::remove_all(_dbHome);
 }
 
 // non public api
@@ -670,19 +898,16 @@ Status KVDBEngine::_createIdent(OperationContext* opCtx,
                                 BSONObjBuilder* configBuilder) {
     BSONObj config;
     uint32_t prefix = 0;
-    {
-        stdx::lock_guard<stdx::mutex> lk(_identMapMutex);
-        if (_identMap.find(ident) != _identMap.end()) {
-            // already exists
-            return Status::OK();
-        }
+    if (_identMap.contains(ident)) {
+        // already exists
+        return Status::OK();
+    }
 
-        prefix = ++_maxPrefix;
-        configBuilder->append("prefix", static_cast<int32_t>(prefix));
-        configBuilder->append("type", static_cast<int32_t>(type));
+    prefix = _maxPrefix.addAndFetch(1);
+    configBuilder->append("prefix", static_cast<int32_t>(prefix));
+    configBuilder->append("type", static_cast<int32_t>(type));
 
-        config = std::move(configBuilder->obj());
-    }
+    config = std::move(configBuilder->obj());
 
     string keyStr = kMetadataPrefix + ident.toString();
     KVDBData key{(uint8_t*)keyStr.c_str(), keyStr.size()};
@@ -692,19 +917,15 @@ Status KVDBEngine::_createIdent(OperationContext* opCtx,
     auto ru = KVDBRecoveryUnit::getKVDBRecoveryUnit(opCtx);
     auto s = ru->put(_mainKvs, key, val);
 
-    {
-        stdx::lock_guard<stdx::mutex> lk(_identMapMutex);
-        _identMap[ident] = config.copy();
-    }
+    _identMap.set(ident, config.copy());
 
     return hseToMongoStatus(s);
 }
 
 BSONObj KVDBEngine::_getIdentConfig(StringData ident) {
-    stdx::lock_guard<stdx::mutex> lk(_identMapMutex);
-    auto identIter = _identMap.find(ident);
-    invariantHse(identIter != _identMap.end());
-    return identIter->second.copy();
+    BSONObj config;
+    invariantHse(_identMap.find(ident, &config));
+    return config.copy();
 }
 
 uint32_t KVDBEngine::_extractPrefix(const BSONObj& config) {
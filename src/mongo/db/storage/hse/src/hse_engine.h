@@ -45,7 +45,8 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/ordering.h"
 #include "mongo/db/storage/kv/kv_engine.h"
-#include "mongo/util/string_map.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/sharded_string_map.h"
 
 
 #include "hse_counter_manager.h"
@@ -73,7 +74,15 @@ class KVDBEngine final : public KVEngine {
     MONGO_DISALLOW_COPYING(KVDBEngine);
 
 public:
-    KVDBEngine(const string& path, bool durable, int formatVersion, bool readOnly);
+    /**
+     * An in-memory engine runs a KVDB that is neither durable nor synced, meant to live on tmpfs.
+     * It starts empty and removes its home directory when it shuts down.
+     */
+    KVDBEngine(const string& path,
+               bool durable,
+               int formatVersion,
+               bool readOnly,
+               bool inMemory = false);
     virtual ~KVDBEngine();
 
     virtual RecoveryUnit* newRecoveryUnit() override;
@@ -106,6 +115,10 @@ public:
 
     virtual bool supportsDirectoryPerDB() const override;
 
+    virtual bool supportsPrefetch() const override {
+        return true;
+    }
+
     virtual int flushAllFiles(bool sync) override;
 
     virtual Status beginBackup(OperationContext* txn) override;
@@ -132,11 +145,26 @@ public:
      */
     static bool initOplogStoreThread(StringData ns);
 
+    /**
+     * Validates the "hse" section of the storageEngine options of a collection.
+     */
+    static Status validateCollectionOptions(const BSONObj& options);
+
+    /**
+     * Appends the space used on each media class of the KVDB, and the media class placement
+     * policy of each group of KVSes.
+     */
+    void appendMediaClassStats(BSONObjBuilder* bob);
 
     virtual void setJournalListener(JournalListener* jl);
 
 
 private:
+    // Simulates crashes by editing what a clean shutdown left in the KVDB.
+    friend class KVDBEngineHarnessHelper;
+
+    static bool _isClustered(const CollectionOptions& options);
+
     void _prepareConfig();
     void _setupDb();
     void _open_kvdb(const string& dbHome,
@@ -147,9 +175,19 @@ private:
                    const vector<string>& cParams,
                    const vector<string>& rParams);
     void _cleanShutdown();
+
+    // Pairs of a KVS group name and the media class placement policy configured for it.
+    std::vector<std::pair<std::string, std::string>> _mclassPolicies() const;
+    // Fails startup if a policy needs a media class the KVDB doesn't have.
+    void _checkMclassPolicies();
     uint32_t _getMaxPrefixInKvs(KVSHandle& kvs);
     void _checkMaxPrefix();
-    void _loadMaxPrefix();
+    void _loadMaxPrefix(bool cleanStart);
+
+    // Returns whether the previous shutdown was clean, and removes the marker it left.
+    bool _takeCleanShutdownMarker();
+    KVDBRecordStoreMetadataMap _loadRecordStoreMetadata(bool cleanStart);
+    void _findLastIds(KVDBRecordStoreMetadataMap* metadata);
     Status _createIdent(OperationContext* opCtx,
                         StringData ident,
                         KVDBIdentType type,
@@ -160,6 +198,7 @@ private:
     string _getMongoConfigStr(void);
 
     const string _dbHome;
+    const bool _inMemory;
     bool _durable;
     const int _formatVersion;
 
@@ -177,6 +216,12 @@ private:
     // Special prefixes
     static const string kMetadataPrefix;
 
+    // Written last by a clean shutdown.
+    static const string kCleanShutdownKey;
+
+    // Upper bound on the threads that look up the last RecordIds at startup.
+    static const size_t kMaxStartupThreads = 16;
+
     // configuration
     vector<string> _kvdbCParams{};
     vector<string> _kvdbRParams{};
@@ -200,21 +245,19 @@ private:
     KVSHandle _oplogKvs;
     KVSHandle _oplogLargeKvs;
 
+    // The ident maps are sharded so that creating and dropping idents doesn't hold up lookups
+    // of other idents. A shard lock is never held while locking another map.
+
     // ident map stores mapping from ident to a BSON config
-    mutable stdx::mutex _identMapMutex;
-    typedef StringMap<BSONObj> IdentMap;
+    typedef ShardedStringMap<BSONObj> IdentMap;
     IdentMap _identMap;
 
-    // protected by _identMapMutex
-    uint32_t _maxPrefix;
+    AtomicUInt32 _maxPrefix;
 
-    // _identObjectMapMutex protects both _identIndexMap and _identCollectionMap. It should
-    // never be locked together with _identMapMutex
-    mutable stdx::mutex _identObjectMapMutex;
     // mapping from ident --> index object. we don't own the object
-    StringMap<KVDBIdxBase*> _identIndexMap;
+    ShardedStringMap<SortedDataInterface*> _identIndexMap;
     // mapping from ident --> collection object
-    StringMap<KVDBRecordStore*> _identCollectionMap;
+    ShardedStringMap<KVDBRecordStore*> _identCollectionMap;
 
 
     std::unique_ptr<KVDBDurabilityManager> _durabilityManager;
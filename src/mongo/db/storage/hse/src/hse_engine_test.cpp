@@ -31,17 +31,30 @@
  *    exception statement from all source files in the program, then also delete
  *    it in the license file.
  */
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
 #include "mongo/platform/basic.h"
 
 #include <boost/filesystem/operations.hpp>
 #include <memory>
 
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/kv/kv_catalog.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/kv/kv_engine_test_harness.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/options_parser/environment.h"
+#include "mongo/util/scopeguard.h"
 
 #include "hse_engine.h"
 #include "hse_global_options.h"
+#include "hse_record_store.h"
 #include "hse_ut_common.h"
 
 namespace mongo {
@@ -72,6 +85,52 @@ public:
         return _engine.get();
     }
 
+    // Shuts the engine down, then leaves the KVDB as a crash would have: without the clean
+    // shutdown marker, and with the metadata of 'ident' still holding 'staleLastId' as its last
+    // RecordId. Restarts the engine on it.
+    KVEngine* restartEngineAfterCrash(const std::string& ident, const RecordId& staleLastId) {
+        _engine.reset(nullptr);
+
+        hse::Status st = hse::init();
+        ASSERT_EQUALS(0, st.getErrno());
+
+        KVDBImpl db;
+        st = db.kvdb_open(_dbFixture.getDbHome().c_str(), vector<string>{});
+        ASSERT_EQUALS(0, st.getErrno());
+
+        KVSHandle mainKvs;
+        st = db.kvdb_kvs_open(KVDBEngine::kMainKvsName.c_str(), vector<string>{}, mainKvs);
+        ASSERT_EQUALS(0, st.getErrno());
+
+        KVDBData markerKey{KVDBEngine::kCleanShutdownKey};
+        st = db.kvs_sub_txn_delete(mainKvs, markerKey);
+        ASSERT_EQUALS(0, st.getErrno());
+
+        const std::string metaKeyStr = KVDBRecordStore::kMetadataKeyPrefix + ident;
+        KVDBData metaKey{metaKeyStr};
+        KVDBData metaVal{};
+        bool found = false;
+        metaVal.createOwned(64);
+        st = db.kvs_get(mainKvs, 0, metaKey, metaVal, found);
+        ASSERT_EQUALS(0, st.getErrno());
+        ASSERT_TRUE(found);
+
+        KVDBRecordStoreMetadata meta;
+        ASSERT_TRUE(KVDBRecordStore::decodeMetadata(metaVal, &meta));
+        meta.lastId = staleLastId.repr();
+        const std::string metaValStr = KVDBRecordStore::encodeMetadata(meta);
+        st = db.kvs_sub_txn_put(mainKvs, metaKey, KVDBData{metaValStr});
+        ASSERT_EQUALS(0, st.getErrno());
+
+        st = db.kvdb_kvs_close(mainKvs);
+        ASSERT_EQUALS(0, st.getErrno());
+        st = db.kvdb_close();
+        ASSERT_EQUALS(0, st.getErrno());
+        hse::fini();
+
+        return restartEngine();
+    }
+
 private:
     unittest::TempDir _dbpath;
 
@@ -84,4 +143,256 @@ private:
 KVHarnessHelper* KVHarnessHelper::create() {
     return new KVDBEngineHarnessHelper();
 }
+
+namespace {
+class EngineOperationContext : public OperationContextNoop {
+public:
+    EngineOperationContext(KVEngine* engine) : OperationContextNoop(engine->newRecoveryUnit()) {}
+};
+}  // namespace
+
+// After a clean restart the collections open with the counters and last RecordIds read at startup.
+TEST(KVDBEngineTest, ReopenCollectionsAfterCleanRestart) {
+    const int nColls = 10;
+    KVDBEngineHarnessHelper helper;
+    KVEngine* engine = helper.getEngine();
+    std::vector<std::string> namespaces;
+    std::vector<RecordId> lastIds;
+
+    for (int i = 0; i < nColls; i++) {
+        std::string ns = str::stream() << "test.coll" << i;
+        EngineOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+
+        ASSERT_OK(engine->createRecordStore(&opCtx, ns, ns, CollectionOptions()));
+        auto rs = engine->getRecordStore(&opCtx, ns, ns, CollectionOptions());
+        for (int j = 0; j < 3; j++)
+            ASSERT_OK(rs->insertRecord(&opCtx, "abc", 4, false).getStatus());
+        lastIds.push_back(rs->insertRecord(&opCtx, "abc", 4, false).getValue());
+        uow.commit();
+
+        namespaces.push_back(ns);
+    }
+
+    engine = helper.restartEngine();
+
+    for (int i = 0; i < nColls; i++) {
+        EngineOperationContext opCtx(engine);
+        auto rs = engine->getRecordStore(&opCtx, namespaces[i], namespaces[i], CollectionOptions());
+        WriteUnitOfWork uow(&opCtx);
+
+        ASSERT_EQ(4, rs->numRecords(&opCtx));
+        auto res = rs->insertRecord(&opCtx, "abc", 4, false);
+        ASSERT_OK(res.getStatus());
+        ASSERT_GT(res.getValue(), lastIds[i]);
+        uow.commit();
+    }
+}
+
+// After an unclean restart the metadata may lag behind the records, so the last RecordIds are
+// looked up in the collections themselves and new RecordIds continue past the real last record.
+TEST(KVDBEngineTest, ReopenCollectionAfterUncleanRestart) {
+    const std::string ns = "test.coll";
+    KVDBEngineHarnessHelper helper;
+    KVEngine* engine = helper.getEngine();
+    RecordId firstId;
+    RecordId lastId;
+
+    {
+        EngineOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+
+        ASSERT_OK(engine->createRecordStore(&opCtx, ns, ns, CollectionOptions()));
+        auto rs = engine->getRecordStore(&opCtx, ns, ns, CollectionOptions());
+        firstId = rs->insertRecord(&opCtx, "abc", 4, false).getValue();
+        for (int j = 0; j < 2; j++)
+            ASSERT_OK(rs->insertRecord(&opCtx, "abc", 4, false).getStatus());
+        lastId = rs->insertRecord(&opCtx, "abc", 4, false).getValue();
+        uow.commit();
+    }
+
+    engine = helper.restartEngineAfterCrash(ns, firstId);
+
+    EngineOperationContext opCtx(engine);
+    auto rs = engine->getRecordStore(&opCtx, ns, ns, CollectionOptions());
+    WriteUnitOfWork uow(&opCtx);
+
+    auto res = rs->insertRecord(&opCtx, "abc", 4, false);
+    ASSERT_OK(res.getStatus());
+    ASSERT_GT(res.getValue(), lastId);
+    ASSERT_EQ(5, rs->numRecords(&opCtx));
+    uow.commit();
+}
+
+// Creates and then drops collections through the catalog and the engine, the way the storage
+// engine does, while reader threads keep looking up a collection that exists throughout and list
+// the collections. Readers must always find the fixed collection and never see a namespace that
+// is reserved but not yet stored.
+TEST(KVDBEngineTest, LookupsDuringCreateAndDrop) {
+    const int nColls = 200;
+    const int nReaders = 4;
+    KVDBEngineHarnessHelper helper;
+    KVEngine* engine = helper.getEngine();
+
+    std::unique_ptr<RecordStore> catalogRs;
+    std::unique_ptr<KVCatalog> catalog;
+    {
+        EngineOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(engine->createRecordStore(&opCtx, "catalog", "catalog", CollectionOptions()));
+        catalogRs = engine->getRecordStore(&opCtx, "catalog", "catalog", CollectionOptions());
+        catalog.reset(new KVCatalog(catalogRs.get(), false, false));
+        catalog->init(&opCtx);
+
+        ASSERT_OK(catalog->newCollection(&opCtx, "test.fixed", CollectionOptions()));
+        std::string ident = catalog->getCollectionIdent("test.fixed");
+        ASSERT_OK(engine->createRecordStore(&opCtx, "test.fixed", ident, CollectionOptions()));
+        uow.commit();
+    }
+    const std::string fixedIdent = catalog->getCollectionIdent("test.fixed");
+
+    AtomicWord<bool> done(false);
+    AtomicUInt64 misses;
+    AtomicUInt64 emptyIdents;
+    std::vector<stdx::thread> readers;
+    for (int t = 0; t < nReaders; t++) {
+        readers.emplace_back([&]() {
+            EngineOperationContext opCtx(engine);
+            while (!done.load()) {
+                if (catalog->getCollectionIdent("test.fixed") != fixedIdent ||
+                    !engine->hasIdent(&opCtx, fixedIdent))
+                    misses.fetchAndAdd(1);
+                for (auto& ident : catalog->getAllIdentsForDB("test")) {
+                    if (ident.empty())
+                        emptyIdents.fetchAndAdd(1);
+                }
+            }
+        });
+    }
+
+    std::vector<std::string> idents;
+    for (int i = 0; i < nColls; i++) {
+        std::string ns = str::stream() << "test.coll" << i;
+        EngineOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+
+        ASSERT_OK(catalog->newCollection(&opCtx, ns, CollectionOptions()));
+        idents.push_back(catalog->getCollectionIdent(ns));
+        ASSERT_OK(engine->createRecordStore(&opCtx, ns, idents.back(), CollectionOptions()));
+        uow.commit();
+    }
+
+    std::vector<std::string> namespaces;
+    catalog->getAllCollections(&namespaces);
+    ASSERT_EQ(static_cast<size_t>(nColls + 1), namespaces.size());
+    ASSERT_EQ(static_cast<size_t>(nColls + 1), catalog->getAllIdentsForDB("test").size());
+
+    for (int i = 0; i < nColls; i++) {
+        std::string ns = str::stream() << "test.coll" << i;
+        EngineOperationContext opCtx(engine);
+        {
+            WriteUnitOfWork uow(&opCtx);
+            ASSERT_OK(catalog->dropCollection(&opCtx, ns));
+            uow.commit();
+        }
+        ASSERT_OK(engine->dropIdent(&opCtx, idents[i]));
+    }
+
+    done.store(true);
+    for (auto& reader : readers)
+        reader.join();
+
+    ASSERT_EQ(0U, misses.load());
+    ASSERT_EQ(0U, emptyIdents.load());
+    namespaces.clear();
+    catalog->getAllCollections(&namespaces);
+    ASSERT_EQ(1U, namespaces.size());
+    ASSERT_EQ("test.fixed", namespaces[0]);
+    ASSERT_FALSE(engine->hasIdent(nullptr, idents[0]));
+}
+
+namespace {
+void setMediaPlacement(const std::string& stagingPath,
+                       const std::string& oplogPolicy,
+                       const std::string& uniqueIndexPolicy,
+                       const std::string& largeValuePolicy) {
+    moe::Environment params;
+    ASSERT_OK(params.set("storage.hse.stagingPath", moe::Value(stagingPath)));
+    ASSERT_OK(params.set("storage.hse.oplogMclassPolicy", moe::Value(oplogPolicy)));
+    ASSERT_OK(params.set("storage.hse.uniqueIndexMclassPolicy", moe::Value(uniqueIndexPolicy)));
+    ASSERT_OK(params.set("storage.hse.largeValueMclassPolicy", moe::Value(largeValuePolicy)));
+    ASSERT_OK(kvdbGlobalOptions.store(params, {}));
+}
+}  // namespace
+
+// Opens a KVDB with a staging media class, with plain directories standing in for the capacity
+// and staging media, and places some of the KVSes on it. Checks what serverStatus reports.
+TEST(KVDBEngineTest, MediaClassPlacement) {
+    unittest::TempDir tempDir("mongo-hse-mclass-test");
+    const std::string home = tempDir.path() + "/kvdb";
+    const std::string staging = tempDir.path() + "/staging";
+    ASSERT_TRUE(boost::filesystem::create_directory(staging));
+
+    const std::string defaultPolicy = KVDBGlobalOptions::kDefaultMclassPolicyStr;
+    setMediaPlacement(staging, "staging_only", "staging_max_capacity", "capacity_only");
+    ON_BLOCK_EXIT([&] { setMediaPlacement("", defaultPolicy, defaultPolicy, defaultPolicy); });
+
+    KVDBTestSuiteFixture::getFixture().closeDb();
+    KVDBEngine engine(home, false, 3, false);
+    {
+        EngineOperationContext opCtx(&engine);
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(engine.createRecordStore(&opCtx, "test.coll", "test.coll", CollectionOptions()));
+        auto rs = engine.getRecordStore(&opCtx, "test.coll", "test.coll", CollectionOptions());
+        ASSERT_OK(rs->insertRecord(&opCtx, "abc", 4, false).getStatus());
+        uow.commit();
+    }
+
+    BSONObjBuilder bob;
+    engine.appendMediaClassStats(&bob);
+    BSONObj stats = bob.obj();
+    log() << "media class stats: " << stats;
+
+    BSONObj mclasses = stats["mediaClasses"].Obj();
+    ASSERT_TRUE(mclasses["capacity"].isABSONObj());
+    ASSERT_TRUE(mclasses["capacity"]["usedBytes"].isNumber());
+    ASSERT_TRUE(boost::filesystem::equivalent(staging, mclasses["staging"]["path"].String()));
+    ASSERT_TRUE(mclasses["staging"]["allocatedBytes"].isNumber());
+    ASSERT_FALSE(mclasses.hasField("pmem"));
+
+    BSONObj policies = stats["mclassPolicies"].Obj();
+    ASSERT_EQ("auto", policies["collections"].String());
+    ASSERT_EQ("capacity_only", policies["largeValues"].String());
+    ASSERT_EQ("staging_only", policies["oplog"].String());
+    ASSERT_EQ("staging_max_capacity", policies["uniqueIndexes"].String());
+    ASSERT_EQ("auto", policies["indexes"].String());
+}
+
+// An in-memory engine starts empty every time and removes its KVDB when it shuts down.
+TEST(KVDBEngineTest, InMemory) {
+    unittest::TempDir tempDir("mongo-hse-in-memory-test");
+    const std::string home = tempDir.path() + "/kvdb";
+
+    KVDBTestSuiteFixture::getFixture().closeDb();
+    for (int run = 0; run < 2; run++) {
+        KVDBEngine engine(home, true, 3, false, true);
+        ASSERT_TRUE(engine.isEphemeral());
+        ASSERT_FALSE(engine.isDurable());
+        ASSERT_FALSE(engine.hasIdent(nullptr, "test.coll"));
+
+        EngineOperationContext opCtx(&engine);
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(engine.createRecordStore(&opCtx, "test.coll", "test.coll", CollectionOptions()));
+        auto rs = engine.getRecordStore(&opCtx, "test.coll", "test.coll", CollectionOptions());
+        auto res = rs->insertRecord(&opCtx, "abc", 4, false);
+        ASSERT_OK(res.getStatus());
+        uow.commit();
+
+        RecordData data;
+        ASSERT_TRUE(rs->findRecord(&opCtx, res.getValue(), &data));
+        ASSERT_EQ(1, rs->numRecords(&opCtx));
+        ASSERT_TRUE(opCtx.recoveryUnit()->waitUntilDurable());
+    }
+    ASSERT_FALSE(boost::filesystem::exists(home));
+}
 }
@@ -62,6 +62,18 @@ const std::string KVDBGlobalOptions::kDefaultPmemPathStr{};
 // Default config path is empty.
 const std::string KVDBGlobalOptions::kDefaultConfigPathStr{};
 
+// Forward oplog cursors read ahead up to a full 16MB getMore batch.
+const int KVDBGlobalOptions::kDefaultOplogReadAheadMB = 16;
+
+// Read-only operations release their read view on every yield by default.
+const int KVDBGlobalOptions::kDefaultPinnedReadViewMaxAgeMS = 0;
+
+// KVSes are placed on the media classes by HSE's own default policy.
+const std::string KVDBGlobalOptions::kDefaultMclassPolicyStr{"auto"};
+
+// In-memory KVDBs are put on the tmpfs that is mounted on most Linux systems.
+const std::string KVDBGlobalOptions::kDefaultInMemoryPathStr{"/dev/shm"};
+
 
 KVDBGlobalOptions kvdbGlobalOptions;
 
@@ -98,6 +110,50 @@ const std::string pmemPathOptStr = modName + "PmemPath";
 const std::string configPathCfgStr = cfgStrPrefix + "configPath";
 const std::string configPathOptStr = modName + "ConfigPath";
 
+// Oplog cursor read-ahead
+const std::string oplogReadAheadMBCfgStr = cfgStrPrefix + "oplogReadAheadMB";
+const std::string oplogReadAheadMBOptStr = modName + "OplogReadAheadMB";
+
+// Read view pinning across yields
+const std::string pinnedReadViewMaxAgeMSCfgStr = cfgStrPrefix + "pinnedReadViewMaxAgeMS";
+const std::string pinnedReadViewMaxAgeMSOptStr = modName + "PinnedReadViewMaxAgeMS";
+
+// Media class placement of the KVSes
+const std::string collectionMclassPolicyCfgStr = cfgStrPrefix + "collectionMclassPolicy";
+const std::string collectionMclassPolicyOptStr = modName + "CollectionMclassPolicy";
+const std::string largeValueMclassPolicyCfgStr = cfgStrPrefix + "largeValueMclassPolicy";
+const std::string largeValueMclassPolicyOptStr = modName + "LargeValueMclassPolicy";
+const std::string oplogMclassPolicyCfgStr = cfgStrPrefix + "oplogMclassPolicy";
+const std::string oplogMclassPolicyOptStr = modName + "OplogMclassPolicy";
+const std::string uniqueIndexMclassPolicyCfgStr = cfgStrPrefix + "uniqueIndexMclassPolicy";
+const std::string uniqueIndexMclassPolicyOptStr = modName + "UniqueIndexMclassPolicy";
+const std::string indexMclassPolicyCfgStr = cfgStrPrefix + "indexMclassPolicy";
+const std::string indexMclassPolicyOptStr = modName + "IndexMclassPolicy";
+
+// In-memory mode
+const std::string inMemoryCfgStr = cfgStrPrefix + "inMemory";
+const std::string inMemoryOptStr = modName + "InMemory";
+const std::string inMemoryPathCfgStr = cfgStrPrefix + "inMemoryPath";
+const std::string inMemoryPathOptStr = modName + "InMemoryPath";
+
+const std::string mclassPolicyFormat{
+    "(:?auto)|(:?capacity_only)|(:?staging_only)|(:?staging_max_capacity)|"
+    "(:?staging_min_capacity)|(:?pmem_only)|(:?pmem_max_capacity)"};
+const std::string mclassPolicyDisplayFormat{
+    "[auto|capacity_only|staging_only|staging_max_capacity|staging_min_capacity|pmem_only|"
+    "pmem_max_capacity]"};
+
+void addMclassPolicyOption(moe::OptionSection& options,
+                           const std::string& cfgStr,
+                           const std::string& optStr,
+                           const std::string& what) {
+    options
+        .addOptionChaining(
+            cfgStr, optStr, moe::String, "media class placement policy of the " + what)
+        .format(mclassPolicyFormat, mclassPolicyDisplayFormat)
+        .setDefault(moe::Value(KVDBGlobalOptions::kDefaultMclassPolicyStr));
+}
+
 }  // namespace
 
 Status KVDBGlobalOptions::add(moe::OptionSection* options) {
@@ -147,6 +203,49 @@ Status KVDBGlobalOptions::add(moe::OptionSection* options) {
         .addOptionChaining(configPathCfgStr, configPathOptStr, moe::String, "path for config file")
         .setDefault(moe::Value(kDefaultConfigPathStr));
 
+    kvdbOptions
+        .addOptionChaining(oplogReadAheadMBCfgStr,
+                           oplogReadAheadMBOptStr,
+                           moe::Int,
+                           "largest size of the read-ahead buffer of forward oplog cursors "
+                           "<0 disables it>")
+        .validRange(0, 256)
+        .setDefault(moe::Value(kDefaultOplogReadAheadMB));
+
+    kvdbOptions
+        .addOptionChaining(pinnedReadViewMaxAgeMSCfgStr,
+                           pinnedReadViewMaxAgeMSOptStr,
+                           moe::Int,
+                           "how long read-only operations may keep their read view across yields, "
+                           "checked only when the operation yields <0 disables it>")
+        .validRange(0, 60000)
+        .setDefault(moe::Value(kDefaultPinnedReadViewMaxAgeMS));
+
+    addMclassPolicyOption(
+        kvdbOptions, collectionMclassPolicyCfgStr, collectionMclassPolicyOptStr, "collections");
+    addMclassPolicyOption(kvdbOptions,
+                          largeValueMclassPolicyCfgStr,
+                          largeValueMclassPolicyOptStr,
+                          "values too large for the collection KVS");
+    addMclassPolicyOption(kvdbOptions, oplogMclassPolicyCfgStr, oplogMclassPolicyOptStr, "oplog");
+    addMclassPolicyOption(kvdbOptions,
+                          uniqueIndexMclassPolicyCfgStr,
+                          uniqueIndexMclassPolicyOptStr,
+                          "unique indexes");
+    addMclassPolicyOption(
+        kvdbOptions, indexMclassPolicyCfgStr, indexMclassPolicyOptStr, "non-unique indexes");
+
+    kvdbOptions.addOptionChaining(inMemoryCfgStr,
+                                  inMemoryOptStr,
+                                  moe::Switch,
+                                  "keep all data in a KVDB on tmpfs that is neither durable nor "
+                                  "kept across restarts");
+
+    kvdbOptions
+        .addOptionChaining(
+            inMemoryPathCfgStr, inMemoryPathOptStr, moe::String, "tmpfs path for in-memory mode")
+        .setDefault(moe::Value(kDefaultInMemoryPathStr));
+
     return options->addSection(kvdbOptions);
 }
 
@@ -195,6 +294,54 @@ Status KVDBGlobalOptions::store(const moe::Environment& params,
         log() << "Config path str: " << kvdbGlobalOptions._configPathStr;
     }
 
+    if (params.count(oplogReadAheadMBCfgStr)) {
+        kvdbGlobalOptions._oplogReadAheadMB = params[oplogReadAheadMBCfgStr].as<int>();
+        log() << "Oplog read-ahead MB: " << kvdbGlobalOptions._oplogReadAheadMB;
+    }
+
+    if (params.count(pinnedReadViewMaxAgeMSCfgStr)) {
+        kvdbGlobalOptions._pinnedReadViewMaxAgeMS = params[pinnedReadViewMaxAgeMSCfgStr].as<int>();
+        log() << "Pinned read view max age MS: " << kvdbGlobalOptions._pinnedReadViewMaxAgeMS;
+    }
+
+    if (params.count(collectionMclassPolicyCfgStr)) {
+        kvdbGlobalOptions._collectionMclassPolicyStr =
+            params[collectionMclassPolicyCfgStr].as<std::string>();
+        log() << "Collection mclass policy: " << kvdbGlobalOptions._collectionMclassPolicyStr;
+    }
+
+    if (params.count(largeValueMclassPolicyCfgStr)) {
+        kvdbGlobalOptions._largeValueMclassPolicyStr =
+            params[largeValueMclassPolicyCfgStr].as<std::string>();
+        log() << "Large value mclass policy: " << kvdbGlobalOptions._largeValueMclassPolicyStr;
+    }
+
+    if (params.count(oplogMclassPolicyCfgStr)) {
+        kvdbGlobalOptions._oplogMclassPolicyStr = params[oplogMclassPolicyCfgStr].as<std::string>();
+        log() << "Oplog mclass policy: " << kvdbGlobalOptions._oplogMclassPolicyStr;
+    }
+
+    if (params.count(uniqueIndexMclassPolicyCfgStr)) {
+        kvdbGlobalOptions._uniqueIndexMclassPolicyStr =
+            params[uniqueIndexMclassPolicyCfgStr].as<std::string>();
+        log() << "Unique index mclass policy: " << kvdbGlobalOptions._uniqueIndexMclassPolicyStr;
+    }
+
+    if (params.count(indexMclassPolicyCfgStr)) {
+        kvdbGlobalOptions._indexMclassPolicyStr = params[indexMclassPolicyCfgStr].as<std::string>();
+        log() << "Index mclass policy: " << kvdbGlobalOptions._indexMclassPolicyStr;
+    }
+
+    if (params.count(inMemoryCfgStr)) {
+        kvdbGlobalOptions._inMemory = params[inMemoryCfgStr].as<bool>();
+        log() << "In-memory: " << kvdbGlobalOptions._inMemory;
+    }
+
+    if (params.count(inMemoryPathCfgStr)) {
+        kvdbGlobalOptions._inMemoryPathStr = params[inMemoryPathCfgStr].as<std::string>();
+        log() << "In-memory path str: " << kvdbGlobalOptions._inMemoryPathStr;
+    }
+
     return Status::OK();
 }
 
@@ -234,5 +381,41 @@ std::string KVDBGlobalOptions::getConfigPathStr() const {
     return _configPathStr;
 }
 
+size_t KVDBGlobalOptions::getOplogReadAheadBytes() const {
+    return static_cast<size_t>(_oplogReadAheadMB) * 1024 * 1024;
+}
+
+int KVDBGlobalOptions::getPinnedReadViewMaxAgeMS() const {
+    return _pinnedReadViewMaxAgeMS;
+}
+
+std::string KVDBGlobalOptions::getCollectionMclassPolicyStr() const {
+    return _collectionMclassPolicyStr;
+}
+
+std::string KVDBGlobalOptions::getLargeValueMclassPolicyStr() const {
+    return _largeValueMclassPolicyStr;
+}
+
+std::string KVDBGlobalOptions::getOplogMclassPolicyStr() const {
+    return _oplogMclassPolicyStr;
+}
+
+std::string KVDBGlobalOptions::getUniqueIndexMclassPolicyStr() const {
+    return _uniqueIndexMclassPolicyStr;
+}
+
+std::string KVDBGlobalOptions::getIndexMclassPolicyStr() const {
+    return _indexMclassPolicyStr;
+}
+
+bool KVDBGlobalOptions::getInMemory() const {
+    return _inMemory;
+}
+
+std::string KVDBGlobalOptions::getInMemoryPathStr() const {
+    return _inMemoryPathStr;
+}
+
 
 }  // namespace mongo
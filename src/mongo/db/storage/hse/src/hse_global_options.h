@@ -51,7 +51,16 @@ public:
           _crashSafeCounters{false},
           _stagingPathStr{kDefaultStagingPathStr},
           _pmemPathStr{kDefaultPmemPathStr},
-          _configPathStr{kDefaultConfigPathStr} {}
+          _configPathStr{kDefaultConfigPathStr},
+          _oplogReadAheadMB{kDefaultOplogReadAheadMB},
+          _pinnedReadViewMaxAgeMS{kDefaultPinnedReadViewMaxAgeMS},
+          _collectionMclassPolicyStr{kDefaultMclassPolicyStr},
+          _largeValueMclassPolicyStr{kDefaultMclassPolicyStr},
+          _oplogMclassPolicyStr{kDefaultMclassPolicyStr},
+          _uniqueIndexMclassPolicyStr{kDefaultMclassPolicyStr},
+          _indexMclassPolicyStr{kDefaultMclassPolicyStr},
+          _inMemory{false},
+          _inMemoryPathStr{kDefaultInMemoryPathStr} {}
 
     Status add(moe::OptionSection* options);
     Status store(const moe::Environment& params, const std::vector<std::string>& args);
@@ -67,6 +76,17 @@ public:
     std::string getStagingPathStr() const;
     std::string getPmemPathStr() const;
     std::string getConfigPathStr() const;
+    size_t getOplogReadAheadBytes() const;
+    int getPinnedReadViewMaxAgeMS() const;
+    std::string getCollectionMclassPolicyStr() const;
+    std::string getLargeValueMclassPolicyStr() const;
+    std::string getOplogMclassPolicyStr() const;
+    std::string getUniqueIndexMclassPolicyStr() const;
+    std::string getIndexMclassPolicyStr() const;
+    bool getInMemory() const;
+    std::string getInMemoryPathStr() const;
+
+    static const std::string kDefaultMclassPolicyStr;
 
 private:
     static const int kDefaultForceLag;
@@ -77,6 +97,9 @@ private:
     static const std::string kDefaultStagingPathStr;
     static const std::string kDefaultPmemPathStr;
     static const std::string kDefaultConfigPathStr;
+    static const int kDefaultOplogReadAheadMB;
+    static const int kDefaultPinnedReadViewMaxAgeMS;
+    static const std::string kDefaultInMemoryPathStr;
 
     int _forceLag;
 
@@ -88,6 +111,15 @@ private:
     std::string _stagingPathStr;
     std::string _pmemPathStr;
     std::string _configPathStr;
+    int _oplogReadAheadMB;
+    int _pinnedReadViewMaxAgeMS;
+    std::string _collectionMclassPolicyStr;
+    std::string _largeValueMclassPolicyStr;
+    std::string _oplogMclassPolicyStr;
+    std::string _uniqueIndexMclassPolicyStr;
+    std::string _indexMclassPolicyStr;
+    bool _inMemory;
+    std::string _inMemoryPathStr;
 };
 
 extern KVDBGlobalOptions kvdbGlobalOptions;
@@ -119,6 +119,14 @@ Status KVDBImpl::kvdb_free_names(char** kvsv) {
     return Status();
 }
 
+bool KVDBImpl::kvdb_mclass_is_configured(enum hse_mclass mclass) {
+    return ::hse_kvdb_mclass_is_configured(_handle, mclass);
+}
+
+Status KVDBImpl::kvdb_mclass_info_get(enum hse_mclass mclass, struct hse_mclass_info* info) {
+    return Status(::hse_kvdb_mclass_info_get(_handle, mclass, info));
+}
+
 Status KVDBImpl::kvdb_kvs_make(const char* kvs_name, const vector<string>& params) {
     CStyleStrVec cVec{params};
     return Status(::hse_kvdb_kvs_create(_handle, kvs_name, cVec.getCount(), cVec.getCVec()));
@@ -115,6 +115,10 @@ public:
 
     virtual Status kvdb_sync();
 
+    virtual bool kvdb_mclass_is_configured(enum hse_mclass mclass);
+
+    virtual Status kvdb_mclass_info_get(enum hse_mclass mclass, struct hse_mclass_info* info);
+
 private:
     struct hse_kvdb* _handle = nullptr;
 };
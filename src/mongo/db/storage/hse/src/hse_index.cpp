@@ -50,6 +50,7 @@
 
 #include "hse_impl.h"
 #include "hse_index.h"
+#include "hse_record_store.h"
 
 
 namespace mongo {
@@ -111,6 +112,35 @@ string makePrefixedKey(const string& prefix, const KeyString& encodedKey) {
     key.append(encodedKey.getBuffer(), encodedKey.getSize());
     return key;
 }
+
+// Upper bound on the number of seeks estimateSplitKeys() issues for one range.
+const long long kMaxEstimatedSplitKeys = 10000;
+
+// Reads the 8 bytes of 'key' that follow the first 'offset' bytes as a big-endian number,
+// padding short keys with zeros. estimateSplitKeys() interpolates key positions on it.
+uint64_t keyPosition(const string& key, size_t offset) {
+    uint64_t pos = 0;
+
+    for (size_t i = offset; i < offset + sizeof(pos); i++)
+        pos = (pos << 8) | (i < key.size() ? static_cast<uint8_t>(key[i]) : 0);
+
+    return pos;
+}
+
+size_t commonPrefixLength(const string& a, const string& b) {
+    size_t len = 0;
+
+    while (len < a.size() && len < b.size() && a[len] == b[len])
+        len++;
+
+    return len;
+}
+
+string currentKeyString(const KVDBIdxCursorBase* cursor) {
+    const KeyString& key = cursor->getKeyString();
+
+    return string(key.getBuffer(), key.getSize());
+}
 }  // namespace
 
 /* Start KVDBIdxCursorBase */
@@ -428,6 +458,17 @@ void KVDBIdxCursorBase::_seekCursor(const KeyString& query) {
 }
 
 
+boost::optional<IndexKeyEntry> KVDBIdxCursorBase::seekRaw(const KeyString& pos) {
+    _eof = false;
+    _lastPointGet = false;
+
+    _ensureCursor();
+    _seekCursor(pos);
+    _updatePosition();
+
+    return _curr(kKeyAndLoc);
+}
+
 KVDBIdxCursorBase::~KVDBIdxCursorBase() {
     _destroyMCursor();
 }
@@ -668,6 +709,89 @@ long long KVDBIdxBase::getSpaceUsedBytes(OperationContext* opctx) const {
     return static_cast<int64_t>(_indexSize.load());
 }
 
+Status KVDBIdxBase::estimateSplitKeys(OperationContext* opctx,
+                                      const BSONObj& startKey,
+                                      const BSONObj& endKey,
+                                      long long numEntries,
+                                      long long keysPerRange,
+                                      std::vector<BSONObj>* splitKeys) const {
+    // Assume the entries are spread evenly over the KeyString space between the first and the
+    // last key of the index. Four seeks then give the share of the index that falls within the
+    // range, and one more seek per split point finds the key at each interpolated position.
+    // An empty result means the range is too small or too narrow to estimate.
+    invariantHse(keysPerRange > 0);
+    splitKeys->clear();
+
+    auto fwd = newCursor(opctx, true);
+    auto bwd = newCursor(opctx, false);
+    auto fwdCursor = checked_cast<KVDBIdxCursorBase*>(fwd.get());
+    auto bwdCursor = checked_cast<KVDBIdxCursorBase*>(bwd.get());
+
+    KeyString pos(_keyStringVersion);
+    if (!fwdCursor->seekRaw(pos))
+        return Status::OK();
+    const string indexFirst = currentKeyString(fwdCursor);
+
+    // No KeyString starts with 0xff.
+    const string maxPos(sizeof(uint64_t), '\xff');
+    pos.resetFromBuffer(maxPos.data(), maxPos.size());
+    if (!bwdCursor->seekRaw(pos))
+        return Status::OK();
+    const string indexLast = currentKeyString(bwdCursor);
+
+    auto rangeFirstEntry = fwdCursor->seek(startKey, true);
+    auto rangeLastEntry = bwdCursor->seek(endKey, false);
+    if (!rangeFirstEntry || !rangeLastEntry)
+        return Status::OK();
+    const string rangeFirst = currentKeyString(fwdCursor);
+    const string rangeLast = currentKeyString(bwdCursor);
+    if (rangeFirst >= rangeLast)
+        return Status::OK();
+
+    const size_t indexOffset = commonPrefixLength(indexFirst, indexLast);
+    const uint64_t indexSpan =
+        keyPosition(indexLast, indexOffset) - keyPosition(indexFirst, indexOffset);
+    const uint64_t rangeSpan =
+        keyPosition(rangeLast, indexOffset) - keyPosition(rangeFirst, indexOffset);
+    if (indexSpan == 0 || rangeSpan == 0)
+        return Status::OK();
+
+    const double rangeEntries = static_cast<double>(numEntries) * rangeSpan / indexSpan;
+    const long long numSplits =
+        std::min(static_cast<long long>((rangeEntries - 1) / keysPerRange), kMaxEstimatedSplitKeys);
+
+    // Interpolate within the range on the bytes following its own common prefix, which gives
+    // more precision than the offset used for the whole index.
+    const size_t offset = commonPrefixLength(rangeFirst, rangeLast);
+    const uint64_t first = keyPosition(rangeFirst, offset);
+    const uint64_t span = keyPosition(rangeLast, offset) - first;
+
+    BSONObj prevKey = rangeFirstEntry->key.getOwned();
+    for (long long i = 1; i <= numSplits; i++) {
+        const double fraction = static_cast<double>(i) * keysPerRange / rangeEntries;
+        uint64_t splitPos = first + static_cast<uint64_t>(span * std::min(fraction, 1.0));
+
+        string posBytes = rangeFirst.substr(0, offset);
+        for (int shift = 56; shift >= 0; shift -= 8)
+            posBytes.push_back(static_cast<char>((splitPos >> shift) & 0xff));
+        pos.resetFromBuffer(posBytes.data(), posBytes.size());
+
+        // The position is not past rangeLast, so neither is the entry found.
+        auto entry = fwdCursor->seekRaw(pos);
+        if (!entry)
+            break;
+
+        // Skewed data may put several positions on the same key; keep it once.
+        if (entry->key.woCompare(prevKey) == 0)
+            continue;
+
+        prevKey = entry->key.getOwned();
+        splitKeys->push_back(prevKey);
+    }
+
+    return Status::OK();
+}
+
 bool KVDBIdxBase::isEmpty(OperationContext* opctx) {
     std::unique_ptr<SortedDataInterface::Cursor> cursor(newCursor(opctx, 1));
     const auto requestedInfo = Cursor::kJustExistance;
@@ -945,6 +1069,26 @@ Status KVDBUniqIdx::dupKeyCheck(OperationContext* opctx, const BSONObj& key, con
     return Status(ErrorCodes::DuplicateKey, dupKeyError(key));
 }
 
+StatusWith<RecordId> KVDBUniqIdx::prefetch(OperationContext* opctx, const BSONObj& key) const {
+    KeyString encodedKey(_keyStringVersion, key, _order);
+    std::string prefixedKey(makePrefixedKey(_prefix, encodedKey));
+    KVDBData pKey{(uint8_t*)prefixedKey.c_str(), prefixedKey.size()};
+
+    // Unbound point get, so no transaction is started just to warm the cache.
+    auto ru = KVDBRecoveryUnit::getKVDBRecoveryUnit(opctx);
+    KVDBData iVal{};
+    bool found = false;
+    auto hseSt = ru->getMCo(_idxKvs, pKey, iVal, found, false);
+    if (!hseSt.ok()) {
+        return hseToMongoStatus(hseSt);
+    } else if (!found || iVal.len() == 0) {
+        return RecordId();
+    }
+
+    BufReader br(iVal.data(), iVal.len());
+    return KeyString::decodeRecordId(&br);
+}
+
 std::unique_ptr<SortedDataInterface::Cursor> KVDBUniqIdx::newCursor(OperationContext* opctx,
                                                                     bool forward) const {
     return stdx::make_unique<KVDBIdxUniqCursor>(
@@ -1188,4 +1332,198 @@ void KVDBUniqBulkBuilder::_doInsert() {
 }
 
 /* End KVDBUniqBulkBuilder */
+
+/* Start KVDBClusteredIdCursor */
+KVDBClusteredIdCursor::KVDBClusteredIdCursor(OperationContext* opctx,
+                                             const KVDBClusteredRecordStore& rs,
+                                             bool forward)
+    : _opctx(opctx), _rs(rs), _forward(forward), _cursor(rs.getIdCursor(opctx, forward)) {}
+
+KVDBClusteredIdCursor::~KVDBClusteredIdCursor() {}
+
+void KVDBClusteredIdCursor::setEndPosition(const BSONObj& key, bool inclusive) {
+    _endKey = key.getOwned();
+    _endInclusive = inclusive;
+}
+
+boost::optional<IndexKeyEntry> KVDBClusteredIdCursor::next(RequestedInfo parts) {
+    if (_eof)
+        return {};
+
+    return _entry(_cursor->next(), parts);
+}
+
+boost::optional<IndexKeyEntry> KVDBClusteredIdCursor::seek(const BSONObj& key,
+                                                           bool inclusive,
+                                                           RequestedInfo parts) {
+    return _seek(key.firstElement(), inclusive, parts);
+}
+
+boost::optional<IndexKeyEntry> KVDBClusteredIdCursor::seek(const IndexSeekPoint& seekPoint,
+                                                           RequestedInfo parts) {
+    // The _id index has a single field, the seek point is either that field alone or its suffix.
+    if (seekPoint.prefixLen > 0)
+        return _seek(seekPoint.keyPrefix.firstElement(), !seekPoint.prefixExclusive, parts);
+
+    return _seek(*seekPoint.keySuffix[0], seekPoint.suffixInclusive[0], parts);
+}
+
+boost::optional<IndexKeyEntry> KVDBClusteredIdCursor::seekExact(const BSONObj& key,
+                                                                RequestedInfo parts) {
+    StatusWith<RecordId> loc = KVDBClusteredRecordStore::recordIdForId(key.firstElement());
+    if (!loc.isOK())
+        return {};
+
+    _eof = false;
+    if (parts & kWantKey)
+        return _entry(_cursor->seekExact(loc.getValue()), parts);
+
+    if (!_rs.recordExists(_opctx, loc.getValue()))
+        return {};
+
+    const int64_t step = _forward ? 1 : -1;
+    _cursor->seekAtOrPast(RecordId(loc.getValue().repr() + step));
+
+    return IndexKeyEntry(BSONObj(), loc.getValue());
+}
+
+void KVDBClusteredIdCursor::save() {
+    _cursor->save();
+}
+
+void KVDBClusteredIdCursor::saveUnpositioned() {
+    _cursor->saveUnpositioned();
+}
+
+void KVDBClusteredIdCursor::restore() {
+    _cursor->restore();
+}
+
+void KVDBClusteredIdCursor::detachFromOperationContext() {
+    _cursor->detachFromOperationContext();
+    _opctx = nullptr;
+}
+
+void KVDBClusteredIdCursor::reattachToOperationContext(OperationContext* opCtx) {
+    _opctx = opCtx;
+    _cursor->reattachToOperationContext(opCtx);
+}
+
+boost::optional<IndexKeyEntry> KVDBClusteredIdCursor::_seek(const BSONElement& key,
+                                                            bool inclusive,
+                                                            RequestedInfo parts) {
+    RecordId start = KVDBClusteredRecordStore::seekRecordIdForKey(key, inclusive, _forward);
+
+    _eof = start.isNull();
+    if (_eof)
+        return {};
+
+    _cursor->seekAtOrPast(start);
+
+    return _entry(_cursor->next(), parts);
+}
+
+boost::optional<IndexKeyEntry> KVDBClusteredIdCursor::_entry(const boost::optional<Record>& record,
+                                                             RequestedInfo parts) {
+    if (!record) {
+        _eof = true;
+        return {};
+    }
+
+    BSONObj key;
+    if ((parts & kWantKey) || !_endKey.isEmpty()) {
+        BSONObjBuilder b;
+        b.appendAs(record->data.toBson()["_id"], "");
+        key = b.obj();
+    }
+
+    if (_pastEnd(key)) {
+        _eof = true;
+        return {};
+    }
+
+    return IndexKeyEntry(std::move(key), record->id);
+}
+
+bool KVDBClusteredIdCursor::_pastEnd(const BSONObj& key) const {
+    if (_endKey.isEmpty())
+        return false;
+
+    int cmp = key.woCompare(_endKey, BSONObj(), false);
+    if (!_forward)
+        cmp = -cmp;
+
+    return _endInclusive ? cmp > 0 : cmp >= 0;
+}
+/* End KVDBClusteredIdCursor */
+
+/* Start KVDBClusteredIdIdx */
+KVDBClusteredIdIdx::KVDBClusteredIdIdx(const KVDBClusteredRecordStore& rs) : _rs(rs) {}
+
+SortedDataBuilderInterface* KVDBClusteredIdIdx::getBulkBuilder(OperationContext* opctx,
+                                                               bool dupsAllowed) {
+    return new KVDBClusteredIdBulkBuilder();
+}
+
+Status KVDBClusteredIdIdx::insert(OperationContext* opctx,
+                                  const BSONObj& key,
+                                  const RecordId& loc,
+                                  bool dupsAllowed) {
+    // The record store has already stored the document under its _id and rejected duplicates.
+    StatusWith<RecordId> idLoc = KVDBClusteredRecordStore::recordIdForId(key.firstElement());
+    invariantHse(idLoc.isOK() && idLoc.getValue() == loc);
+
+    return Status::OK();
+}
+
+void KVDBClusteredIdIdx::unindex(OperationContext* opctx,
+                                 const BSONObj& key,
+                                 const RecordId& loc,
+                                 bool dupsAllowed) {}
+
+Status KVDBClusteredIdIdx::dupKeyCheck(OperationContext* opctx,
+                                       const BSONObj& key,
+                                       const RecordId& loc) {
+    // Only the record 'loc' can hold the _id 'key'.
+    return Status::OK();
+}
+
+void KVDBClusteredIdIdx::fullValidate(OperationContext* opctx,
+                                      long long* numKeysOut,
+                                      ValidateResults* fullResults) const {
+    auto cursor = _rs.getIdCursor(opctx, true);
+    long long count = 0;
+
+    while (cursor->next())
+        count++;
+
+    if (numKeysOut)
+        *numKeysOut = count;
+}
+
+bool KVDBClusteredIdIdx::appendCustomStats(OperationContext* opctx,
+                                           BSONObjBuilder* output,
+                                           double scale) const {
+    output->append(KVDBClusteredRecordStore::kClusteredFieldName, true);
+    return true;
+}
+
+bool KVDBClusteredIdIdx::isEmpty(OperationContext* opctx) {
+    return !_rs.getIdCursor(opctx, true)->next();
+}
+
+std::unique_ptr<SortedDataInterface::Cursor> KVDBClusteredIdIdx::newCursor(OperationContext* opctx,
+                                                                           bool forward) const {
+    return stdx::make_unique<KVDBClusteredIdCursor>(opctx, _rs, forward);
+}
+/* End KVDBClusteredIdIdx */
+
+/* Start KVDBClusteredIdBulkBuilder */
+Status KVDBClusteredIdBulkBuilder::addKey(const BSONObj& key, const RecordId& loc) {
+    StatusWith<RecordId> idLoc = KVDBClusteredRecordStore::recordIdForId(key.firstElement());
+    invariantHse(idLoc.isOK() && idLoc.getValue() == loc);
+
+    return Status::OK();
+}
+/* End KVDBClusteredIdBulkBuilder */
 }  // namespace mongo
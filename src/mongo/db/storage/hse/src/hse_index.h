@@ -86,6 +86,15 @@ public:
 
     virtual void reattachToOperationContext(OperationContext* opCtx) final;
 
+    // Positions the cursor on the first entry at or after 'pos' in the cursor direction. 'pos'
+    // is a raw KeyString position and need not be a valid key. See estimateSplitKeys().
+    boost::optional<IndexKeyEntry> seekRaw(const KeyString& pos);
+
+    // The KeyString of the current entry, including the RecordId for standard indexes.
+    const KeyString& getKeyString() const {
+        return _key;
+    }
+
 protected:
     void _ensureCursor();
     void _destroyMCursor();
@@ -219,6 +228,13 @@ public:
 
     virtual long long getSpaceUsedBytes(OperationContext* opctx) const;
 
+    virtual Status estimateSplitKeys(OperationContext* opctx,
+                                     const BSONObj& startKey,
+                                     const BSONObj& endKey,
+                                     long long numEntries,
+                                     long long keysPerRange,
+                                     std::vector<BSONObj>* splitKeys) const;
+
     virtual Status initAsEmpty(OperationContext* opctx) {
         // Nothing to do here
         return Status::OK();
@@ -279,6 +295,8 @@ public:
 
     virtual Status dupKeyCheck(OperationContext* opctx, const BSONObj& key, const RecordId& loc);
 
+    virtual StatusWith<RecordId> prefetch(OperationContext* opctx, const BSONObj& key) const;
+
     virtual std::unique_ptr<SortedDataInterface::Cursor> newCursor(OperationContext* opctx,
                                                                    bool forward) const;
 
@@ -373,4 +391,126 @@ private:
     KeyString _keyString;
     std::vector<std::pair<RecordId, KeyString::TypeBits>> _records;
 };
+
+class KVDBClusteredRecordStore;
+class KVDBRecordStoreCursor;
+
+/**
+ * Cursor over the _id index of a clustered collection. The records of such a collection are kept
+ * in _id order, so the cursor walks the collection's own records and takes the keys from their
+ * _id fields.
+ */
+class KVDBClusteredIdCursor : public SortedDataInterface::Cursor {
+public:
+    KVDBClusteredIdCursor(OperationContext* opctx,
+                          const KVDBClusteredRecordStore& rs,
+                          bool forward);
+
+    virtual ~KVDBClusteredIdCursor();
+
+    virtual void setEndPosition(const BSONObj& key, bool inclusive) override;
+
+    virtual boost::optional<IndexKeyEntry> next(RequestedInfo parts = kKeyAndLoc) override;
+
+    virtual boost::optional<IndexKeyEntry> seek(const BSONObj& key,
+                                                bool inclusive,
+                                                RequestedInfo parts = kKeyAndLoc) override;
+
+    virtual boost::optional<IndexKeyEntry> seek(const IndexSeekPoint& seekPoint,
+                                                RequestedInfo parts = kKeyAndLoc) override;
+
+    // A single get of the record, or only a probe of its key when the key is not wanted.
+    virtual boost::optional<IndexKeyEntry> seekExact(const BSONObj& key,
+                                                     RequestedInfo parts = kKeyAndLoc) override;
+
+    virtual void save() override;
+
+    virtual void saveUnpositioned() override;
+
+    virtual void restore() override;
+
+    virtual void detachFromOperationContext() override;
+
+    virtual void reattachToOperationContext(OperationContext* opCtx) override;
+
+private:
+    boost::optional<IndexKeyEntry> _seek(const BSONElement& key,
+                                         bool inclusive,
+                                         RequestedInfo parts);
+
+    boost::optional<IndexKeyEntry> _entry(const boost::optional<Record>& record,
+                                          RequestedInfo parts);
+
+    bool _pastEnd(const BSONObj& key) const;
+
+    OperationContext* _opctx;
+    const KVDBClusteredRecordStore& _rs;
+    const bool _forward;
+    std::unique_ptr<KVDBRecordStoreCursor> _cursor;
+    bool _eof = false;
+
+    BSONObj _endKey;
+    bool _endInclusive = false;
+};
+
+/**
+ * The _id index of a clustered collection. It stores nothing: the records are keyed by their
+ * _id, so the record store enforces uniqueness and serves every lookup and scan of the index.
+ */
+class KVDBClusteredIdIdx : public SortedDataInterface {
+    MONGO_DISALLOW_COPYING(KVDBClusteredIdIdx);
+
+public:
+    explicit KVDBClusteredIdIdx(const KVDBClusteredRecordStore& rs);
+
+    virtual SortedDataBuilderInterface* getBulkBuilder(OperationContext* opctx,
+                                                       bool dupsAllowed) override;
+
+    virtual Status insert(OperationContext* opctx,
+                          const BSONObj& key,
+                          const RecordId& loc,
+                          bool dupsAllowed) override;
+
+    virtual void unindex(OperationContext* opctx,
+                         const BSONObj& key,
+                         const RecordId& loc,
+                         bool dupsAllowed) override;
+
+    virtual Status dupKeyCheck(OperationContext* opctx,
+                               const BSONObj& key,
+                               const RecordId& loc) override;
+
+    virtual void fullValidate(OperationContext* opctx,
+                              long long* numKeysOut,
+                              ValidateResults* fullResults) const override;
+
+    virtual bool appendCustomStats(OperationContext* opctx,
+                                   BSONObjBuilder* output,
+                                   double scale) const override;
+
+    virtual long long getSpaceUsedBytes(OperationContext* opctx) const override {
+        return 0;
+    }
+
+    virtual bool isEmpty(OperationContext* opctx) override;
+
+    virtual std::unique_ptr<SortedDataInterface::Cursor> newCursor(OperationContext* opctx,
+                                                                   bool forward) const override;
+
+    virtual Status initAsEmpty(OperationContext* opctx) override {
+        return Status::OK();
+    }
+
+private:
+    const KVDBClusteredRecordStore& _rs;
+};
+
+/**
+ * Bulk builds the _id index of a clustered collection, which only means checking that every key
+ * belongs to the record it is added for.
+ */
+class KVDBClusteredIdBulkBuilder : public SortedDataBuilderInterface {
+public:
+    Status addKey(const BSONObj& key, const RecordId& loc) override;
+};
 }  // namespace mongo
@@ -256,6 +256,88 @@ TEST(KVDBIndexTest, Isolation) {
     }
 }
 
+TEST(KVDBIndexTest, EstimateSplitKeys) {
+    const std::unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(false));
+
+    const int numKeys = 10000;
+    const int keysPerRange = 1000;
+
+    const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < numKeys; i++) {
+            ASSERT_OK(sorted->insert(
+                opCtx.get(), BSON("" << (numKeys + i) * 1000), RecordId(i + 1), true));
+        }
+        uow.commit();
+    }
+
+    // The keys are evenly spread, so the estimate should be close to the exact split points.
+    std::vector<BSONObj> splitKeys;
+    ASSERT_OK(sorted->estimateSplitKeys(opCtx.get(),
+                                        BSON("" << MINKEY),
+                                        BSON("" << MAXKEY),
+                                        numKeys,
+                                        keysPerRange,
+                                        &splitKeys));
+    ASSERT_GTE(splitKeys.size(), 8U);
+    ASSERT_LTE(splitKeys.size(), 10U);
+
+    for (size_t i = 0; i < splitKeys.size(); i++) {
+        const long long expected = (numKeys + (i + 1) * keysPerRange) * 1000LL;
+        const long long key = splitKeys[i].firstElement().numberLong();
+        ASSERT_LT(std::abs(key - expected), keysPerRange * 1000LL / 5);
+    }
+
+    // Half the range holds half the split points.
+    ASSERT_OK(sorted->estimateSplitKeys(opCtx.get(),
+                                        BSON("" << numKeys * 1000),
+                                        BSON("" << (numKeys + numKeys / 2) * 1000),
+                                        numKeys,
+                                        keysPerRange,
+                                        &splitKeys));
+    ASSERT_GTE(splitKeys.size(), 3U);
+    ASSERT_LTE(splitKeys.size(), 5U);
+    for (size_t i = 1; i < splitKeys.size(); i++)
+        ASSERT_LT(splitKeys[i - 1].woCompare(splitKeys[i]), 0);
+}
+
+TEST(KVDBIndexTest, PrefetchUnique) {
+    const std::unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(true, {{key1, loc1}, {key2, loc2}}));
+    const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+    ASSERT_EQ(loc1, unittest::assertGet(sorted->prefetch(opCtx.get(), key1)));
+    ASSERT_EQ(loc2, unittest::assertGet(sorted->prefetch(opCtx.get(), key2)));
+    ASSERT_TRUE(unittest::assertGet(sorted->prefetch(opCtx.get(), key3)).isNull());
+
+    // Prefetch reads outside of any transaction, so it only sees committed keys.
+    {
+        const ServiceContext::UniqueOperationContext t2(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(t2.get());
+        ASSERT_OK(sorted->insert(t2.get(), key3, loc3, false));
+        ASSERT_TRUE(unittest::assertGet(sorted->prefetch(opCtx.get(), key3)).isNull());
+        uow.commit();
+    }
+    ASSERT_EQ(loc3, unittest::assertGet(sorted->prefetch(opCtx.get(), key3)));
+
+    removeFromIndex(opCtx, sorted, {{key1, loc1}});
+    ASSERT_TRUE(unittest::assertGet(sorted->prefetch(opCtx.get(), key1)).isNull());
+    ASSERT_EQ(loc2, unittest::assertGet(sorted->prefetch(opCtx.get(), key2)));
+}
+
+TEST(KVDBIndexTest, PrefetchStandardNotSupported) {
+    const std::unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(false, {{key1, loc1}}));
+    const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+    ASSERT_EQUALS(ErrorCodes::CommandNotSupported,
+                  sorted->prefetch(opCtx.get(), key1).getStatus());
+}
+
 void testSeekExactRemoveNext(bool forward, bool unique) {
     auto harnessHelper = newHarnessHelper();
     auto opCtx = harnessHelper->newOperationContext();
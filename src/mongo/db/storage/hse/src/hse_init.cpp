@@ -31,13 +31,19 @@
  *    exception statement from all source files in the program, then also delete
  *    it in the license file.
  */
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
 #include "mongo/platform/basic.h"
 
+#include <boost/filesystem/operations.hpp>
+#include <functional>
+
 #include "mongo/base/init.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 #include "mongo/db/storage/storage_engine_metadata.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 
 #include "hse_engine.h"
@@ -67,8 +73,17 @@ public:
             formatVersion = kKVDBFormatVersion;
         }
 
-        auto engine =
-            new KVDBEngine(params.dbpath + "/hse", params.dur, formatVersion, params.readOnly);
+        const bool inMemory = kvdbGlobalOptions.getInMemory();
+        std::string home = params.dbpath + "/hse";
+        if (inMemory) {
+            // One KVDB per dbpath, so that several in-memory mongods can share the tmpfs.
+            const auto dbpath = boost::filesystem::absolute(params.dbpath).string();
+            home = str::stream() << kvdbGlobalOptions.getInMemoryPathStr() << "/mongo-hse-"
+                                 << std::hash<std::string>()(dbpath);
+            log() << "HSE: running in memory with KVDB home " << home;
+        }
+
+        auto engine = new KVDBEngine(home, params.dur, formatVersion, params.readOnly, inMemory);
 
         if (kvdbGlobalOptions.getMetricsEnabled()) {
             KVDBStat::enableStatsGlobally(true);
@@ -85,7 +100,7 @@ public:
     }
 
     virtual Status validateCollectionStorageOptions(const BSONObj& options) const {
-        return Status::OK();
+        return KVDBEngine::validateCollectionOptions(options);
     }
 
     virtual Status validateMetadata(const StorageEngineMetadata& metadata,
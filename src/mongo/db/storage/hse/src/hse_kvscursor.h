@@ -75,6 +75,15 @@ public:
 
     virtual Status restore();
 
+    // The read view this cursor was last bound to, as numbered by its owner.
+    uint64_t getViewId() const {
+        return _viewId;
+    }
+
+    void setViewId(uint64_t viewId) {
+        _viewId = viewId;
+    }
+
 protected:
     void _kvs_cursor_create(ClientTxn* lnkd_txn);
     int _read_kvs(bool& eof);
@@ -104,5 +113,7 @@ protected:
     // _kvs_val applies to the first chunk only.
     //
     size_t _kvs_vlen;
+
+    uint64_t _viewId{0};
 };
 }
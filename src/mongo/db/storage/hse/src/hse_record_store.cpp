@@ -39,8 +39,10 @@
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 #include <boost/thread/locks.hpp>
+#include <cmath>
 
 
 #include "hse_engine.h"
@@ -67,6 +69,7 @@ using hse::VALUE_META_THRESHOLD_LEN;
 using hse_stat::_hseAppBytesReadCounter;
 using hse_stat::_hseAppBytesWrittenCounter;
 using hse_stat::_hseOplogCursorCreateCounter;
+using hse_stat::_hseOplogCursorReadAheadCounter;
 using hse_stat::_hseOplogCursorReadRate;
 
 using mongo::BSONElement;
@@ -181,7 +184,8 @@ KVDBRecordStore::KVDBRecordStore(OperationContext* ctx,
       _ident(id.toString()),
       _dataSizeKeyKvs(KVDB_prefix + "datasize-" + _ident),
       _storageSizeKeyKvs(KVDB_prefix + "storagesize-" + _ident),
-      _numRecordsKeyKvs(KVDB_prefix + "numrecords-" + _ident) {
+      _numRecordsKeyKvs(KVDB_prefix + "numrecords-" + _ident),
+      _metadataKeyKvs(kMetadataKeyPrefix + _ident) {
 
     _prefixValBE = htobe32(_prefixVal);
 
@@ -191,18 +195,24 @@ KVDBRecordStore::KVDBRecordStore(OperationContext* ctx,
     _storageSizeKeyID = KVDBCounterMapUniqID.fetch_add(1);
     _numRecordsKeyID = KVDBCounterMapUniqID.fetch_add(1);
 
-    // When Mongodb rename a collection, it creates a second RecordStore (with a new namespace and
-    // same
-    // ident) before destroying the old one. The counters in the old recorstore needs to be flushed
-    // to
-    // media before loadCounters() below read them from media.
+    // When Mongodb renames a collection, it creates a second RecordStore (with a new namespace
+    // and same ident) before destroying the old one. The old record store flushes its metadata to
+    // media before _readMetadata() below reads it, so that metadata is current. So is the
+    // metadata the engine read at startup after a clean shutdown.
+    KVDBRecordStoreMetadata meta;
+    if (_counterManager.sync_for_rename(_ident)) {
+        meta.lastIdCurrent = _readMetadata(&meta);
+    } else if (!_counterManager.takeStartupMetadata(_ident, &meta)) {
+        _readMetadata(&meta);
+    }
 
-    _counterManager.sync_for_rename(_ident);
-    loadCounters();
+    _numRecords.store(meta.numRecords);
+    _dataSize.store(meta.dataSize);
+    _storageSize.store(meta.storageSize);
 
     _counterManager.registerRecordStore(this);
 
-    RecordId lastSeenId = this->_getLastId();
+    RecordId lastSeenId = meta.lastIdCurrent ? RecordId(meta.lastId) : this->_getLastId();
 
     _nextIdNum.store(lastSeenId.repr() + 1);
 }
@@ -221,8 +231,41 @@ KVDBRecordStore::~KVDBRecordStore() {
 
 // KVDBRecordStore - Metadata Methods
 
-void KVDBRecordStore::_readAndDecodeCounter(const std::string& keyString,
-                                            std::atomic<long long>& counter) {
+const std::string KVDBRecordStore::kMetadataKeyPrefix = KVDB_prefix + "rsmeta-";
+
+namespace {
+// numRecords, dataSize, storageSize and lastId, each as a big-endian 64-bit integer.
+const size_t kMetadataFields = 4;
+}  // namespace
+
+// static
+std::string KVDBRecordStore::encodeMetadata(const KVDBRecordStoreMetadata& meta) {
+    uint64_t fields[kMetadataFields] = {
+        endian::nativeToBig(static_cast<uint64_t>(meta.numRecords)),
+        endian::nativeToBig(static_cast<uint64_t>(meta.dataSize)),
+        endian::nativeToBig(static_cast<uint64_t>(meta.storageSize)),
+        endian::nativeToBig(static_cast<uint64_t>(meta.lastId))};
+
+    return std::string(reinterpret_cast<const char*>(fields), sizeof(fields));
+}
+
+// static
+bool KVDBRecordStore::decodeMetadata(const KVDBData& val, KVDBRecordStoreMetadata* meta) {
+    uint64_t fields[kMetadataFields];
+
+    if (val.len() != sizeof(fields))
+        return false;
+
+    memcpy(fields, val.data(), sizeof(fields));
+    meta->numRecords = endian::bigToNative(fields[0]);
+    meta->dataSize = endian::bigToNative(fields[1]);
+    meta->storageSize = endian::bigToNative(fields[2]);
+    meta->lastId = endian::bigToNative(fields[3]);
+
+    return true;
+}
+
+int64_t KVDBRecordStore::_readAndDecodeCounter(const std::string& keyString) {
     bool found;
 
     KVDBData key{keyString};
@@ -231,35 +274,45 @@ void KVDBRecordStore::_readAndDecodeCounter(const std::string& keyString,
 
     auto st = _db.kvs_get(_colKvs, 0, key, val, found);
     invariantHseSt(st);
-    if (!found) {
-        counter.store(0);
-    } else {
-        counter.store(endian::bigToNative(*(uint64_t*)val.data()));
-    }
-}
+    if (!found)
+        return 0;
 
-void KVDBRecordStore::loadCounters() {
-    _readAndDecodeCounter(_numRecordsKeyKvs, _numRecords);
-    _readAndDecodeCounter(_dataSizeKeyKvs, _dataSize);
-    _readAndDecodeCounter(_storageSizeKeyKvs, _storageSize);
+    return endian::bigToNative(*(uint64_t*)val.data());
 }
 
+bool KVDBRecordStore::_readMetadata(KVDBRecordStoreMetadata* meta) {
+    bool found;
 
-void KVDBRecordStore::_encodeAndWriteCounter(const std::string& keyString,
-                                             std::atomic<long long>& counter) {
-    uint64_t bigCtr = endian::nativeToBig(counter.load());
-    string valString = std::string(reinterpret_cast<const char*>(&bigCtr), sizeof(bigCtr));
-    KVDBData key{keyString};
-    KVDBData val = KVDBData{valString};
+    KVDBData key{_metadataKeyKvs};
+    KVDBData val{};
+    val.createOwned(kMetadataFields * sizeof(uint64_t));
 
-    auto st = _db.kvs_sub_txn_put(_colKvs, key, val);
+    auto st = _db.kvs_get(_colKvs, 0, key, val, found);
     invariantHseSt(st);
+    if (found && decodeMetadata(val, meta))
+        return true;
+
+    meta->numRecords = _readAndDecodeCounter(_numRecordsKeyKvs);
+    meta->dataSize = _readAndDecodeCounter(_dataSizeKeyKvs);
+    meta->storageSize = _readAndDecodeCounter(_storageSizeKeyKvs);
+
+    return false;
 }
 
 void KVDBRecordStore::updateCounters() {
-    _encodeAndWriteCounter(_numRecordsKeyKvs, _numRecords);
-    _encodeAndWriteCounter(_dataSizeKeyKvs, _dataSize);
-    _encodeAndWriteCounter(_storageSizeKeyKvs, _storageSize);
+    KVDBRecordStoreMetadata meta;
+
+    meta.numRecords = _numRecords.load();
+    meta.dataSize = _dataSize.load();
+    meta.storageSize = _storageSize.load();
+    meta.lastId = _nextIdNum.load() - 1;
+
+    string valString = encodeMetadata(meta);
+    KVDBData key{_metadataKeyKvs};
+    KVDBData val = KVDBData{valString};
+
+    auto st = _db.kvs_sub_txn_put(_colKvs, key, val);
+    invariantHseSt(st);
 }
 
 const char* KVDBRecordStore::name() const {
@@ -302,6 +355,26 @@ bool KVDBRecordStore::findRecord(OperationContext* opctx,
     return _baseFindRecord(opctx, &key, loc, out);
 }
 
+StatusWith<bool> KVDBRecordStore::prefetch(OperationContext* opctx, const RecordId& loc) const {
+    __attribute__((aligned(16))) struct KVDBRecordStoreKey key;
+    KVDBRecoveryUnit* ru = KVDBRecoveryUnit::getKVDBRecoveryUnit(opctx);
+    KVDBData val{};
+    bool found = false;
+
+    KRSK_CLEAR(key);
+    _setPrefix(&key, loc);
+    KRSK_SET_SUFFIX(key, loc.repr());
+    KVDBData compatKey{key.data, KRSK_KEY_LEN(key)};
+
+    // An unbound get of the first chunk brings the key and the head of the value into the HSE
+    // cache without starting a transaction. The chunks of a large value are left to the reader.
+    hse::Status st = ru->getMCo(_colKvs, compatKey, val, found, false);
+    if (!st.ok())
+        return hseToMongoStatus(st);
+
+    return found;
+}
+
 bool KVDBRecordStore::_baseFindRecord(OperationContext* opctx,
                                       struct KVDBRecordStoreKey* key,
                                       const RecordId& loc,
@@ -396,6 +469,42 @@ StatusWith<RecordId> KVDBRecordStore::insertRecord(OperationContext* opctx,
 }
 
 
+Status KVDBRecordStore::insertRecords(OperationContext* opctx,
+                                      std::vector<Record>* records,
+                                      bool enforceQuota) {
+    if (records->empty())
+        return Status::OK();
+
+    __attribute__((aligned(16))) struct KVDBRecordStoreKey key;
+    KRSK_CLEAR(key);
+    KRSK_SET_PREFIX(key, KRSK_RS_PREFIX(_prefixVal));
+
+    const int64_t nRecords = records->size();
+    const int64_t firstId = _nextIdNum.fetchAndAdd(nRecords);
+    int64_t totalLen = 0;
+
+    for (int64_t i = 0; i < nRecords; ++i) {
+        Record& record = (*records)[i];
+        uint32_t num_chunks;
+
+        record.id = RecordId(firstId + i);
+
+        hse::Status st =
+            _putKey(opctx, &key, record.id, record.data.data(), record.data.size(), &num_chunks);
+        if (!st.ok())
+            return hseToMongoStatus(st);
+
+        totalLen += record.data.size();
+    }
+
+    _changeNumRecords(opctx, nRecords);
+    _increaseDataStorageSizes(opctx, totalLen, totalLen);
+
+    _hseAppBytesWrittenCounter.add(totalLen);
+
+    return Status::OK();
+}
+
 StatusWith<RecordId> KVDBRecordStore::_baseInsertRecord(OperationContext* opctx,
                                                         struct KVDBRecordStoreKey* key,
                                                         RecordId loc,
@@ -420,7 +529,7 @@ Status KVDBRecordStore::insertRecordsWithDocWriter(OperationContext* opctx,
                                                    const DocWriter* const* docs,
                                                    size_t nDocs,
                                                    RecordId* idsOut) {
-    std::unique_ptr<Record[]> records(new Record[nDocs]);
+    std::vector<Record> records(nDocs);
 
     size_t totalSize = 0;
     for (size_t i = 0; i < nDocs; i++) {
@@ -439,13 +548,13 @@ Status KVDBRecordStore::insertRecordsWithDocWriter(OperationContext* opctx,
     }
     invariantHse(pos == (buffer.get() + totalSize));
 
-    for (size_t i = 0; i < nDocs; ++i) {
-        StatusWith<RecordId> s =
-            insertRecord(opctx, records[i].data.data(), records[i].data.size(), true);
-        if (!s.isOK())
-            return s.getStatus();
-        if (idsOut)
-            idsOut[i] = s.getValue();
+    Status s = insertRecords(opctx, &records, true);
+    if (!s.isOK())
+        return s;
+
+    if (idsOut) {
+        for (size_t i = 0; i < nDocs; ++i)
+            idsOut[i] = records[i].id;
     }
 
     return Status::OK();
@@ -715,9 +824,10 @@ hse::Status KVDBRecordStore::_putKey(OperationContext* opctx,
     KRSK_CLEAR(chunkKey);
     KRSK_CHUNK_COPY_MASTER(*key, chunkKey);
 
-    string value = std::string(reinterpret_cast<const char*>(&bigLen), sizeof(uint32_t)) +
-        std::string((const char*)data, VALUE_META_THRESHOLD_LEN);
-    KVDBData val{value};
+    std::unique_ptr<uint8_t[]> value(new uint8_t[VALUE_META_SIZE + VALUE_META_THRESHOLD_LEN]);
+    memcpy(value.get(), &bigLen, VALUE_META_SIZE);
+    memcpy(value.get() + VALUE_META_SIZE, data, VALUE_META_THRESHOLD_LEN);
+    KVDBData val{value.get(), (unsigned long)(VALUE_META_SIZE + VALUE_META_THRESHOLD_LEN)};
 
     hse::Status st = ru->put(_colKvs, compatKey, val);
     if (!st.ok())
@@ -749,13 +859,19 @@ hse::Status KVDBRecordStore::_putKey(OperationContext* opctx,
 }
 
 RecordId KVDBRecordStore::_getLastId() {
+    return lastIdInKvs(_colKvs, _prefixVal);
+}
+
+// static
+RecordId KVDBRecordStore::lastIdInKvs(KVSHandle& kvs, uint32_t prefix) {
     hse::Status st;
     RecordId lastId{};
+    uint32_t prefixBE = htobe32(prefix);
 
-    KVDBData compatKey{(uint8_t*)&_prefixValBE, sizeof(_prefixValBE)};
+    KVDBData compatKey{(uint8_t*)&prefixBE, sizeof(prefixBE)};
 
     // create a reverse cursor
-    KvsCursor* cursor = new KvsCursor(_colKvs, compatKey, false, 0);
+    KvsCursor* cursor = new KvsCursor(kvs, compatKey, false, 0);
 
     // get the last element, whatever it is
     KVDBData elKey{};
@@ -783,6 +899,241 @@ RecordId KVDBRecordStore::_nextId() {
 // End Implementation of KVDBRecordStore
 //
 
+//
+// Begin Implementation of KVDBClusteredRecordStore
+//
+
+namespace {
+// Doubles hold every integer up to 2^53 exactly, the _id range of a clustered collection is cut
+// down to that for double _ids.
+const double kMaxExactDouble = 9007199254740992.0;
+}  // namespace
+
+const char KVDBClusteredRecordStore::kClusteredFieldName[] = "clustered";
+const int64_t KVDBClusteredRecordStore::kIdBias;
+const int64_t KVDBClusteredRecordStore::kMinId;
+const int64_t KVDBClusteredRecordStore::kMaxId;
+
+KVDBClusteredRecordStore::KVDBClusteredRecordStore(OperationContext* ctx,
+                                                   StringData ns,
+                                                   StringData id,
+                                                   KVDB& db,
+                                                   KVSHandle& colKvs,
+                                                   KVSHandle& largeKvs,
+                                                   uint32_t prefix,
+                                                   KVDBDurabilityManager& durabilityManager,
+                                                   KVDBCounterManager& counterManager)
+    : KVDBRecordStore(
+          ctx, ns, id, db, colKvs, largeKvs, prefix, durabilityManager, counterManager) {
+    LOG(1) << "opening clustered collection " << ns;
+}
+
+KVDBClusteredRecordStore::~KVDBClusteredRecordStore() {}
+
+// static
+StatusWith<RecordId> KVDBClusteredRecordStore::recordIdForId(const BSONElement& id) {
+    bool isInteger = false;
+    int64_t val = 0;
+
+    if (id.type() == NumberInt || id.type() == NumberLong) {
+        isInteger = true;
+        val = id.numberLong();
+    } else if (id.type() == NumberDouble) {
+        double d = id.numberDouble();
+        isInteger = d >= -kMaxExactDouble && d <= kMaxExactDouble && d == std::trunc(d);
+        val = isInteger ? static_cast<int64_t>(d) : 0;
+    } else if (id.type() == NumberDecimal) {
+        // Fails with kInexact for a fraction and kInvalid for NaN, infinities and out of range.
+        uint32_t flags = Decimal128::SignalingFlag::kNoFlag;
+        val = id.numberDecimal().toLongExact(&flags);
+        isInteger = flags == Decimal128::SignalingFlag::kNoFlag;
+    }
+
+    if (!isInteger) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "clustered collections require an integer _id between "
+                                    << kMinId
+                                    << " and "
+                                    << kMaxId
+                                    << ", got "
+                                    << id.toString(false));
+    }
+
+    if (val < kMinId || val > kMaxId) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "_id " << val << " is out of the range of a clustered "
+                                    << "collection ["
+                                    << kMinId
+                                    << ", "
+                                    << kMaxId
+                                    << "]");
+    }
+
+    return RecordId(val + kIdBias);
+}
+
+// static
+RecordId KVDBClusteredRecordStore::seekRecordIdForKey(const BSONElement& key,
+                                                      bool inclusive,
+                                                      bool forward) {
+    const int numberType = canonicalizeBSONType(NumberInt);
+    const int keyType = key.canonicalType();
+    const bool isNaN = (key.type() == NumberDouble && std::isnan(key.numberDouble())) ||
+        (key.type() == NumberDecimal && key.numberDecimal().isNaN());
+    int64_t target;
+
+    // Keys of other types sort entirely before or after all the _ids, which are numbers, as does
+    // NaN which sorts before every other number.
+    if (keyType != numberType || isNaN) {
+        if (forward == (keyType <= numberType))
+            target = forward ? kMinId : kMaxId;
+        else
+            return RecordId();
+    } else if (key.type() == NumberInt || key.type() == NumberLong) {
+        // Clamp first so that the +1/-1 below cannot overflow.
+        int64_t val = std::min<int64_t>(kMaxId + 1, key.numberLong());
+        val = std::max<int64_t>(kMinId - 1, val);
+        if (forward)
+            target = inclusive ? val : val + 1;
+        else
+            target = inclusive ? val : val - 1;
+    } else if (key.type() == NumberDecimal) {
+        // Rounded exactly, as a decimal can sit closer to an integer than any double does.
+        const Decimal128 minKey(static_cast<int64_t>(kMinId - 1));
+        const Decimal128 maxKey(static_cast<int64_t>(kMaxId + 1));
+        Decimal128 val = key.numberDecimal();
+        if (val.isLess(minKey))
+            val = minKey;
+        else if (val.isGreater(maxKey))
+            val = maxKey;
+        const int64_t floorVal = val.toLong(Decimal128::kRoundTowardNegative);
+        const int64_t ceilVal = val.toLong(Decimal128::kRoundTowardPositive);
+        if (forward)
+            target = inclusive ? ceilVal : floorVal + 1;
+        else
+            target = inclusive ? floorVal : ceilVal - 1;
+    } else {
+        double val = std::min(double(kMaxId + 1), key.numberDouble());
+        val = std::max(double(kMinId - 1), val);
+        if (forward)
+            val = inclusive ? std::ceil(val) : std::floor(val) + 1;
+        else
+            val = inclusive ? std::floor(val) : std::ceil(val) - 1;
+        target = static_cast<int64_t>(val);
+    }
+
+    if (forward) {
+        if (target > kMaxId)
+            return RecordId();
+        target = std::max(target, kMinId);
+    } else {
+        if (target < kMinId)
+            return RecordId();
+        target = std::min(target, kMaxId);
+    }
+
+    return RecordId(target + kIdBias);
+}
+
+bool KVDBClusteredRecordStore::recordExists(OperationContext* opctx, const RecordId& loc) const {
+    __attribute__((aligned(16))) struct KVDBRecordStoreKey key;
+    KVDBRecoveryUnit* ru = KVDBRecoveryUnit::getKVDBRecoveryUnit(opctx);
+    bool found = false;
+
+    KRSK_CLEAR(key);
+    KRSK_SET_PREFIX(key, KRSK_RS_PREFIX(_prefixVal));
+    KRSK_SET_SUFFIX(key, loc.repr());
+
+    KVDBData compatKey{key.data, KRSK_KEY_LEN(key)};
+    hse::Status st = ru->probeKey(_colKvs, compatKey, found);
+    invariantHseSt(st);
+
+    return found;
+}
+
+std::unique_ptr<KVDBRecordStoreCursor> KVDBClusteredRecordStore::getIdCursor(
+    OperationContext* opctx, bool forward) const {
+    return stdx::make_unique<KVDBRecordStoreCursor>(
+        opctx, _db, _colKvs, _largeKvs, _prefixVal, forward);
+}
+
+// The probe doubles as the uniqueness check of the _id index, which has no keys of its own.
+// Two transactions inserting the same _id both write the same record key, and the second one to
+// write gets a write conflict.
+StatusWith<RecordId> KVDBClusteredRecordStore::_recordIdForInsert(OperationContext* opctx,
+                                                                  const char* data) const {
+    BSONElement id = BSONObj(data)["_id"];
+    if (id.eoo())
+        return Status(ErrorCodes::BadValue, "documents of a clustered collection require an _id");
+
+    StatusWith<RecordId> loc = recordIdForId(id);
+    if (!loc.isOK())
+        return loc;
+
+    if (recordExists(opctx, loc.getValue())) {
+        return Status(ErrorCodes::DuplicateKey,
+                      str::stream() << "E11000 duplicate key error collection: " << ns()
+                                    << " index: _id_ dup key: { : "
+                                    << id.toString(false)
+                                    << " }");
+    }
+
+    return loc;
+}
+
+StatusWith<RecordId> KVDBClusteredRecordStore::insertRecord(OperationContext* opctx,
+                                                            const char* data,
+                                                            int len,
+                                                            bool enforceQuota) {
+    __attribute__((aligned(16))) struct KVDBRecordStoreKey key;
+
+    StatusWith<RecordId> loc = _recordIdForInsert(opctx, data);
+    if (!loc.isOK())
+        return loc;
+
+    KRSK_CLEAR(key);
+    KRSK_SET_PREFIX(key, KRSK_RS_PREFIX(_prefixVal));
+    return _baseInsertRecord(opctx, &key, loc.getValue(), data, len);
+}
+
+Status KVDBClusteredRecordStore::insertRecords(OperationContext* opctx,
+                                               std::vector<Record>* records,
+                                               bool enforceQuota) {
+    __attribute__((aligned(16))) struct KVDBRecordStoreKey key;
+    int64_t totalLen = 0;
+
+    KRSK_CLEAR(key);
+    KRSK_SET_PREFIX(key, KRSK_RS_PREFIX(_prefixVal));
+
+    for (auto& record : *records) {
+        uint32_t num_chunks;
+
+        // The probe runs in the same transaction, so it also catches _ids repeated in the batch.
+        StatusWith<RecordId> loc = _recordIdForInsert(opctx, record.data.data());
+        if (!loc.isOK())
+            return loc.getStatus();
+        record.id = loc.getValue();
+
+        hse::Status st =
+            _putKey(opctx, &key, record.id, record.data.data(), record.data.size(), &num_chunks);
+        if (!st.ok())
+            return hseToMongoStatus(st);
+
+        totalLen += record.data.size();
+    }
+
+    _changeNumRecords(opctx, records->size());
+    _increaseDataStorageSizes(opctx, totalLen, totalLen);
+
+    _hseAppBytesWrittenCounter.add(totalLen);
+
+    return Status::OK();
+}
+
+//
+// End Implementation of KVDBClusteredRecordStore
+//
+
 //
 // Begin Implementation of KVDBCappedRecordStore
 //
@@ -811,11 +1162,17 @@ KVDBCappedRecordStore::KVDBCappedRecordStore(OperationContext* ctx,
     invariantHse(_cappedMaxSize > 0);
     invariantHse(_cappedMaxDocs == -1 || _cappedMaxDocs > 0);
 
-    _cappedVisMgr->updateHighestSeen(this->_getLastId());
+    _cappedVisMgr->setHighestSeen(RecordId(_nextIdNum.load() - 1));
 }
 
 KVDBCappedRecordStore::~KVDBCappedRecordStore() {}
 
+Status KVDBCappedRecordStore::insertRecords(OperationContext* opctx,
+                                            std::vector<Record>* records,
+                                            bool enforceQuota) {
+    return RecordStore::insertRecords(opctx, records, enforceQuota);
+}
+
 StatusWith<RecordId> KVDBCappedRecordStore::insertRecord(OperationContext* opctx,
                                                          const char* data,
                                                          int len,
@@ -1551,6 +1908,13 @@ boost::optional<Record> KVDBRecordStoreCursor::seekExact(const RecordId& id) {
     return {{id, {(const char*)_seekVal.data() + offset, static_cast<int>(dataLen)}}};
 }
 
+void KVDBRecordStoreCursor::seekAtOrPast(const RecordId& id) {
+    // next() resumes from the record after _lastPos.
+    _eof = false;
+    _lastPos = RecordId(_forward ? id.repr() - 1 : id.repr() + 1);
+    _needSeek = true;
+}
+
 void KVDBRecordStoreCursor::save() {}
 
 void KVDBRecordStoreCursor::saveUnpositioned() {
@@ -1576,7 +1940,7 @@ void KVDBRecordStoreCursor::reattachToOperationContext(OperationContext* opctx)
 
 hse::Status KVDBRecordStoreCursor::_currCursorRead(
     KVDBRecoveryUnit* ru, KvsCursor* cursor, KVDBData& elKey, KVDBData& elVal, bool& eof) {
-    return ru->cursorRead(cursor, elKey, elVal, _eof);
+    return ru->cursorRead(cursor, elKey, elVal, eof);
 }
 
 bool KVDBRecordStoreCursor::_currIsHidden(const RecordId& loc) {
@@ -1690,7 +2054,7 @@ KVDBCappedRecordStoreCursor::~KVDBCappedRecordStoreCursor() {}
 // virtual
 hse::Status KVDBCappedRecordStoreCursor::_currCursorRead(
     KVDBRecoveryUnit* ru, KvsCursor* cursor, KVDBData& elKey, KVDBData& elVal, bool& eof) {
-    return ru->cursorRead(cursor, elKey, elVal, _eof);
+    return ru->cursorRead(cursor, elKey, elVal, eof);
 }
 
 // virtual
@@ -1761,6 +2125,8 @@ void KVDBCappedRecordStoreCursor::_packKey(struct KVDBRecordStoreKey* key,
 //    only thread writing, it can be assured its snapshot isn't missing commits from other
 //    writing threads).
 // In our implementation, the cursor runs unbound and is decoupled from an opctx's transaction.
+const size_t KVDBOplogStoreCursor::kReadAheadInitialBytes;
+
 KVDBOplogStoreCursor::KVDBOplogStoreCursor(OperationContext* opctx,
                                            KVDB& db,
                                            KVSHandle& colKvs,
@@ -1771,7 +2137,9 @@ KVDBOplogStoreCursor::KVDBOplogStoreCursor(OperationContext* opctx,
                                            shared_ptr<KVDBOplogBlockManager> opBlkMgr)
     : KVDBCappedRecordStoreCursor(opctx, db, colKvs, largeKvs, prefix, forward, cappedVisMgr),
       _readUntilForOplog(RecordId()),
-      _opBlkMgr{opBlkMgr} {
+      _opBlkMgr{opBlkMgr},
+      _readAheadMaxBytes(forward ? kvdbGlobalOptions.getOplogReadAheadBytes() : 0),
+      _readAheadBatchBytes(std::min(kReadAheadInitialBytes, _readAheadMaxBytes)) {
     _hseOplogCursorCreateCounter.add();
 }
 
@@ -1781,11 +2149,16 @@ bool KVDBOplogStoreCursor::restore() {
     // The cursor (should one exist) needs to be updated to the latest read snapshot.
     _needUpdate = true;
 
+    // Records following _lastPos are only ever removed by a truncate from the end of the oplog;
+    // reclaiming old blocks can't remove them while _lastPos itself is still present.
+    if (_cappedVisMgr.getTruncateEpoch() != _readAheadTruncateEpoch)
+        _clearReadAhead();
+
     // An oplog cursor must be able to see everything committed so far. Use an unbound get.
     // There may already be an active txn in this recovery unit. Do not bind to it.
     // Check whether the key we seeked to last is still present.
     if (_lastPos.isNormal()) {
-        if (!seekExact(_lastPos))
+        if (!_seekExact(_lastPos))
             return false;
     }
 
@@ -1793,6 +2166,13 @@ bool KVDBOplogStoreCursor::restore() {
 }
 
 boost::optional<Record> KVDBOplogStoreCursor::seekExact(const RecordId& id) {
+    _clearReadAhead();
+    _readAheadBatchBytes = std::min(kReadAheadInitialBytes, _readAheadMaxBytes);
+
+    return _seekExact(id);
+}
+
+boost::optional<Record> KVDBOplogStoreCursor::_seekExact(const RecordId& id) {
     __attribute__((aligned(16))) struct KVDBRecordStoreKey key;
     hse::Status st;
 
@@ -1839,9 +2219,20 @@ void KVDBOplogStoreCursor::_reallySeek(const RecordId& id) {
 }
 
 boost::optional<Record> KVDBOplogStoreCursor::next() {
+    // Records already buffered were read before the cursor reached its end.
+    if (_readAheadPos < _readAhead.size())
+        return _nextReadAhead();
+
     if (_eof)
         return {};
 
+    if (_readAheadEof) {
+        _clearReadAhead();
+        _eof = true;
+
+        return {};
+    }
+
     // [HSE_REVISIT] Note that oplog cursor creation is deferred until next().
     // This may mean that an optime returned by seekExact (unbound get) is no
     // longer present in the newly created cursor read snapshot. Later optimes
@@ -1864,9 +2255,86 @@ boost::optional<Record> KVDBOplogStoreCursor::next() {
     // It must set use_txn to false and use unbound gets in order for it to be able to
     // see all the values committed so far in time. There may already be an active txn
     // in this recovery unit. Do not bind to it. We don't know what the txn can see.
+    if (_readAheadMaxBytes) {
+        _fillReadAhead();
+
+        return next();
+    }
+
     return _curr(false);
 }
 
+void KVDBOplogStoreCursor::_fillReadAhead() {
+    __attribute__((aligned(16))) struct KVDBRecordStoreKey key;
+    hse::Status st;
+
+    KVDBRecoveryUnit* ru = KVDBRecoveryUnit::getKVDBRecoveryUnit(_opctx);
+    bool eof = false;
+
+    _clearReadAhead();
+    _readAheadTruncateEpoch = _cappedVisMgr.getTruncateEpoch();
+    _hseOplogCursorReadAheadCounter.add();
+
+    // The cursor view ends at _readUntilForOplog, the visibility boundary when the cursor was
+    // created or last updated, so everything read here is committed and durable.
+    while (_readAheadBuf.size() < _readAheadBatchBytes) {
+        KVDBData elKey{};
+        KVDBData elVal{};
+
+        st = _currCursorRead(ru, _mCursor, elKey, elVal, eof);
+        invariantHseSt(st);
+        if (eof)
+            break;
+
+        RecordId loc = _recordIdFromKey(elKey);
+        if (_currIsHidden(loc)) {
+            eof = true;
+            break;
+        }
+
+        if (_getNumChunks(_getValueLength(elVal))) {
+            // Large values are read through the get interface, unbound like the cursor.
+            KRSK_CLEAR(key);
+            _krskSetPrefixFromKey(key, elKey);
+            bool found = _getKey(_opctx, &key, _colKvs, _largeKvs, loc, _largeVal, false);
+            invariantHse(found);
+            elVal = _largeVal;
+        }
+
+        unsigned int offset = _getValueOffset(elVal);
+        int dataLen = elVal.len() - offset;
+
+        invariantHse(_getValueLength(elVal) == static_cast<unsigned int>(dataLen));
+
+        const char* data = (const char*)elVal.data() + offset;
+        _readAhead.push_back({loc, _readAheadBuf.size(), dataLen});
+        _readAheadBuf.insert(_readAheadBuf.end(), data, data + dataLen);
+
+        _hseAppBytesReadCounter.add(dataLen);
+    }
+
+    // The cursor has moved past everything buffered, which is consumed before it is used again.
+    _readAheadEof = eof;
+
+    if (!eof)
+        _readAheadBatchBytes = std::min(_readAheadBatchBytes * 2, _readAheadMaxBytes);
+}
+
+boost::optional<Record> KVDBOplogStoreCursor::_nextReadAhead() {
+    const ReadAheadEntry& entry = _readAhead[_readAheadPos++];
+
+    _lastPos = entry.id;
+
+    return {{entry.id, {_readAheadBuf.data() + entry.offset, entry.len}}};
+}
+
+void KVDBOplogStoreCursor::_clearReadAhead() {
+    _readAhead.clear();
+    _readAheadBuf.clear();
+    _readAheadPos = 0;
+    _readAheadEof = false;
+}
+
 KvsCursor* KVDBOplogStoreCursor::_getMCursor() {
     KVDBRecoveryUnit* ru = KVDBRecoveryUnit::getKVDBRecoveryUnit(_opctx);
     hse::Status st;
@@ -1900,7 +2368,7 @@ KvsCursor* KVDBOplogStoreCursor::_getMCursor() {
 hse::Status KVDBOplogStoreCursor::_currCursorRead(
     KVDBRecoveryUnit* ru, KvsCursor* cursor, KVDBData& elKey, KVDBData& elVal, bool& eof) {
     _hseOplogCursorReadRate.update(1);
-    return _opBlkMgr->cursorRead(ru, cursor, elKey, elVal, _eof);
+    return _opBlkMgr->cursorRead(ru, cursor, elKey, elVal, eof);
 }
 
 // virtual
@@ -1947,129 +2415,253 @@ void KVDBOplogStoreCursor::_packKey(struct KVDBRecordStoreKey* key,
 
 KVDBCappedVisibilityManager::KVDBCappedVisibilityManager(KVDBCappedRecordStore& crs,
                                                          KVDBDurabilityManager& durabilityManager)
-    : _crs(crs), _durabilityManager(durabilityManager), _oplog_highestSeen(RecordId()) {
+    : _crs(crs),
+      _durabilityManager(durabilityManager),
+      _ticketRing(new TicketSlot[kTicketRingSize]) {
     _durable = _durabilityManager.isDurable();
     _forceLag = static_cast<int64_t>(_durabilityManager.getForceLag()) << 32;
 }
 
 KVDBCappedVisibilityManager::~KVDBCappedVisibilityManager() {}
 
+namespace {
+
+// Moves bound forward to value, never backward. Returns true if bound changed.
+bool raiseBound(AtomicInt64& bound, int64_t value) {
+    int64_t curr = bound.load();
+
+    while (curr < value) {
+        const int64_t prev = bound.compareAndSwap(curr, value);
+        if (prev == curr)
+            return true;
+        curr = prev;
+    }
+
+    return false;
+}
+
+}  // namespace
+
 void KVDBCappedVisibilityManager::addUncommittedRecord(OperationContext* opctx,
                                                        const RecordId& record) {
-    stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-
-    _addUncommittedRecord_inlock(opctx, record);
+    _addUncommittedRecord(opctx, record);
 }
 
-void KVDBCappedVisibilityManager::_addUncommittedRecord_inlock(OperationContext* opctx,
-                                                               const RecordId& record) {
-    dassert(_uncommittedRecords.empty() || _uncommittedRecords.back() < record);
-    SortedRecordIds::iterator it = _uncommittedRecords.insert(_uncommittedRecords.end(), record);
+uint64_t KVDBCappedVisibilityManager::_addUncommittedRecord(OperationContext* opctx,
+                                                            const RecordId& record) {
+    const uint64_t ticket = _nextTicket.fetchAndAdd(1);
+
+    // Raise the highest seen record only after taking the ticket, so that anyone who reads the
+    // new value also sees the ticket as outstanding.
+    raiseBound(_oplog_highestSeen, record.repr());
+
+    if (ticket < _oldestTicket.load() + kTicketRingSize) {
+        // The previous owner of the slot was retired, but a committer that is behind may still
+        // look at the slot; invalidate it before reusing it.
+        TicketSlot& slot = _ticketRing[ticket % kTicketRingSize];
+        slot.registered.store(0);
+        slot.id.store(record.repr());
+        slot.registered.store(ticket + 1);
+    } else {
+        stdx::lock_guard<stdx::mutex> lk(_overflowMutex);
+        _overflowTickets[ticket] = std::make_pair(record.repr(), false);
+        _numOverflowTickets.fetchAndAdd(1);
+    }
 
-    opctx->recoveryUnit()->registerChange(new KVDBCappedInsertChange(_crs, *this, it));
-    _oplog_highestSeen = record;
+    opctx->recoveryUnit()->registerChange(new KVDBCappedInsertChange(_crs, *this, ticket));
+
+    return ticket;
 }
 
 RecordId KVDBCappedVisibilityManager::getNextAndAddUncommitted(OperationContext* opctx,
                                                                std::function<RecordId()> nextId) {
-    stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
+    stdx::lock_guard<stdx::mutex> lk(_nextIdMutex);
     RecordId record = nextId();
 
-    _addUncommittedRecord_inlock(opctx, record);
+    _addUncommittedRecord(opctx, record);
 
     return record;
 }
 
+bool KVDBCappedVisibilityManager::_readTicket(uint64_t ticket, int64_t* id, bool* retired) const {
+    const TicketSlot& slot = _ticketRing[ticket % kTicketRingSize];
+
+    if (slot.registered.load() == ticket + 1) {
+        *id = slot.id.load();
+        *retired = (slot.retired.load() == ticket + 1);
+
+        // The slot may have been reused by a later ticket while we were reading it.
+        return (slot.registered.load() == ticket + 1);
+    }
+
+    if (_numOverflowTickets.load() == 0)
+        return false;
+
+    stdx::lock_guard<stdx::mutex> lk(_overflowMutex);
+    auto it = _overflowTickets.find(ticket);
+    if (it == _overflowTickets.end())
+        return false;
+
+    *id = it->second.first;
+    *retired = it->second.second;
+
+    return true;
+}
+
+bool KVDBCappedVisibilityManager::_noUncommittedRecords() const {
+    // _oldestTicket never passes _nextTicket, read the latter first.
+    const uint64_t next = _nextTicket.load();
+
+    return (_oldestTicket.load() == next);
+}
+
 void KVDBCappedVisibilityManager::durableCallback(int64_t newPersistBoundary) {
-    if (newPersistBoundary > _persistBoundary) {
-        _uncommittedRecordIdsMutex.lock();
-        if ((newPersistBoundary <= _commitBoundary) && (newPersistBoundary > _persistBoundary)) {
-            // The oldest record yet to be persisted has moved forward i.e. there may be new oplog
-            // records available to be read by waiting cursors (unless oplog records were removed
-            // during aborts).
-            _persistBoundary = newPersistBoundary;
+    if (newPersistBoundary > _persistBoundary.load()) {
+        // The oldest record yet to be persisted has moved forward i.e. there may be new oplog
+        // records available to be read by waiting cursors (unless oplog records were removed
+        // during aborts).
+        if (newPersistBoundary > _commitBoundary.load() ||
+            !raiseBound(_persistBoundary, newPersistBoundary)) {
+            // Nothing new became visible; don't wake up tailing cursors for nothing.
+            return;
         }
-        _uncommittedRecordIdsMutex.unlock();
 
-        _opsBecameVisibleCV.notify_all();
+        _notifyOpsBecameVisible();
+    }
+}
 
-        // Notify any capped callback waiters (tailable oplog cursors) that there is new
-        // data available.
-        stdx::lock_guard<stdx::mutex> cappedCallbackLock(_crs._cappedCallbackMutex);
-        if (_crs._cappedCallback) {
-            _crs._cappedCallback->notifyCappedWaitersIfNeeded();
-        }
+void KVDBCappedVisibilityManager::_notifyOpsBecameVisible() {
+    if (_opsBecameVisibleWaiters.load() > 0) {
+        // Waiters check their predicate under the mutex, taking it here makes sure none of them
+        // misses the notification.
+        stdx::lock_guard<stdx::mutex> lk(_opsBecameVisibleMutex);
+        _opsBecameVisibleCV.notify_all();
     }
+
+    // Notify any capped callback waiters (tailable oplog cursors) that there is new
+    // data available.
+    stdx::lock_guard<stdx::mutex> cappedCallbackLock(_crs._cappedCallbackMutex);
+
+    if (_crs._cappedCallback)
+        _crs._cappedCallback->notifyCappedWaitersIfNeeded();
 }
 
 void KVDBCappedVisibilityManager::waitForAllOplogWritesToBeVisible(OperationContext* opctx) const {
     invariantHse(opctx->lockState()->isNoop() || !opctx->lockState()->inAWriteUnitOfWork());
 
-    stdx::unique_lock<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-    const auto waitingFor = _oplog_highestSeen;
+    stdx::unique_lock<stdx::mutex> lk(_opsBecameVisibleMutex);
+    _opsBecameVisibleWaiters.fetchAndAdd(1);
+    ON_BLOCK_EXIT([&] { _opsBecameVisibleWaiters.fetchAndSubtract(1); });
+
+    const RecordId waitingFor(_oplog_highestSeen.load());
 
     opctx->waitForConditionOrInterrupt(_opsBecameVisibleCV, lk, [&] {
-        return (_uncommittedRecords.empty() && (_commitBoundary == _persistBoundary)) ||
-            (RecordId(_persistBoundary) > waitingFor);
+        return (_noUncommittedRecords() &&
+                (_commitBoundary.load() == _persistBoundary.load())) ||
+            (RecordId(_persistBoundary.load()) > waitingFor);
     });
 }
 
-void KVDBCappedVisibilityManager::dealtWithCappedRecord(SortedRecordIds::iterator it) {
-    // At the time of a transaction commit or abort, remove capped records
-    // that were mutated by this transaction. They may not be durable.
-    // commitBoundary tracks the smallest outstanding record (for oplog records).
-
-    bool notify = false;
-
-    _uncommittedRecordIdsMutex.lock();
+void KVDBCappedVisibilityManager::dealtWithCappedRecord(uint64_t ticket) {
+    // At the time of a transaction commit or abort, retire the capped record that was mutated
+    // by this transaction. It may not be durable.
+    TicketSlot& slot = _ticketRing[ticket % kTicketRingSize];
 
-    int64_t newBound;
-    _uncommittedRecords.erase(it);
-    if (!_uncommittedRecords.empty()) {
-        newBound = _uncommittedRecords.front().repr();
+    if (slot.registered.load() == ticket + 1) {
+        slot.retired.store(ticket + 1);
     } else {
-        newBound = _oplog_highestSeen.repr() + 1;
+        stdx::lock_guard<stdx::mutex> lk(_overflowMutex);
+        auto it = _overflowTickets.find(ticket);
+        invariantHse(it != _overflowTickets.end());
+        it->second.second = true;
     }
 
-    dassert(_commitBoundary <= newBound);
-    if (_commitBoundary < newBound) {
-        _commitBoundary = newBound;
-        // If journaling is disabled, the journalFlusher thread doesn't run.
-        // Move the _persistBoundary forward, if necessary.
-        if (_crs.isOplog() && !_durable) {
-            dassert(newBound > _persistBoundary);
-            _persistBoundary = newBound;
-            notify = true;
+    _advanceCommitBoundary();
+}
+
+void KVDBCappedVisibilityManager::_advanceCommitBoundary() {
+    // commitBoundary tracks the smallest outstanding record (for oplog records). Every thread
+    // retires its own ticket before scanning, so the thread retiring the oldest outstanding
+    // ticket sees all the later ones that were retired before it.
+    while (true) {
+        const int64_t highestSeen = _oplog_highestSeen.load();
+        const uint64_t next = _nextTicket.load();
+        const uint64_t oldest = _oldestTicket.load();
+
+        uint64_t ticket = oldest;
+        int64_t lastRetired = 0;
+        int64_t newBound = 0;
+        bool pending = false;
+
+        for (; ticket < next; ticket++) {
+            int64_t id;
+            bool retired;
+
+            if (!_readTicket(ticket, &id, &retired))
+                break;
+
+            if (!retired) {
+                newBound = id;
+                pending = true;
+                break;
+            }
+
+            lastRetired = id;
         }
-    }
 
-    _uncommittedRecordIdsMutex.unlock();
+        // The oldest record is still outstanding, its owner moves the boundary later on.
+        if (ticket == oldest)
+            return;
 
-    if (notify) {
-        _opsBecameVisibleCV.notify_all();
+        if (!pending) {
+            // The ticket following the retired ones is either not issued or not published yet;
+            // its record is past every retired record.
+            newBound = lastRetired + 1;
+            if (ticket == next)
+                newBound = std::max(newBound, highestSeen + 1);
+        }
+
+        // Publish the commit boundary before the oldest ticket, readers that find no
+        // uncommitted records rely on the boundary being up to date.
+        if (raiseBound(_commitBoundary, newBound) && _crs.isOplog() && !_durable) {
+            // If journaling is disabled, the journalFlusher thread doesn't run.
+            // Move the _persistBoundary forward, if necessary.
+            if (raiseBound(_persistBoundary, newBound))
+                _notifyOpsBecameVisible();
+        }
 
-        // Notify any capped callback waiters (tailable oplog cursors) that there is new
-        // data available.
-        stdx::lock_guard<stdx::mutex> cappedCallbackLock(_crs._cappedCallbackMutex);
+        if (_oldestTicket.compareAndSwap(oldest, ticket) != oldest)
+            continue;
 
-        if (_crs._cappedCallback)
-            _crs._cappedCallback->notifyCappedWaitersIfNeeded();
+        if (_numOverflowTickets.load() > 0) {
+            stdx::lock_guard<stdx::mutex> lk(_overflowMutex);
+            auto end = _overflowTickets.lower_bound(ticket);
+            for (auto it = _overflowTickets.begin(); it != end;) {
+                it = _overflowTickets.erase(it);
+                _numOverflowTickets.fetchAndSubtract(1);
+            }
+        }
+
+        return;
     }
 }
 
 int64_t KVDBCappedVisibilityManager::getCommitBoundary() {
-    return _commitBoundary;
+    return _commitBoundary.load();
 }
 
 int64_t KVDBCappedVisibilityManager::getPersistBoundary() {
-    stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
+    const int64_t highestSeen = _oplog_highestSeen.load();
+    const bool noUncommitted = _noUncommittedRecords();
+    const int64_t commitBoundary = _commitBoundary.load();
+    const int64_t persistBoundary = _persistBoundary.load();
 
     int64_t bound;
 
-    if (_uncommittedRecords.empty() && (_commitBoundary == _persistBoundary))
-        bound = _oplog_highestSeen.repr() + 1;
+    if (noUncommitted && (commitBoundary == persistBoundary))
+        bound = highestSeen + 1;
     else
-        bound = _persistBoundary;
+        bound = persistBoundary;
 
     if (bound <= _forceLag)
         return 0;
@@ -2079,35 +2671,27 @@ int64_t KVDBCappedVisibilityManager::getPersistBoundary() {
 
 bool KVDBCappedVisibilityManager::isCappedHidden(const RecordId& record) const {
     // This is used only for non oplog collections.
-    stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-
-    if (_uncommittedRecords.empty())
+    if (_noUncommittedRecords())
         return false;
 
-    return _uncommittedRecords.front() <= record;
+    return (record.repr() >= _commitBoundary.load());
 }
 
 void KVDBCappedVisibilityManager::updateHighestSeen(const RecordId& record) {
-    if (record > _oplog_highestSeen) {
-        stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-
-        if (record > _oplog_highestSeen)
-            _oplog_highestSeen = record;
-    }
+    raiseBound(_oplog_highestSeen, record.repr());
 }
 
 void KVDBCappedVisibilityManager::setHighestSeen(const RecordId& record) {
-    // This is called during truncates to rollback oplog records.
-    _uncommittedRecordIdsMutex.lock();
-    _oplog_highestSeen = record;
-    _commitBoundary = _persistBoundary = record.repr() + 1;
-    _uncommittedRecordIdsMutex.unlock();
+    // This is called when opening the collection and during truncates to rollback oplog
+    // records, with no inserts in flight.
+    _oplog_highestSeen.store(record.repr());
+    _commitBoundary.store(record.repr() + 1);
+    _persistBoundary.store(record.repr() + 1);
+    _truncateEpoch.fetchAndAdd(1);
 }
 
 RecordId KVDBCappedVisibilityManager::getHighestSeen() {
-    stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-
-    return _oplog_highestSeen;
+    return RecordId(_oplog_highestSeen.load());
 }
 
 //
@@ -2120,15 +2704,15 @@ RecordId KVDBCappedVisibilityManager::getHighestSeen() {
 
 KVDBCappedInsertChange::KVDBCappedInsertChange(KVDBCappedRecordStore& crs,
                                                KVDBCappedVisibilityManager& cappedVisibilityManager,
-                                               SortedRecordIds::iterator it)
-    : _crs(crs), _cappedVisMgr(cappedVisibilityManager), _it(it) {}
+                                               uint64_t ticket)
+    : _crs(crs), _cappedVisMgr(cappedVisibilityManager), _ticket(ticket) {}
 
 void KVDBCappedInsertChange::commit() {
-    _cappedVisMgr.dealtWithCappedRecord(_it);
+    _cappedVisMgr.dealtWithCappedRecord(_ticket);
 }
 
 void KVDBCappedInsertChange::rollback() {
-    _cappedVisMgr.dealtWithCappedRecord(_it);
+    _cappedVisMgr.dealtWithCappedRecord(_ticket);
     stdx::lock_guard<stdx::mutex> lk(_crs._cappedCallbackMutex);
     if (_crs._cappedCallback) {
         _crs._cappedCallback->notifyCappedWaitersIfNeeded();
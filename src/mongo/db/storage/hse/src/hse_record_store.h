@@ -35,6 +35,7 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -70,8 +71,6 @@ using mongo::StringData;
 
 namespace mongo {
 
-typedef std::list<RecordId> SortedRecordIds;
-
 //
 // There are three classes that together implement the "record store" portion of the hse
 // storage engine: KVDBRecordStore, KVDBCappedRecordStore, and KVDBOplogStore.  The
@@ -85,6 +84,10 @@ typedef std::list<RecordId> SortedRecordIds;
 // details. Such a structure is dubious on its face, but wholly unsuited to implementing an
 // performance aggressive oplog - which is critical to performance in a replica set.
 //
+// KVDBClusteredRecordStore is a second public subclass of KVDBRecordStore. It derives each
+// RecordId from the document's integer _id instead of a counter, so the records are stored in _id
+// order and the _id index of the collection (KVDBClusteredIdIdx) needs no keys of its own.
+//
 
 class KVDBRecordStore : public RecordStore {
     MONGO_DISALLOW_COPYING(KVDBRecordStore);
@@ -125,6 +128,8 @@ public:
     //
     virtual bool findRecord(OperationContext* txn, const RecordId& loc, RecordData* out) const;
 
+    virtual StatusWith<bool> prefetch(OperationContext* txn, const RecordId& loc) const;
+
     virtual void deleteRecord(OperationContext* txn, const RecordId& dl);
 
     virtual StatusWith<RecordId> insertRecord(OperationContext* txn,
@@ -132,6 +137,11 @@ public:
                                               int len,
                                               bool enforceQuota);
 
+    // Reserves the RecordIds of the whole batch at once and updates the counters once per batch.
+    virtual Status insertRecords(OperationContext* txn,
+                                 std::vector<Record>* records,
+                                 bool enforceQuota);
+
     virtual Status insertRecordsWithDocWriter(OperationContext* txn,
                                               const DocWriter* const* docs,
                                               size_t nDocs,
@@ -204,7 +214,15 @@ public:
     }
 
     void updateCounters();  // write counters to kvdb
-    void loadCounters();    // read counters from kvdb
+
+    // The counters and the last RecordId of the record store on an ident are kept in a single
+    // metadata record, stored in the record store's kvs under kMetadataKeyPrefix + ident.
+    static const std::string kMetadataKeyPrefix;
+    static std::string encodeMetadata(const KVDBRecordStoreMetadata& meta);
+    static bool decodeMetadata(const KVDBData& val, KVDBRecordStoreMetadata* meta);
+
+    // Returns the last RecordId stored under 'prefix' in 'kvs', found with a reverse cursor.
+    static RecordId lastIdInKvs(KVSHandle& kvs, uint32_t prefix);
 
     void overTake() {
         _overTaken = true;
@@ -235,6 +253,10 @@ protected:
                                   bool noLenChange,
                                   bool* lenChangeFailure);
 
+    // Reads the metadata record from kvdb, or the separate counters written by older versions.
+    // Returns false if there is no metadata record.
+    bool _readMetadata(KVDBRecordStoreMetadata* meta);
+
     void _changeNumRecords(OperationContext* txn, int64_t amount);
     void _increaseDataStorageSizes(OperationContext* txn, int64_t damount, int64_t samount);
     void _resetNumRecords(OperationContext* txn);
@@ -283,13 +305,13 @@ protected:
     const std::string _dataSizeKeyKvs;
     const std::string _storageSizeKeyKvs;
     const std::string _numRecordsKeyKvs;
+    const std::string _metadataKeyKvs;
 
     unsigned long _dataSizeKeyID;
     unsigned long _storageSizeKeyID;
     unsigned long _numRecordsKeyID;
 
-    void _encodeAndWriteCounter(const std::string& keyString, std::atomic<long long>& counter);
-    void _readAndDecodeCounter(const std::string& keyString, std::atomic<long long>& counter);
+    int64_t _readAndDecodeCounter(const std::string& keyString);
 
     bool _shuttingDown{false};
     bool _hasBackgroundThread;
@@ -331,6 +353,67 @@ protected:
 };
 
 
+class KVDBRecordStoreCursor;
+
+class KVDBClusteredRecordStore : public KVDBRecordStore {
+    MONGO_DISALLOW_COPYING(KVDBClusteredRecordStore);
+
+public:
+    // Clustered collections are created with {storageEngine: {hse: {clustered: true}}}.
+    static const char kClusteredFieldName[];
+
+    // Range of the _id values a clustered collection accepts. The _id v is stored under
+    // RecordId(v + kIdBias), which keeps negative _ids in order and every RecordId normal.
+    static const int64_t kIdBias = 1LL << 62;
+    static const int64_t kMinId = 1 - kIdBias;
+    static const int64_t kMaxId = kIdBias - 2;
+
+    KVDBClusteredRecordStore(OperationContext* ctx,
+                             StringData ns,
+                             StringData id,
+                             KVDB& db,
+                             KVSHandle& colKvs,
+                             KVSHandle& largeKvs,
+                             uint32_t prefix,
+                             KVDBDurabilityManager& durabilityManager,
+                             KVDBCounterManager& counterManager);
+
+    virtual ~KVDBClusteredRecordStore();
+
+    /* virtual */ StatusWith<RecordId> insertRecord(OperationContext* opctx,
+                                                    const char* data,
+                                                    int len,
+                                                    bool enforceQuota);
+
+    /* virtual */ Status insertRecords(OperationContext* opctx,
+                                     std::vector<Record>* records,
+                                     bool enforceQuota);
+
+    /**
+     * Returns the RecordId of the document whose _id is 'id'. Only integral numbers between
+     * kMinId and kMaxId (and doubles and decimals that hold such an integer exactly) are valid
+     * _ids.
+     */
+    static StatusWith<RecordId> recordIdForId(const BSONElement& id);
+
+    /**
+     * Returns the RecordId a scan from the _id index key 'key' starts at: the first (forward) or
+     * last (reverse) RecordId whose _id sorts on the 'inclusive' side of 'key'. Returns a null
+     * RecordId when no valid _id does.
+     */
+    static RecordId seekRecordIdForKey(const BSONElement& key, bool inclusive, bool forward);
+
+    // Returns whether a record is stored under 'loc', without reading its value.
+    bool recordExists(OperationContext* opctx, const RecordId& loc) const;
+
+    std::unique_ptr<KVDBRecordStoreCursor> getIdCursor(OperationContext* opctx,
+                                                       bool forward) const;
+
+private:
+    StatusWith<RecordId> _recordIdForInsert(OperationContext* opctx, const char* data) const;
+};
+
+
 class KVDBCappedVisibilityManager;
 class KVDBCappedInsertChange;
 
@@ -357,6 +440,11 @@ public:
                                                     int len,
                                                     bool enforceQuota);
 
+    // Capped inserts go one record at a time through the visibility manager and capped deletes.
+    /* virtual */ Status insertRecords(OperationContext* opctx,
+                                     std::vector<Record>* records,
+                                     bool enforceQuota);
+
     /* virtual */ Status updateRecord(OperationContext* txn,
                                       const RecordId& oldLocation,
                                       const char* data,
@@ -417,10 +505,6 @@ protected:
 
     RecordId _cappedOldestKeyHint{0};
     unique_ptr<KVDBCappedVisibilityManager> _cappedVisMgr;
-
-
-    std::string _ident;
-    AtomicInt64 _nextIdNum;
 };
 
 class KVDBOplogStore : public KVDBCappedRecordStore {
@@ -532,14 +616,14 @@ class KVDBCappedInsertChange : public RecoveryUnit::Change {
 public:
     KVDBCappedInsertChange(KVDBCappedRecordStore& rs,
                            KVDBCappedVisibilityManager& cappedVisibilityManager,
-                           SortedRecordIds::iterator it);
+                           uint64_t ticket);
     virtual void commit();
     virtual void rollback();
 
 private:
     KVDBCappedRecordStore& _crs;
     KVDBCappedVisibilityManager& _cappedVisMgr;
-    const SortedRecordIds::iterator _it;
+    const uint64_t _ticket;
 };
 
 class KVDBRecordStoreCursor : public SeekableRecordCursor {
@@ -557,6 +641,12 @@ public:
 
     virtual boost::optional<Record> seekExact(const RecordId& id);
 
+    /**
+     * Positions the cursor so that the next call to next() returns the first record at or after
+     * 'id' (at or before 'id' for a reverse cursor).
+     */
+    void seekAtOrPast(const RecordId& id);
+
     void save() final;
 
     void saveUnpositioned() final;
@@ -675,6 +765,13 @@ public:
     }
 
 private:
+    // One entry of the read-ahead buffer. The record data lives in _readAheadBuf.
+    struct ReadAheadEntry {
+        RecordId id;
+        size_t offset;
+        int len;
+    };
+
     // virtual
     hse::Status _currCursorRead(
         KVDBRecoveryUnit* ru, KvsCursor* cursor, KVDBData& elKey, KVDBData& elVal, bool& eof);
@@ -687,20 +784,48 @@ private:
     // virtual
     void _packKey(struct KVDBRecordStoreKey* key, uint32_t prefix, const RecordId& loc);
 
+    boost::optional<Record> _seekExact(const RecordId& id);
+
+    // Reads the visible records following the cursor position into the read-ahead buffer, up to
+    // _readAheadBatchBytes.
+    void _fillReadAhead();
+    boost::optional<Record> _nextReadAhead();
+    void _clearReadAhead();
+
     RecordId _readUntilForOplog;
     shared_ptr<KVDBOplogBlockManager> _opBlkMgr{};
+
+    // Forward cursors read the oplog in bulk, up to the visibility boundary, and serve next()
+    // from this buffer. Tailing readers such as the oplog fetcher then cost one pass over the
+    // KVS cursor per batch instead of one read per entry. The first fill is small, so that
+    // short reads and single lookups don't pay for a full buffer, and each fill after a full one
+    // doubles up to _readAheadMaxBytes.
+    static const size_t kReadAheadInitialBytes = 64 * 1024;
+    const size_t _readAheadMaxBytes;
+    size_t _readAheadBatchBytes;
+    std::vector<ReadAheadEntry> _readAhead{};
+    std::vector<char> _readAheadBuf{};
+    size_t _readAheadPos{0};
+    bool _readAheadEof{false};
+
+    // Truncate epoch of the visibility manager when the buffer was filled. A rollback truncate
+    // may remove buffered records, so the buffer is dropped if the epoch changes.
+    uint64_t _readAheadTruncateEpoch{0};
 };
 
 class KVDBCappedVisibilityManager {
 public:
     KVDBCappedVisibilityManager(KVDBCappedRecordStore& rs,
                                 KVDBDurabilityManager& durabilityManager);
-    void dealtWithCappedRecord(SortedRecordIds::iterator it);
+    void dealtWithCappedRecord(uint64_t ticket);
     void updateHighestSeen(const RecordId& record);
     void setHighestSeen(const RecordId& record);
     RecordId getHighestSeen();
     int64_t getCommitBoundary();
     int64_t getPersistBoundary();
+
+    // Callers must register records in increasing RecordId order. For the oplog this is
+    // guaranteed by the caller generating optimes under its own mutex.
     void addUncommittedRecord(OperationContext* opctx, const RecordId& record);
 
     // a bit hacky function, but does the job
@@ -708,29 +833,73 @@ public:
 
     bool isCappedHidden(const RecordId& record) const;
 
+    // Bumped whenever records are truncated from the end of the oplog. See setHighestSeen().
+    uint64_t getTruncateEpoch() const {
+        return _truncateEpoch.load();
+    }
+
     void waitForAllOplogWritesToBeVisible(OperationContext* opctx) const;
     void durableCallback(int64_t newPersistBoundary);
     virtual ~KVDBCappedVisibilityManager();
 
 private:
-    void _addUncommittedRecord_inlock(OperationContext* opctx, const RecordId& record);
+    // Uncommitted records are tracked by ticket, their registration order, in a ring of
+    // kTicketRingSize slots. Registering, committing and aborting a record only touch the
+    // record's own slot; the thread that retires the oldest ticket moves _oldestTicket and the
+    // commit boundary forward with compare-and-swap. No mutex is taken on the insert path.
+    static const uint64_t kTicketRingSize = 4096;
+
+    struct TicketSlot {
+        // ticket + 1 once id holds the record of that ticket, 0 while the slot is reused.
+        AtomicUInt64 registered;
+        AtomicInt64 id;
+        // ticket + 1 once the record of that ticket committed or aborted.
+        AtomicUInt64 retired;
+    };
+
+    uint64_t _addUncommittedRecord(OperationContext* opctx, const RecordId& record);
+
+    // Returns false if the ticket has not been published yet.
+    bool _readTicket(uint64_t ticket, int64_t* id, bool* retired) const;
+
+    void _advanceCommitBoundary();
+    void _notifyOpsBecameVisible();
+    bool _noUncommittedRecords() const;
 
-    // protects the state
-    mutable stdx::mutex _uncommittedRecordIdsMutex;
     KVDBCappedRecordStore& _crs;
     KVDBDurabilityManager& _durabilityManager;
-    SortedRecordIds _uncommittedRecords;
-    RecordId _oplog_highestSeen;
-    bool _shuttingDown{false};
     bool _durable;
     int64_t _forceLag;
 
+    std::unique_ptr<TicketSlot[]> _ticketRing;
+
+    // All tickets < _oldestTicket have committed/aborted.
+    AtomicUInt64 _oldestTicket{0};
+    AtomicUInt64 _nextTicket{0};
+
+    // Tickets that were issued while their ring slot still belonged to an uncommitted record.
+    // Only a unit of work holding more than kTicketRingSize uncommitted records ends up here.
+    mutable stdx::mutex _overflowMutex;
+    std::map<uint64_t, std::pair<int64_t, bool>> _overflowTickets;
+    AtomicUInt64 _numOverflowTickets{0};
+
+    // Serializes RecordId allocation with ticket allocation in getNextAndAddUncommitted().
+    stdx::mutex _nextIdMutex;
+
+    AtomicInt64 _oplog_highestSeen{0};
+
     // All records < _commitBoundary have committed/aborted.
     // All records < _persistBoundary have been synced.
     // _persistBoundary <= _commitBoundary
-    volatile int64_t _commitBoundary{1};
-    volatile int64_t _persistBoundary{1};
+    AtomicInt64 _commitBoundary{1};
+    AtomicInt64 _persistBoundary{1};
+
+    AtomicUInt64 _truncateEpoch{0};
 
+    // Only waitForAllOplogWritesToBeVisible() takes this mutex; writers signal the condition
+    // variable only while somebody is waiting.
+    mutable stdx::mutex _opsBecameVisibleMutex;
+    mutable AtomicUInt32 _opsBecameVisibleWaiters{0};
     mutable stdx::condition_variable _opsBecameVisibleCV;
 };
 
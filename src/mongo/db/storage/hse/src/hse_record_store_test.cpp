@@ -41,10 +41,13 @@
 
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/timer.h"
 
 #include "hse_impl.h"
+#include "hse_index.h"
 #include "hse_record_store.h"
 #include "hse_recovery_unit.h"
 #include "hse_ut_common.h"
@@ -129,6 +132,20 @@ public:
         }
     }
 
+    std::unique_ptr<KVDBClusteredRecordStore> newClusteredRecordStore() {
+        auto opCtx = newOperationContext();
+
+        return stdx::make_unique<KVDBClusteredRecordStore>(opCtx.get(),
+                                                           "foo.clustered",
+                                                           "1",
+                                                           _db,
+                                                           _colKvs,
+                                                           _largeKvs,
+                                                           _prefix,
+                                                           *_durabilityManager.get(),
+                                                           *_counterManager.get());
+    }
+
     RecoveryUnit* newRecoveryUnit() final {
         return new KVDBRecoveryUnit(_db, *_counterManager.get(), *_durabilityManager.get());
     }
@@ -339,6 +356,209 @@ std::string random_string(size_t length) {
     return str;
 }
 
+TEST(KVDBRecordStoreTest, PinnedReadViewAcrossYields) {
+    std::unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    std::unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    RecordId loc1;
+    RecordId loc2;
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        loc1 = uassertStatusOK(rs->insertRecord(opCtx.get(), "a", 2, false));
+        loc2 = uassertStatusOK(rs->insertRecord(opCtx.get(), "b", 2, false));
+        uow.commit();
+    }
+
+    ServiceContext::UniqueOperationContext reader(harnessHelper->newOperationContext());
+    auto ru = KVDBRecoveryUnit::getKVDBRecoveryUnit(reader.get());
+    ru->setPinnedReadViewMaxAgeMS(60 * 1000);
+
+    auto cursor = rs->getCursor(reader.get());
+    auto record = cursor->next();
+    ASSERT(record);
+    ASSERT_EQ(loc1, record->id);
+    const SnapshotId snapshotId = ru->getSnapshotId();
+
+    cursor->save();
+    ru->abandonSnapshot();
+    ASSERT(ru->isReadViewPinned());
+
+    // A write made while the reader is yielded is not visible through the pinned view.
+    {
+        auto client2 = harnessHelper->serviceContext()->makeClient("c2");
+        auto opCtx = harnessHelper->newOperationContext(client2.get());
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecord(opCtx.get(), "c", 2, false).getStatus());
+        uow.commit();
+    }
+
+    ASSERT(cursor->restore());
+    ASSERT(ru->getSnapshotId() == snapshotId);
+    record = cursor->next();
+    ASSERT(record);
+    ASSERT_EQ(loc2, record->id);
+    ASSERT(!cursor->next());
+
+    // Once the reader starts a unit of work its view is released on the next yield.
+    {
+        WriteUnitOfWork uow(reader.get());
+    }
+    ASSERT(cursor->restore());
+    ASSERT(!cursor->next());
+    cursor->save();
+    ru->abandonSnapshot();
+    ASSERT(!ru->isReadViewPinned());
+    ASSERT(ru->getSnapshotId() != snapshotId);
+}
+
+namespace {
+StatusWith<RecordId> insertDoc(OperationContext* opCtx, RecordStore* rs, const BSONObj& doc) {
+    return rs->insertRecord(opCtx, doc.objdata(), doc.objsize(), false);
+}
+}  // namespace
+
+TEST(KVDBRecordStoreTest, ClusteredRecordIdsFollowId) {
+    KVDBRecordStoreHarnessHelper harnessHelper;
+    std::unique_ptr<KVDBClusteredRecordStore> rs(harnessHelper.newClusteredRecordStore());
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(insertDoc(opCtx.get(), rs.get(), BSON("_id" << 3)).getStatus());
+        ASSERT_OK(insertDoc(opCtx.get(), rs.get(), BSON("_id" << -1LL)).getStatus());
+        ASSERT_OK(insertDoc(opCtx.get(), rs.get(), BSON("_id" << 2.0)).getStatus());
+
+        // The same _id as another numeric type, a string and a fraction are all rejected.
+        ASSERT_EQ(ErrorCodes::DuplicateKey,
+                  insertDoc(opCtx.get(), rs.get(), BSON("_id" << 3LL)).getStatus());
+        ASSERT_EQ(ErrorCodes::BadValue,
+                  insertDoc(opCtx.get(), rs.get(), BSON("_id"
+                                                        << "a"))
+                      .getStatus());
+        ASSERT_EQ(ErrorCodes::BadValue,
+                  insertDoc(opCtx.get(), rs.get(), BSON("_id" << 2.5)).getStatus());
+
+        // An integral decimal maps to the same _id exactly, however many digits it carries.
+        ASSERT_EQ(ErrorCodes::DuplicateKey,
+                  insertDoc(opCtx.get(), rs.get(), BSON("_id" << Decimal128("3.000")))
+                      .getStatus());
+        ASSERT_EQ(ErrorCodes::BadValue,
+                  insertDoc(opCtx.get(), rs.get(), BSON("_id" << Decimal128("2.0000000000000001")))
+                      .getStatus());
+
+        uow.commit();
+    }
+
+    {
+        // An _id repeated within a batch is a duplicate too.
+        WriteUnitOfWork uow(opCtx.get());
+        std::vector<BSONObj> docs{BSON("_id" << 10), BSON("_id" << 10)};
+        std::vector<Record> records;
+        for (auto& doc : docs)
+            records.push_back({RecordId(), RecordData(doc.objdata(), doc.objsize())});
+        ASSERT_EQ(ErrorCodes::DuplicateKey, rs->insertRecords(opCtx.get(), &records, false));
+    }
+
+    ASSERT_EQ(3, rs->numRecords(opCtx.get()));
+    ASSERT_EQ(KVDBClusteredRecordStore::recordIdForId(BSON("" << 2).firstElement()).getValue(),
+              KVDBClusteredRecordStore::recordIdForId(BSON("" << 2.0).firstElement()).getValue());
+
+    // The records are stored in _id order.
+    auto cursor = rs->getCursor(opCtx.get());
+    for (long long id : {-1, 2, 3}) {
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQ(id, record->data.toBson()["_id"].numberLong());
+        ASSERT_EQ(KVDBClusteredRecordStore::recordIdForId(BSON("" << id).firstElement()).getValue(),
+                  record->id);
+    }
+    ASSERT(!cursor->next());
+}
+
+TEST(KVDBRecordStoreTest, ClusteredIdIndexCursor) {
+    KVDBRecordStoreHarnessHelper harnessHelper;
+    std::unique_ptr<KVDBClusteredRecordStore> rs(harnessHelper.newClusteredRecordStore());
+    KVDBClusteredIdIdx idx(*rs);
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        for (int id : {1, 3, 5, 7})
+            ASSERT_OK(insertDoc(opCtx.get(), rs.get(), BSON("_id" << id)).getStatus());
+        uow.commit();
+    }
+
+    ASSERT(!idx.isEmpty(opCtx.get()));
+    long long numKeys = 0;
+    idx.fullValidate(opCtx.get(), &numKeys, nullptr);
+    ASSERT_EQ(4, numKeys);
+
+    auto cursor = idx.newCursor(opCtx.get(), true);
+
+    // Seeks between, on and beyond the _ids, and keys of other types.
+    ASSERT_BSONOBJ_EQ(BSON("" << 3), cursor->seek(BSON("" << 2.5), true)->key);
+    ASSERT_BSONOBJ_EQ(BSON("" << 5), cursor->seek(BSON("" << 3), false)->key);
+    ASSERT_BSONOBJ_EQ(BSON("" << 7), cursor->next()->key);
+    ASSERT(!cursor->next());
+    ASSERT(!cursor->seek(BSON("" << 8), true));
+    ASSERT(!cursor->seek(BSON(""
+                              << "a"),
+                         true));
+    ASSERT_BSONOBJ_EQ(BSON("" << 1), cursor->seek(BSON("" << MINKEY), true)->key);
+
+    cursor->setEndPosition(BSON("" << 5), false);
+    ASSERT_BSONOBJ_EQ(BSON("" << 3), cursor->seek(BSON("" << 2), true)->key);
+    ASSERT(!cursor->next());
+
+    auto reverse = idx.newCursor(opCtx.get(), false);
+    ASSERT_BSONOBJ_EQ(BSON("" << 5), reverse->seek(BSON("" << 6), true)->key);
+    ASSERT_BSONOBJ_EQ(BSON("" << 3), reverse->next()->key);
+    ASSERT_BSONOBJ_EQ(BSON("" << 7), reverse->seek(BSON("" << MAXKEY), true)->key);
+
+    // seekExact finds the record by its _id, with or without reading it.
+    auto entry = cursor->seekExact(BSON("" << 7.0), SortedDataInterface::Cursor::kWantLoc);
+    ASSERT(entry);
+    ASSERT_EQ(KVDBClusteredRecordStore::recordIdForId(BSON("" << 7).firstElement()).getValue(),
+              entry->loc);
+    ASSERT_BSONOBJ_EQ(BSON("" << 1), cursor->seekExact(BSON("" << 1))->key);
+    ASSERT(!cursor->seekExact(BSON("" << 2)));
+
+    // Decimals are matched and rounded exactly, not through a double.
+    ASSERT_BSONOBJ_EQ(BSON("" << 5), cursor->seekExact(BSON("" << Decimal128("5.00")))->key);
+    ASSERT(!cursor->seekExact(BSON("" << Decimal128("5.0000000000000000001"))));
+    ASSERT(!cursor->seekExact(BSON("" << Decimal128::kPositiveInfinity)));
+    ASSERT_BSONOBJ_EQ(BSON("" << 7),
+                      cursor->seek(BSON("" << Decimal128("5.0000000000000000001")), true)->key);
+    ASSERT_BSONOBJ_EQ(BSON("" << 5),
+                      reverse->seek(BSON("" << Decimal128("6.9999999999999999999")), true)->key);
+}
+
+// Two units of work inserting the same _id both pass the existence probe, as neither sees the
+// other's write, and the second to write the record gets a write conflict.
+TEST(KVDBRecordStoreTest, ClusteredInsertSameIdConflicts) {
+    KVDBRecordStoreHarnessHelper harnessHelper;
+    std::unique_ptr<KVDBClusteredRecordStore> rs(harnessHelper.newClusteredRecordStore());
+
+    {
+        ServiceContext::UniqueOperationContext t1(harnessHelper.newOperationContext());
+        auto client2 = harnessHelper.serviceContext()->makeClient("c2");
+        auto t2 = harnessHelper.newOperationContext(client2.get());
+
+        WriteUnitOfWork w1(t1.get());
+        WriteUnitOfWork w2(t2.get());
+
+        ASSERT_OK(insertDoc(t1.get(), rs.get(), BSON("_id" << 20)).getStatus());
+        ASSERT_THROWS(insertDoc(t2.get(), rs.get(), BSON("_id" << 20LL)), WriteConflictException);
+
+        w1.commit();
+    }
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+    ASSERT_EQ(1, rs->numRecords(opCtx.get()));
+}
+
 TEST(KVDBRecordStoreTest, Chunker) {
     std::unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
     std::unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
@@ -472,6 +692,112 @@ TEST(KVDBRecordStoreTest, Chunker) {
     } /* for */
 }
 
+TEST(KVDBRecordStoreTest, InsertRecordsBatch) {
+    std::unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    std::unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int numBatches = 200;
+    const int batchSize = 64;
+    const string value = random_string(200);
+    const string largeValue = random_string(VALUE_META_THRESHOLD_LEN + 10);
+
+    long long singleMicros = 0;
+    long long batchMicros = 0;
+    long long numRecords = 0;
+    long long length = 0;
+
+    // Insert the same documents once through insertRecord and once through insertRecords, and
+    // compare how long both take.
+    for (int pass = 0; pass < 2; pass++) {
+        const bool batched = (pass == 1);
+
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        Timer timer;
+        for (int b = 0; b < numBatches; b++) {
+            std::vector<Record> records;
+            for (int i = 0; i < batchSize; i++) {
+                // Make one record of each batch large enough to be chunked.
+                const string& data = (i == 0) ? largeValue : value;
+                records.push_back({RecordId(), RecordData(data.c_str(), data.size())});
+                length += data.size();
+            }
+
+            WriteUnitOfWork uow(opCtx.get());
+            if (batched) {
+                ASSERT_OK(rs->insertRecords(opCtx.get(), &records, false));
+            } else {
+                for (auto& record : records) {
+                    StatusWith<RecordId> res = rs->insertRecord(
+                        opCtx.get(), record.data.data(), record.data.size(), false);
+                    ASSERT_OK(res.getStatus());
+                    record.id = res.getValue();
+                }
+            }
+            uow.commit();
+
+            // The RecordIds of a batch are allocated in order.
+            for (int i = 1; i < batchSize; i++)
+                ASSERT_LT(records[i - 1].id, records[i].id);
+
+            // Validate the contents of the records.
+            ASSERT_EQUALS(rs->dataFor(opCtx.get(), records[0].id).size(), largeValue.size());
+            RecordData record = rs->dataFor(opCtx.get(), records[batchSize - 1].id);
+            ASSERT_EQUALS(static_cast<size_t>(record.size()), value.size());
+            ASSERT_EQUALS(0, memcmp(record.data(), value.c_str(), value.size()));
+
+            numRecords += batchSize;
+        }
+
+        if (batched)
+            batchMicros = timer.micros();
+        else
+            singleMicros = timer.micros();
+
+        ASSERT_EQUALS(rs->numRecords(opCtx.get()), numRecords);
+        ASSERT_EQUALS(rs->dataSize(opCtx.get()), length);
+    }
+
+    unittest::log() << "inserted " << numBatches << " batches of " << batchSize
+                    << " records: insertRecord " << singleMicros << "us, insertRecords "
+                    << batchMicros << "us";
+}
+
+TEST(KVDBRecordStoreTest, Prefetch) {
+    std::unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    std::unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+    const string value = random_string(VALUE_META_THRESHOLD_LEN + 10);
+    RecordId loc;
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res =
+            rs->insertRecord(opCtx.get(), value.c_str(), value.size(), false);
+        ASSERT_OK(res.getStatus());
+        loc = res.getValue();
+        uow.commit();
+    }
+
+    StatusWith<bool> found = rs->prefetch(opCtx.get(), loc);
+    ASSERT_OK(found.getStatus());
+    ASSERT_TRUE(found.getValue());
+
+    found = rs->prefetch(opCtx.get(), RecordId(loc.repr() + 1));
+    ASSERT_OK(found.getStatus());
+    ASSERT_FALSE(found.getValue());
+
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        rs->deleteRecord(opCtx.get(), loc);
+        uow.commit();
+    }
+
+    found = rs->prefetch(opCtx.get(), loc);
+    ASSERT_OK(found.getStatus());
+    ASSERT_FALSE(found.getValue());
+}
+
 StatusWith<RecordId> insertBSONTs(ServiceContext::UniqueOperationContext& opCtx,
                                   std::unique_ptr<RecordStore>& rs,
                                   const Timestamp& opTime) {
@@ -750,6 +1076,58 @@ TEST(KVDBRecordStoreTest, CappedOrder) {
     }
 }
 
+// A reopened capped collection starts from its highest RecordId, so the records it already holds
+// stay visible, and are not taken for uncommitted ones, while a new insert is in flight.
+TEST(KVDBRecordStoreTest, CappedReopenWithInsertInFlight) {
+    std::unique_ptr<KVDBRecordStoreHarnessHelper> harnessHelper(new KVDBRecordStoreHarnessHelper());
+    std::unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("a.b", 100000, 10000));
+
+    RecordId loc1, loc2;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        loc1 = uassertStatusOK(rs->insertRecord(opCtx.get(), "a", 2, false));
+        loc2 = uassertStatusOK(rs->insertRecord(opCtx.get(), "b", 2, false));
+        uow.commit();
+    }
+
+    rs.reset();
+    rs = harnessHelper->newCappedRecordStore("a.b", 100000, 10000);
+
+    ServiceContext::UniqueOperationContext t1(harnessHelper->newOperationContext());
+    std::unique_ptr<WriteUnitOfWork> w1(new WriteUnitOfWork(t1.get()));
+    RecordId loc3 = uassertStatusOK(rs->insertRecord(t1.get(), "c", 2, false));
+    ASSERT_GT(loc3, loc2);
+
+    {
+        auto client2 = harnessHelper->serviceContext()->makeClient("c2");
+        auto opCtx = harnessHelper->newOperationContext(client2.get());
+        auto cursor = rs->getCursor(opCtx.get());
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQ(loc1, record->id);
+        record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQ(loc2, record->id);
+        ASSERT(!cursor->next());
+
+        ASSERT(rs->getCursor(opCtx.get())->seekExact(loc2));
+    }
+
+    w1->commit();
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        auto cursor = rs->getCursor(opCtx.get());
+        auto record = cursor->seekExact(loc2);
+        ASSERT(record);
+        record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQ(loc3, record->id);
+        ASSERT(!cursor->next());
+    }
+}
+
 RecordId _oplogOrderInsertOplog(OperationContext* txn, std::unique_ptr<RecordStore>& rs, int inc) {
     Timestamp opTime = Timestamp(5, inc);
     KVDBRecordStore* rrs = dynamic_cast<KVDBRecordStore*>(rs.get());
@@ -905,6 +1283,77 @@ TEST(KVDBRecordStoreTest, OplogOrder) {
     }
 }
 
+// Many writers registering, committing and aborting oplog records at once. Optimes are handed
+// out under a mutex the way getNextOpTime() does; everything else runs concurrently.
+TEST(KVDBRecordStoreTest, OplogVisibilityContention) {
+    std::unique_ptr<KVDBRecordStoreHarnessHelper> harnessHelper(new KVDBRecordStoreHarnessHelper());
+    std::unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.foo", 1024 * 1024 * 1024, -1));
+    KVDBRecordStore* rrs = dynamic_cast<KVDBRecordStore*>(rs.get());
+
+    const int numThreads = 64;
+    const int opsPerThread = 200;
+    const int abortEvery = 16;
+
+    stdx::mutex opTimeMutex;
+    unsigned inc = 0;
+    AtomicUInt32 failures{0};
+
+    std::vector<ServiceContext::UniqueClient> clients;
+    for (int t = 0; t < numThreads; t++)
+        clients.push_back(harnessHelper->serviceContext()->makeClient(str::stream() << "w" << t));
+
+    Timer timer;
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t] {
+            auto opCtx = harnessHelper->newOperationContext(clients[t].get());
+
+            for (int i = 0; i < opsPerThread; i++) {
+                WriteUnitOfWork uow(opCtx.get());
+                Timestamp opTime;
+                {
+                    stdx::lock_guard<stdx::mutex> lk(opTimeMutex);
+                    opTime = Timestamp(7, ++inc);
+                    if (!rrs->oplogDiskLocRegister(opCtx.get(), opTime).isOK())
+                        failures.fetchAndAdd(1);
+                }
+
+                BSONObj obj = BSON("ts" << opTime);
+                if (!rs->insertRecord(opCtx.get(), obj.objdata(), obj.objsize(), false).isOK())
+                    failures.fetchAndAdd(1);
+
+                if (i % abortEvery != abortEvery - 1)
+                    uow.commit();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    const long long micros = timer.micros();
+
+    ASSERT_EQ(0U, failures.load());
+
+    rs->waitForAllEarlierOplogWritesToBeVisible(harnessHelper->newOperationContext().get());
+
+    // All committed records are visible, in order, and none of the aborted ones are.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        auto cursor = rs->getCursor(opCtx.get());
+        int numVisible = 0;
+        RecordId last;
+        while (auto record = cursor->next()) {
+            ASSERT_LT(last, record->id);
+            last = record->id;
+            numVisible++;
+        }
+        ASSERT_EQ(numThreads * (opsPerThread - opsPerThread / abortEvery), numVisible);
+    }
+
+    unittest::log() << numThreads << " writers registered " << numThreads * opsPerThread
+                    << " oplog records in " << micros << "us";
+}
+
 BSONObj makeBSONObjWithSize(const Timestamp& opTime, int size, char fill = 'x') {
     BSONObj objTemplate = BSON("ts" << opTime << "str"
                                     << "");
@@ -1255,6 +1704,104 @@ TEST(KVDBRecordStoreTest, OplogBlock_cursorRead) {
     }
 }
 
+// Read records that span blocks through a forward oplog cursor, which buffers them ahead of
+// next(), and check the buffer across yields, truncates and seeks.
+TEST(KVDBRecordStoreTest, OplogBlock_cursorReadAhead) {
+    KVDBRecordStoreHarnessHelper harnessHelper;
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper.newCappedRecordStore("local.oplog.readahead", cappedMaxSize, -1));
+
+    KVDBOplogStore* kvdbRs = static_cast<KVDBOplogStore*>(rs.get());
+    KVDBOplogBlockManager* opBlkMgr = kvdbRs->getOpBlkMgr();
+
+    opBlkMgr->setMinBytesPerBlock(1000);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+        for (int i = 1; i <= 9; i++) {
+            ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, i), 100 * i),
+                      RecordId(1, i));
+        }
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+        // The first next() buffers every visible entry, across blocks.
+        auto cursor = rs->getCursor(opCtx.get(), true);
+        for (int i = 1; i <= 3; i++) {
+            auto item = cursor->next();
+            ASSERT(item);
+            ASSERT_EQUALS(item->id, RecordId(1, i));
+            ASSERT_EQUALS(static_cast<int>(item->data.size()), 100 * i);
+        }
+
+        // Entries are still served from the buffer across a yield.
+        cursor->save();
+        ASSERT(cursor->restore());
+        for (int i = 4; i <= 5; i++) {
+            auto item = cursor->next();
+            ASSERT(item);
+            ASSERT_EQUALS(item->id, RecordId(1, i));
+            ASSERT_EQUALS(static_cast<int>(item->data.size()), 100 * i);
+        }
+
+        // A truncate while yielded drops the buffered entries it removed.
+        cursor->save();
+        rs->temp_cappedTruncateAfter(opCtx.get(), RecordId(1, 7), true);
+        ASSERT(cursor->restore());
+
+        auto item = cursor->next();
+        ASSERT(item);
+        ASSERT_EQUALS(item->id, RecordId(1, 6));
+        ASSERT_EQUALS(static_cast<int>(item->data.size()), 600);
+        ASSERT(!cursor->next());
+
+        // seekExact repositions the cursor ahead of the buffer.
+        item = cursor->seekExact(RecordId(1, 2));
+        ASSERT(item);
+        item = cursor->next();
+        ASSERT(item);
+        ASSERT_EQUALS(item->id, RecordId(1, 3));
+    }
+}
+
+// Read an oplog larger than the first read-ahead fill, which takes several fills of growing size.
+TEST(KVDBRecordStoreTest, OplogBlock_cursorReadAheadGrows) {
+    KVDBRecordStoreHarnessHelper harnessHelper;
+
+    const int64_t cappedMaxSize = 4 * 1024 * 1024;  // 4MB
+    const int numRecs = 400;
+    const int sizePerRec = 1000;
+    unique_ptr<RecordStore> rs(
+        harnessHelper.newCappedRecordStore("local.oplog.readaheadgrows", cappedMaxSize, -1));
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+        for (int i = 1; i <= numRecs; i++) {
+            ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, i), sizePerRec),
+                      RecordId(1, i));
+        }
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+        auto cursor = rs->getCursor(opCtx.get(), true);
+        for (int i = 1; i <= numRecs; i++) {
+            auto item = cursor->next();
+            ASSERT(item);
+            ASSERT_EQUALS(item->id, RecordId(1, i));
+            ASSERT_EQUALS(static_cast<int>(item->data.size()), sizePerRec);
+        }
+        ASSERT(!cursor->next());
+    }
+}
+
 // Insert records into an oplog and verify the number of blocks that are created.
 TEST(KVDBRecordStoreTest, OplogBlock_CreateNewBlock) {
     KVDBRecordStoreHarnessHelper harnessHelper;
@@ -37,6 +37,7 @@
 #include "mongo/platform/basic.h"
 #include "mongo/util/log.h"
 
+#include "hse_global_options.h"
 #include "hse_util.h"
 
 using hse::ClientTxn;
@@ -69,7 +70,11 @@ KVDBRecoveryUnit::KVDBRecoveryUnit(KVDB& kvdb,
       _txn(nullptr),
       _txn_cached(nullptr),
       _counterManager(counterManager),
-      _durabilityManager(durabilityManager) {}
+      _durabilityManager(durabilityManager),
+      _everStartedWrite(false),
+      _readViewPinned(false),
+      _pinnedYields(0),
+      _pinnedReadViewMaxAgeMS(kvdbGlobalOptions.getPinnedReadViewMaxAgeMS()) {}
 
 KVDBRecoveryUnit::~KVDBRecoveryUnit() {
     if (!_kvdb.kvdb_handle()) {
@@ -84,9 +89,20 @@ KVDBRecoveryUnit::~KVDBRecoveryUnit() {
     }
 }
 
+void KVDBRecoveryUnit::reportState(BSONObjBuilder* b) const {
+    b->append("hse_activeTxn", _txn != nullptr);
+    b->append("hse_readViewPinned", _readViewPinned);
+    b->appendNumber("hse_pinnedYields", _pinnedYields);
+    if (_txn)
+        b->append("hse_readViewAgeMillis", _readViewTimer.millis());
+}
+
 void KVDBRecoveryUnit::beginUnitOfWork(OperationContext* opCtx) {
     // validate the recovery unit in the context
     invariantHse(opCtx->recoveryUnit() == this);
+
+    _everStartedWrite = true;
+    _readViewPinned = false;
 }
 
 void KVDBRecoveryUnit::commitUnitOfWork() {
@@ -98,6 +114,7 @@ void KVDBRecoveryUnit::commitUnitOfWork() {
 
         _txn_cached = _txn;
         _txn = nullptr;
+        _readViewPinned = false;
 
         // TODO: Can we move this into _ensure_txn() or beginUnitOfWork() ???
         // If so it would roughly halve the contention on this global atomic...
@@ -138,6 +155,7 @@ void KVDBRecoveryUnit::abortUnitOfWork() {
 
         _txn_cached = _txn;
         _txn = nullptr;
+        _readViewPinned = false;
 
         _snapId = nextSnapshotId.fetchAndAdd(1);
     }
@@ -163,12 +181,18 @@ bool KVDBRecoveryUnit::waitUntilDurable() {
 }
 
 void KVDBRecoveryUnit::abandonSnapshot() {
-    if (_txn) {
+    if (_txn && _canPinReadView()) {
+        // Keep the transaction, and with it the view all cursors are bound to. The snapshot id
+        // stays the same since nothing read through this view can have changed.
+        _readViewPinned = true;
+        _pinnedYields++;
+    } else if (_txn) {
         hse::Status st(_txn->abort());
         invariantHseSt(st);
 
         _txn_cached = _txn;
         _txn = nullptr;
+        _readViewPinned = false;
 
         _snapId = nextSnapshotId.fetchAndAdd(1);
     }
@@ -291,6 +315,7 @@ hse::Status KVDBRecoveryUnit::beginScan(const KVSHandle& h,
         return hse::Status(ENOMEM);
     }
     invariantHse(lcursor != 0);
+    lcursor->setViewId(_snapId);
     *cursor = lcursor;
 
     return 0;
@@ -298,8 +323,14 @@ hse::Status KVDBRecoveryUnit::beginScan(const KVSHandle& h,
 
 hse::Status KVDBRecoveryUnit::cursorUpdate(KvsCursor* cursor) {
     _ensureTxn();
+
+    // A cursor still bound to the pinned view is positioned where it was left.
+    if (_readViewPinned && cursor->getViewId() == _snapId)
+        return 0;
+
     auto st = cursor->update(_txn);
     invariantHse(st.ok());
+    cursor->setViewId(_snapId);
 
     return st;
 }
@@ -413,8 +444,15 @@ void KVDBRecoveryUnit::_ensureTxn() {
         // start a transaction.
         st = _txn->begin();
         invariantHseSt(st);
+        _readViewTimer.reset();
     }
 }
 
+bool KVDBRecoveryUnit::_canPinReadView() const {
+    // An old view holds back compaction, so it is only kept for a bounded time.
+    return _pinnedReadViewMaxAgeMS > 0 && !_everStartedWrite && _changes.empty() &&
+        _readViewTimer.millis() < _pinnedReadViewMaxAgeMS;
+}
+
 /* End  KVDBRecoveryUnit */
 }  // namespace mongo
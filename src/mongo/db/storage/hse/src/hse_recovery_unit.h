@@ -47,6 +47,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/recovery_unit.h"
+#include "mongo/util/timer.h"
 
 
 #include "hse.h"
@@ -89,6 +90,8 @@ public:
 
     virtual ~KVDBRecoveryUnit();
 
+    virtual void reportState(BSONObjBuilder* b) const;
+
     virtual void beginUnitOfWork(OperationContext* opCtx);
 
     virtual void commitUnitOfWork();
@@ -97,6 +100,13 @@ public:
 
     virtual bool waitUntilDurable();
 
+    /**
+     * Releases the current read view, unless this recovery unit has never started a unit of work
+     * and pinning is enabled, in which case the view is kept until it gets older than
+     * '--hsePinnedReadViewMaxAgeMS'. The age is only checked here, so a view that outlives the
+     * limit between two yields is released at the next one. Cursors bound to a pinned view need
+     * not be recreated.
+     */
     virtual void abandonSnapshot();
 
     // [HSE_REVISIT] - Default for now
@@ -182,8 +192,17 @@ public:
 
     KVDBRecoveryUnit* newKVDBRecoveryUnit();
 
+    bool isReadViewPinned() const {
+        return _readViewPinned;
+    }
+
+    void setPinnedReadViewMaxAgeMS(int maxAgeMS) {
+        _pinnedReadViewMaxAgeMS = maxAgeMS;
+    }
+
 private:
     void _ensureTxn();
+    bool _canPinReadView() const;
 
     KVDB& _kvdb;  // db handle
 
@@ -202,6 +221,13 @@ private:
 
     KVDBCounterMap _deltaCounters;
 
+    // Read views are only pinned for operations which never write.
+    bool _everStartedWrite;
+    bool _readViewPinned;
+    long long _pinnedYields;
+    int _pinnedReadViewMaxAgeMS;
+    Timer _readViewTimer;
+
     typedef OwnedPointerVector<Change> Changes;
     Changes _changes;
 };
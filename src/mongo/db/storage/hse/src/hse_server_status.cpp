@@ -76,6 +76,7 @@ BSONObj KVDBServerStatusSection::generateSection(OperationContext* txn,
         bob.append("latencies", _buildStatsBObj(gHseStatLatencyList));
         bob.append("rates", _buildStatsBObj(gHseStatRateList));
     }
+    _engine.appendMediaClassStats(&bob);
 
 
     return bob.obj();
@@ -401,6 +401,7 @@ KVDBStatCounter _hseKvsCursorDestroyCounter{"hseKvsCursorDestroy"};
 KVDBStatCounter _hseKvsCursorReadCounter{"hseKvsCursorRead"};
 KVDBStatCounter _hseKvsCursorUpdateCounter{"hseKvsCursorUpdate"};
 KVDBStatCounter _hseOplogCursorCreateCounter{"hseOplogCursorCreate"};
+KVDBStatCounter _hseOplogCursorReadAheadCounter{"hseOplogCursorReadAhead"};
 
 // Latencies
 
@@ -231,6 +231,7 @@ extern KVDBStatCounter _hseKvdbSyncCounter;
 extern KVDBStatCounter _hseKvsDeleteCounter;
 extern KVDBStatCounter _hseKvsPrefixDeleteCounter;
 extern KVDBStatCounter _hseOplogCursorCreateCounter;
+extern KVDBStatCounter _hseOplogCursorReadAheadCounter;
 
 // Latencies
 extern KVDBStatLatency _hseKvsGetLatency;
@@ -32,6 +32,7 @@
 
 #include "mongo/db/storage/kv/kv_catalog.h"
 
+#include <algorithm>
 #include <stdlib.h>
 
 #include "mongo/bson/util/bson_extract.h"
@@ -87,7 +88,6 @@ public:
 
     virtual void commit() {}
     virtual void rollback() {
-        stdx::lock_guard<stdx::mutex> lk(_catalog->_identsLock);
         _catalog->_idents.erase(_ident);
     }
 
@@ -102,8 +102,7 @@ public:
 
     virtual void commit() {}
     virtual void rollback() {
-        stdx::lock_guard<stdx::mutex> lk(_catalog->_identsLock);
-        _catalog->_idents[_ident] = _entry;
+        _catalog->_idents.set(_ident, _entry);
     }
 
     KVCatalog* const _catalog;
@@ -274,12 +273,12 @@ std::string KVCatalog::_newRand() {
 }
 
 bool KVCatalog::_hasEntryCollidingWithRand() const {
-    // Only called from init() so don't need to lock.
-    for (NSToIdentMap::const_iterator it = _idents.begin(); it != _idents.end(); ++it) {
-        if (StringData(it->first).endsWith(_rand))
-            return true;
-    }
-    return false;
+    bool colliding = false;
+    _idents.forEach([&](StringData ns, const Entry& entry) {
+        if (ns.endsWith(_rand))
+            colliding = true;
+    });
+    return colliding;
 }
 
 std::string KVCatalog::_newUniqueIdent(StringData ns, const char* kind) {
@@ -313,7 +312,7 @@ void KVCatalog::init(OperationContext* opCtx) {
         // No rollback since this is just loading already committed data.
         string ns = obj["ns"].String();
         string ident = obj["ident"].String();
-        _idents[ns] = Entry(ident, record->id);
+        _idents.set(ns, Entry(ident, record->id));
     }
 
     if (!_featureTracker) {
@@ -329,10 +328,15 @@ void KVCatalog::init(OperationContext* opCtx) {
 }
 
 void KVCatalog::getAllCollections(std::vector<std::string>* out) const {
-    stdx::lock_guard<stdx::mutex> lk(_identsLock);
-    for (NSToIdentMap::const_iterator it = _idents.begin(); it != _idents.end(); ++it) {
-        out->push_back(it->first);
-    }
+    const size_t first = out->size();
+    _idents.forEach([&](StringData ns, const Entry& entry) {
+        // An empty ident is a namespace newCollection() has reserved but not yet stored.
+        if (!entry.ident.empty())
+            out->push_back(ns.toString());
+    });
+
+    // The map is unordered; keep handing out namespaces sorted as callers have always seen them.
+    std::sort(out->begin() + first, out->end());
 }
 
 Status KVCatalog::newCollection(OperationContext* opCtx,
@@ -343,9 +347,9 @@ Status KVCatalog::newCollection(OperationContext* opCtx,
 
     const string ident = _newUniqueIdent(ns, "collection");
 
-    stdx::lock_guard<stdx::mutex> lk(_identsLock);
-    Entry& old = _idents[ns.toString()];
-    if (!old.ident.empty()) {
+    // Reserve the namespace with an empty entry so the catalog write below happens without
+    // holding up lookups of other namespaces. The database X lock keeps out other writers to it.
+    if (!_idents.insert(ns, Entry())) {
         return Status(ErrorCodes::NamespaceExists, "collection already exists");
     }
 
@@ -367,16 +371,15 @@ Status KVCatalog::newCollection(OperationContext* opCtx,
     if (!res.isOK())
         return res.getStatus();
 
-    old = Entry(ident, res.getValue());
+    _idents.set(ns, Entry(ident, res.getValue()));
     LOG(1) << "stored meta data for " << ns << " @ " << res.getValue();
     return Status::OK();
 }
 
 std::string KVCatalog::getCollectionIdent(StringData ns) const {
-    stdx::lock_guard<stdx::mutex> lk(_identsLock);
-    NSToIdentMap::const_iterator it = _idents.find(ns.toString());
-    invariant(it != _idents.end());
-    return it->second.ident;
+    Entry entry;
+    invariant(_idents.find(ns, &entry));
+    return entry.ident;
 }
 
 std::string KVCatalog::getIndexIdent(OperationContext* opCtx,
@@ -388,13 +391,9 @@ std::string KVCatalog::getIndexIdent(OperationContext* opCtx,
 }
 
 BSONObj KVCatalog::_findEntry(OperationContext* opCtx, StringData ns, RecordId* out) const {
-    RecordId dl;
-    {
-        stdx::lock_guard<stdx::mutex> lk(_identsLock);
-        NSToIdentMap::const_iterator it = _idents.find(ns.toString());
-        invariant(it != _idents.end());
-        dl = it->second.storedLoc;
-    }
+    Entry entry;
+    invariant(_idents.find(ns, &entry));
+    const RecordId dl = entry.storedLoc;
 
     LOG(3) << "looking up metadata for: " << ns << " @ " << dl;
     RecordData data;
@@ -488,15 +487,15 @@ Status KVCatalog::renameCollection(OperationContext* opCtx,
         fassert(28522, status.isOK());
     }
 
-    stdx::lock_guard<stdx::mutex> lk(_identsLock);
-    const NSToIdentMap::iterator fromIt = _idents.find(fromNS.toString());
-    invariant(fromIt != _idents.end());
+    // Both namespaces are under the database X lock, so nobody looks them up in between the
+    // erase and the set.
+    Entry fromEntry;
+    invariant(_idents.erase(fromNS, &fromEntry));
 
-    opCtx->recoveryUnit()->registerChange(new RemoveIdentChange(this, fromNS, fromIt->second));
+    opCtx->recoveryUnit()->registerChange(new RemoveIdentChange(this, fromNS, fromEntry));
     opCtx->recoveryUnit()->registerChange(new AddIdentChange(this, toNS));
 
-    _idents.erase(fromIt);
-    _idents[toNS.toString()] = Entry(old["ident"].String(), loc);
+    _idents.set(toNS, Entry(old["ident"].String(), loc));
 
     return Status::OK();
 }
@@ -504,17 +503,15 @@ Status KVCatalog::renameCollection(OperationContext* opCtx,
 Status KVCatalog::dropCollection(OperationContext* opCtx, StringData ns) {
     invariant(opCtx->lockState() == NULL ||
               opCtx->lockState()->isDbLockedForMode(nsToDatabaseSubstring(ns), MODE_X));
-    stdx::lock_guard<stdx::mutex> lk(_identsLock);
-    const NSToIdentMap::iterator it = _idents.find(ns.toString());
-    if (it == _idents.end()) {
+    Entry entry;
+    if (!_idents.erase(ns, &entry)) {
         return Status(ErrorCodes::NamespaceNotFound, "collection not found");
     }
 
-    opCtx->recoveryUnit()->registerChange(new RemoveIdentChange(this, ns, it->second));
+    opCtx->recoveryUnit()->registerChange(new RemoveIdentChange(this, ns, entry));
 
-    LOG(1) << "deleting metadata for " << ns << " @ " << it->second.storedLoc;
-    _rs->deleteRecord(opCtx, it->second.storedLoc);
-    _idents.erase(it);
+    LOG(1) << "deleting metadata for " << ns << " @ " << entry.storedLoc;
+    _rs->deleteRecord(opCtx, entry.storedLoc);
 
     return Status::OK();
 }
@@ -522,15 +519,10 @@ Status KVCatalog::dropCollection(OperationContext* opCtx, StringData ns) {
 std::vector<std::string> KVCatalog::getAllIdentsForDB(StringData db) const {
     std::vector<std::string> v;
 
-    {
-        stdx::lock_guard<stdx::mutex> lk(_identsLock);
-        for (NSToIdentMap::const_iterator it = _idents.begin(); it != _idents.end(); ++it) {
-            NamespaceString ns(it->first);
-            if (ns.db() != db)
-                continue;
-            v.push_back(it->second.ident);
-        }
-    }
+    _idents.forEach([&](StringData ns, const Entry& entry) {
+        if (!entry.ident.empty() && nsToDatabaseSubstring(ns) == db)
+            v.push_back(entry.ident);
+    });
 
     return v;
 }
@@ -30,7 +30,6 @@
 
 #pragma once
 
-#include <map>
 #include <memory>
 #include <string>
 
@@ -38,7 +37,7 @@
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/bson_collection_catalog_entry.h"
-#include "mongo/stdx/mutex.h"
+#include "mongo/util/sharded_string_map.h"
 
 namespace mongo {
 
@@ -124,9 +123,9 @@ private:
         std::string ident;
         RecordId storedLoc;
     };
-    typedef std::map<std::string, Entry> NSToIdentMap;
+    // Sharded so that lookups for one namespace don't wait on creates and drops of others.
+    typedef ShardedStringMap<Entry> NSToIdentMap;
     NSToIdentMap _idents;
-    mutable stdx::mutex _identsLock;
 
     // Manages the feature document that may be present in the KVCatalog. '_featureTracker' is
     // guaranteed to be non-null after KVCatalog::init() is called.
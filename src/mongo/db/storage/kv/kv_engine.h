@@ -130,6 +130,14 @@ public:
      */
     virtual bool supportsDirectoryPerDB() const = 0;
 
+    /**
+     * Returns true if the record stores and indexes of this engine implement prefetch().
+     * See StorageEngine::supportsPrefetch().
+     */
+    virtual bool supportsPrefetch() const {
+        return false;
+    }
+
     virtual Status okToRename(OperationContext* opCtx,
                               StringData fromNS,
                               StringData toNS,
@@ -274,6 +274,10 @@ bool KVStorageEngine::isEphemeral() const {
     return _engine->isEphemeral();
 }
 
+bool KVStorageEngine::supportsPrefetch() const {
+    return _engine->supportsPrefetch();
+}
+
 SnapshotManager* KVStorageEngine::getSnapshotManager() const {
     return _engine->getSnapshotManager();
 }
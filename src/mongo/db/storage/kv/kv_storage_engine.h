@@ -75,6 +75,8 @@ public:
         return _supportsDocLocking;
     }
 
+    virtual bool supportsPrefetch() const;
+
     virtual Status closeDatabase(OperationContext* txn, StringData db);
 
     virtual Status dropDatabase(OperationContext* txn, StringData db);
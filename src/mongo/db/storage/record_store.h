@@ -582,6 +582,20 @@ public:
                       "this storage engine does not support touch");
     }
 
+    /**
+     * Hint that the record at 'loc' is about to be read or written, so that the storage engine
+     * can bring it into its cache ahead of time. See prefetch.cpp.
+     *
+     * If the underlying storage engine does not support the operation,
+     * returns ErrorCodes::CommandNotSupported
+     *
+     * @return whether the record exists
+     */
+    virtual StatusWith<bool> prefetch(OperationContext* txn, const RecordId& loc) const {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "this storage engine does not support prefetch");
+    }
+
     /**
      * Return the RecordId of an oplog entry as close to startingPosition as possible without
      * being higher. If there are no entries <= startingPosition, return RecordId().
@@ -29,7 +29,9 @@
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
 #include <memory>
+#include <vector>
 
+#include "mongo/base/status_with.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
@@ -173,6 +175,40 @@ public:
                       "this storage engine does not support touch");
     }
 
+    /**
+     * Hint that 'key' is about to be looked up, so that the storage engine can bring the entry
+     * into its cache ahead of time. Only meaningful for unique indexes, where 'key' maps to a
+     * single RecordId. See prefetch.cpp.
+     *
+     * If the underlying storage engine does not support the operation,
+     * returns ErrorCodes::CommandNotSupported
+     *
+     * @return the RecordId 'key' maps to, or a null RecordId if there is no such entry
+     */
+    virtual StatusWith<RecordId> prefetch(OperationContext* txn, const BSONObj& key) const {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "this storage engine does not support prefetch");
+    }
+
+    /**
+     * Estimates keys that divide the index range [startKey, endKey) into ranges holding about
+     * 'keysPerRange' entries each, without reading every entry in the range. 'numEntries' is
+     * the caller's estimate of the number of entries in the whole index. Keys are in index key
+     * format, in ascending order, with no duplicates. Used by splitVector.
+     *
+     * If the underlying storage engine does not support the operation,
+     * returns ErrorCodes::CommandNotSupported
+     */
+    virtual Status estimateSplitKeys(OperationContext* txn,
+                                     const BSONObj& startKey,
+                                     const BSONObj& endKey,
+                                     long long numEntries,
+                                     long long keysPerRange,
+                                     std::vector<BSONObj>* splitKeys) const {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "this storage engine does not support estimating split keys");
+    }
+
     /**
      * Return the number of entries in 'this' index.
      *
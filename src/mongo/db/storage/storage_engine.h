@@ -194,6 +194,15 @@ public:
         return false;
     }
 
+    /**
+     * Returns whether the engine implements RecordStore::prefetch() and
+     * SortedDataInterface::prefetch(). Secondaries use them to warm the cache for the next batch
+     * of replicated operations while the current one is applied.
+     */
+    virtual bool supportsPrefetch() const {
+        return false;
+    }
+
     /**
      * Closes all file handles associated with a database.
      */
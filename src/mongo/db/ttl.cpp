@@ -246,6 +246,7 @@ private:
 
         DeleteStageParams params;
         params.isMulti = true;
+        params.batched = write_stage_common::canBatchWrites();
         params.canonicalQuery = canonicalQuery.getValue().get();
 
         std::unique_ptr<PlanExecutor> exec =
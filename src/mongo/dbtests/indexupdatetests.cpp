@@ -678,6 +678,73 @@ protected:
     }
 };
 
+/**
+ * An update that modifies a field covered by only some of the indexes changes the keys of those
+ * indexes and leaves the others as they were.
+ */
+class UpdateDocumentChangesAffectedIndexes : public IndexBuildBase {
+public:
+    void run() {
+        ASSERT_OK(createIndex("unittest", _createSpec("a_1", BSON("a" << 1))));
+        ASSERT_OK(createIndex("unittest", _createSpec("b_1", BSON("b" << 1))));
+        ASSERT_OK(createIndex("unittest", _createSpec("a_1_b_1", BSON("a" << 1 << "b" << 1))));
+
+        {
+            WriteUnitOfWork wunit(&_txn);
+            OpDebug* const nullOpDebug = nullptr;
+            ASSERT_OK(collection()->insertDocument(
+                &_txn, BSON("_id" << 1 << "a" << 1 << "b" << 1), nullOpDebug, true));
+            wunit.commit();
+        }
+        const RecordId loc = collection()->getCursor(&_txn)->next()->id;
+
+        {
+            WriteUnitOfWork wunit(&_txn);
+            const std::vector<std::string> modifiedIndexedPaths{"b"};
+            OplogUpdateEntryArgs args;
+            ASSERT_OK(collection()
+                          ->updateDocument(&_txn,
+                                           loc,
+                                           collection()->docFor(&_txn, loc),
+                                           BSON("_id" << 1 << "a" << 1 << "b" << 2),
+                                           true,
+                                           true,
+                                           nullptr,
+                                           &args,
+                                           &modifiedIndexedPaths)
+                          .getStatus());
+            wunit.commit();
+        }
+
+        _assertKeys("a_1", {BSON("" << 1)});
+        _assertKeys("b_1", {BSON("" << 2)});
+        _assertKeys("a_1_b_1", {BSON("" << 1 << "" << 2)});
+    }
+
+private:
+    BSONObj _createSpec(const std::string& name, const BSONObj& key) {
+        return BSON("name" << name << "ns" << _ns << "key" << key << "v"
+                           << static_cast<int>(kIndexVersion));
+    }
+
+    void _assertKeys(const std::string& indexName, const std::vector<BSONObj>& expected) {
+        IndexCatalog* catalog = collection()->getIndexCatalog();
+        IndexDescriptor* desc = catalog->findIndexByName(&_txn, indexName);
+        ASSERT(desc);
+
+        std::vector<BSONObj> keys;
+        auto cursor = catalog->getIndex(desc)->newCursor(&_txn);
+        for (auto kv = cursor->seek(kMinBSONKey, true); kv; kv = cursor->next()) {
+            keys.push_back(kv->key.getOwned());
+        }
+
+        ASSERT_EQ(expected.size(), keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            ASSERT_BSONOBJ_EQ(expected[i], keys[i]);
+        }
+    }
+};
+
 class IndexCatatalogFixIndexKey {
 public:
     void run() {
@@ -817,6 +884,7 @@ public:
         add<SameSpecDifferentSparse>();
         add<SameSpecDifferentTTL>();
         add<StorageEngineOptions>();
+        add<UpdateDocumentChangesAffectedIndexes>();
 
         add<IndexCatatalogFixIndexKey>();
 
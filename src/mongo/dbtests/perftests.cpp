@@ -48,18 +48,34 @@
 
 #include "mongo/config.h"
 #include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/catalog/cursor_manager.h"
 #include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/db/db.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/db/storage/kv/kv_catalog.h"
+#include "mongo/db/storage/kv/kv_database_catalog_entry.h"
+#include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/kv/kv_storage_engine.h"
 #include "mongo/db/storage/mmap_v1/dur_stats.h"
 #include "mongo/db/storage/mmap_v1/mmap.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/dbtests/framework_options.h"
+#include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_test_fixture.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/s/query/cluster_client_cursor_mock.h"
+#include "mongo/s/query/cluster_cursor_manager.h"
 #include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/clock_source_mock.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/timer.h"
 #include "mongo/util/version.h"
 
@@ -259,6 +275,11 @@ public:
         return false;
     }
 
+    /** number of threads to use when testThreaded() is true */
+    virtual int threadCount() {
+        return 8;
+    }
+
     int howLong() {
         int hlm = howLongMillis();
         DEV {
@@ -316,7 +337,7 @@ public:
         }
 
         if (testThreaded()) {
-            const int nThreads = 8;
+            const int nThreads = threadCount();
             // cout << "testThreaded nThreads:" << nThreads << endl;
             mongo::Timer t;
             const unsigned long long result = launchThreads(nThreads);
@@ -450,6 +471,419 @@ public:
     }
 };
 
+/**
+ * Returns the number of threads to scale multi-threaded tests up to: as many as there are cores,
+ * but at least 8 and at most 64.
+ */
+int maxScalingThreads() {
+    const auto numCores = ProcessInfo().getNumAvailableCores();
+    return numCores ? std::max(8, std::min(64, static_cast<int>(*numCores))) : 8;
+}
+
+/**
+ * Prints the rate of 'n' operations that took 'us' microseconds in the format B::say() uses.
+ */
+void sayRate(const string& name, unsigned long long n, long long us) {
+    us = std::max(us, 1LL);
+    const unsigned long long rps = (n * 1000 * 1000) / us;
+    cout << "stats " << setw(42) << left << name << ' ' << right << setw(9) << rps << ' ' << right
+         << setw(5) << us / 1000 << "ms" << endl;
+}
+
+/**
+ * Runs 'op' 'itersPerThread' times on each of 1, 2, 4, ... up to 'maxThreads' threads running at
+ * once, and prints the combined rate for every number of threads. 'op' is passed the index of the
+ * thread it runs on and the iteration.
+ */
+void runThreadScaling(const string& name,
+                      int maxThreads,
+                      int itersPerThread,
+                      const stdx::function<void(int threadId, int iter)>& op) {
+    for (int numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+        vector<stdx::thread> threads;
+        mongo::Timer t;
+
+        for (int threadId = 0; threadId < numThreads; threadId++) {
+            threads.emplace_back([&, threadId] {
+                for (int i = 0; i < itersPerThread; i++) {
+                    op(threadId, i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        sayRate(name + "-" + std::to_string(numThreads) + "threads",
+                static_cast<unsigned long long>(numThreads) * itersPerThread,
+                t.micros());
+    }
+}
+
+/**
+ * Registers and deregisters executors with a single collection's CursorManager from as many
+ * threads as there are cores (up to 64), the way yielding queries on a hot collection do. The
+ * threaded rate should stay close to the single threaded one.
+ */
+class CursorManagerExecutorRegistration : public B {
+public:
+    CursorManagerExecutorRegistration() : _cursorManager("perftest.cursormanager") {}
+
+    string name() {
+        return "cursormanager-registerexecutor";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    virtual bool testThreaded() {
+        return true;
+    }
+    virtual int threadCount() {
+        return maxScalingThreads();
+    }
+    void timed() {
+        registerAndDeregister();
+    }
+    void timed2(DBClientBase*) {
+        registerAndDeregister();
+    }
+
+private:
+    void registerAndDeregister() {
+        // The CursorManager only keeps track of the executor's address, so any distinct heap
+        // allocation can stand in for a real PlanExecutor.
+        std::unique_ptr<char[]> executor(new char[sizeof(void*) * 32]);
+        PlanExecutor* exec = reinterpret_cast<PlanExecutor*>(executor.get());
+
+        _cursorManager.registerExecutor(exec);
+        _cursorManager.deregisterExecutor(exec);
+    }
+
+    CursorManager _cursorManager;
+};
+
+/**
+ * Takes and releases an intent lock on a single collection from an increasing number of threads,
+ * which is how collection locks are used on document-locking storage engines.
+ */
+class LockManagerCollectionIntentLocks {
+public:
+    void run() {
+        const int maxThreads = maxScalingThreads();
+
+        LockManager lockMgr;
+        const ResourceId resId(RESOURCE_COLLECTION, string("perftest.lockmanager"));
+        vector<std::unique_ptr<MMAPV1LockerImpl>> lockers;
+        for (int i = 0; i < maxThreads; i++) {
+            lockers.push_back(stdx::make_unique<MMAPV1LockerImpl>());
+        }
+
+        runThreadScaling(
+            "lockmanager-collectionintent", maxThreads, 100000, [&](int threadId, int) {
+                const LockMode mode = (threadId % 2) ? MODE_IX : MODE_IS;
+                TrackingLockGrantNotification notify;
+                LockRequest request;
+                request.initNew(lockers[threadId].get(), &notify);
+                invariant(LOCK_OK == lockMgr.lock(resId, &request, mode));
+                lockMgr.unlock(&request);
+            });
+    }
+};
+
+/**
+ * Checks cursors out of a ClusterCursorManager and back in from an increasing number of threads,
+ * the way concurrent getMore commands on a hot namespace do on mongos. Note that the mock clock
+ * source is itself guarded by a mutex, which caps the scaling seen here.
+ */
+class ClusterCursorManagerCheckOutAndCheckIn {
+public:
+    void run() {
+        const int kCursorsPerThread = 4;
+        const int maxThreads = maxScalingThreads();
+        const NamespaceString nss("perftest.clustercursormanager");
+
+        ClockSourceMock clockSource;
+        ClusterCursorManager manager(&clockSource);
+
+        vector<CursorId> cursorIds;
+        for (int i = 0; i < maxThreads * kCursorsPerThread; i++) {
+            cursorIds.push_back(uassertStatusOK(
+                manager.registerCursor(stdx::make_unique<ClusterClientCursorMock>(),
+                                       nss,
+                                       ClusterCursorManager::CursorType::NamespaceNotSharded,
+                                       ClusterCursorManager::CursorLifetime::Mortal)));
+        }
+
+        runThreadScaling(
+            "clustercursormanager-checkout", maxThreads, 20000, [&](int threadId, int i) {
+                const CursorId cursorId =
+                    cursorIds[threadId * kCursorsPerThread + i % kCursorsPerThread];
+                auto pinnedCursor = manager.checkOutCursor(nss, cursorId, nullptr);
+                invariantOK(pinnedCursor.getStatus());
+                pinnedCursor.getValue().returnCursor(
+                    ClusterCursorManager::CursorState::NotExhausted);
+            });
+
+        manager.killAllCursors();
+        manager.reapZombieCursors();
+    }
+};
+
+/**
+ * Checks connections out of an executor ConnectionPool and back in from an increasing number of
+ * threads, each talking to a host of its own the way scatter-gather operations from mongos do.
+ * Since every host has its own lock, threads should not slow each other down.
+ */
+class ConnectionPoolCheckOutAndCheckIn {
+public:
+    void run() {
+        using namespace executor::connection_pool_test_details;
+
+        const int maxThreads = maxScalingThreads();
+
+        {
+            executor::ConnectionPool pool(stdx::make_unique<PoolImpl>(), "perftest pool");
+            PoolImpl::setNow(Date_t::now());
+
+            vector<HostAndPort> hosts;
+            for (int i = 0; i < maxThreads; i++) {
+                hosts.emplace_back("host" + std::to_string(i), 27017);
+            }
+
+            // Establish one connection per host up front, so that only idle connections are
+            // checked out below
+            for (const auto& host : hosts) {
+                ConnectionImpl::pushSetup(Status::OK());
+                pool.get(host,
+                         Milliseconds(5000),
+                         [](StatusWith<executor::ConnectionPool::ConnectionHandle> swConn) {
+                             invariantOK(swConn.getStatus());
+                             checkIn(swConn.getValue());
+                         });
+            }
+
+            runThreadScaling("connectionpool-checkout", maxThreads, 20000, [&](int threadId, int) {
+                bool reached = false;
+                pool.get(hosts[threadId],
+                         Milliseconds(5000),
+                         [&](StatusWith<executor::ConnectionPool::ConnectionHandle> swConn) {
+                             invariantOK(swConn.getStatus());
+                             checkIn(swConn.getValue());
+                             reached = true;
+                         });
+                invariant(reached);
+            });
+        }
+
+        ConnectionImpl::clear();
+        TimerImpl::clear();
+    }
+
+private:
+    static void checkIn(const executor::ConnectionPool::ConnectionHandle& conn) {
+        static_cast<executor::connection_pool_test_details::ConnectionImpl*>(conn.get())
+            ->indicateSuccess();
+    }
+};
+
+/**
+ * Creates and then drops many collections while reader threads keep looking up the catalog entry
+ * and the engine ident of a collection that exists throughout. The lookups should keep their rate
+ * while the creates and drops go on. Only runs on KV storage engines.
+ */
+class KVCatalogCreateAndDropCollections {
+public:
+    void run() {
+        auto storageEngine =
+            dynamic_cast<KVStorageEngine*>(getGlobalServiceContext()->getGlobalStorageEngine());
+        if (!storageEngine) {
+            return;
+        }
+        KVCatalog* catalog = storageEngine->getCatalog();
+        KVEngine* engine = storageEngine->getEngine();
+
+        const int nColls = 10000;
+        const int nReaders = 4;
+        const string db = "perftest_kvcatalog";
+        const string fixedNs = "perftest_kvcatalog_fixed.coll";
+
+        const ServiceContext::UniqueOperationContext txnPtr = cc().makeOperationContext();
+        DBDirectClient client(txnPtr.get());
+        client.dropDatabase(db);
+        client.dropCollection(fixedNs);
+        invariant(client.createCollection(fixedNs));
+        const string fixedIdent = catalog->getCollectionIdent(fixedNs);
+
+        AtomicWord<bool> done(false);
+        AtomicUInt64 lookups;
+        vector<stdx::thread> readers;
+        for (int t = 0; t < nReaders; t++) {
+            readers.emplace_back([&] {
+                Client::initThreadIfNotAlready("perftestthr");
+                const ServiceContext::UniqueOperationContext readerTxn =
+                    cc().makeOperationContext();
+                while (!done.load()) {
+                    invariant(catalog->getCollectionIdent(fixedNs) == fixedIdent);
+                    invariant(engine->hasIdent(readerTxn.get(), fixedIdent));
+                    lookups.fetchAndAdd(1);
+                }
+            });
+        }
+
+        mongo::Timer t;
+        uint64_t lookupsBefore = lookups.load();
+        for (int i = 0; i < nColls; i++) {
+            invariant(client.createCollection(db + ".coll" + std::to_string(i)));
+        }
+        long long us = t.micros();
+        sayRate("kvcatalog-create", nColls, us);
+        sayRate("kvcatalog-create-lookups", lookups.load() - lookupsBefore, us);
+
+        t.reset();
+        lookupsBefore = lookups.load();
+        for (int i = 0; i < nColls; i++) {
+            invariant(client.dropCollection(db + ".coll" + std::to_string(i)));
+        }
+        us = t.micros();
+        sayRate("kvcatalog-drop", nColls, us);
+        sayRate("kvcatalog-drop-lookups", lookups.load() - lookupsBefore, us);
+
+        done.store(true);
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        client.dropDatabase(db);
+        client.dropCollection(fixedNs);
+    }
+};
+
+/**
+ * Opens the collections of a database the way a KV storage engine does for every collection when
+ * it starts, and prints the rate as the number of collections grows. The global storage engine
+ * cannot be restarted under dbtest, so the collections are reopened next to the open ones through
+ * a new KVDatabaseCatalogEntry. Only runs on KV storage engines.
+ */
+class KVStorageEngineStartupOpenCollections {
+public:
+    void run() {
+        auto storageEngine =
+            dynamic_cast<KVStorageEngine*>(getGlobalServiceContext()->getGlobalStorageEngine());
+        if (!storageEngine) {
+            return;
+        }
+
+        const string db = "perftest_kvstartup";
+
+        const ServiceContext::UniqueOperationContext txnPtr = cc().makeOperationContext();
+        OperationContext* txn = txnPtr.get();
+        DBDirectClient client(txn);
+        client.dropDatabase(db);
+
+        vector<string> namespaces;
+        for (int nColls : {100, 1000, 5000}) {
+            while (static_cast<int>(namespaces.size()) < nColls) {
+                namespaces.push_back(db + ".coll" + std::to_string(namespaces.size()));
+                client.insert(namespaces.back(), BSON("_id" << 0));
+            }
+
+            // Like the engine at startup, nothing else runs on the database while it is opened.
+            ScopedTransaction transaction(txn, MODE_IX);
+            Lock::DBLock lk(txn->lockState(), db, MODE_X);
+
+            KVDatabaseCatalogEntry dbEntry(db, storageEngine);
+            mongo::Timer t;
+            for (auto&& ns : namespaces) {
+                dbEntry.initCollection(txn, ns, false);
+            }
+            sayRate("kvstartup-open-" + std::to_string(nColls) + "colls", nColls, t.micros());
+            txn->recoveryUnit()->abandonSnapshot();
+        }
+
+        client.dropDatabase(db);
+    }
+};
+
+/**
+ * Updates the field covered by the first of many secondary indexes. Only that index should need
+ * new keys; the others are left untouched. With multikey other indexes, each of which has many
+ * keys per document, skipping them should save the most.
+ */
+class UpdateWithManyIndexesBase : public B {
+public:
+    virtual int howLongMillis() {
+        return 2000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        for (int i = 0; i < kNumIndexedFields; i++) {
+            client()->createIndex(ns(), BSON(indexedField(i) << 1));
+        }
+        for (int i = 0; i < kNumDocs; i++) {
+            BSONObjBuilder doc;
+            doc.append("_id", i);
+            doc.append(indexedField(0), i);
+            for (int j = 1; j < kNumIndexedFields; j++) {
+                if (arrayLength()) {
+                    BSONArrayBuilder values(doc.subarrayStart(indexedField(j)));
+                    for (int k = 0; k < arrayLength(); k++) {
+                        values.append(i * arrayLength() + k);
+                    }
+                } else {
+                    doc.append(indexedField(j), i);
+                }
+            }
+            insert(ns(), doc.obj());
+        }
+    }
+    void timed() {
+        const int id = _counter++ % kNumDocs;
+        update(ns(), BSON("_id" << id), BSON("$inc" << BSON(indexedField(0) << 1)));
+    }
+
+protected:
+    static std::string indexedField(int i) {
+        return str::stream() << "f" << i;
+    }
+
+    // Number of values in the arrays held by the fields of the other indexes, or 0 for scalars.
+    virtual int arrayLength() = 0;
+
+private:
+    static const int kNumIndexedFields = 8;
+    static const int kNumDocs = 1000;
+
+    int _counter = 0;
+};
+
+class UpdateOneIndexedFieldWithManyIndexes : public UpdateWithManyIndexesBase {
+public:
+    string name() {
+        return "update-manyindexes-indexedfield";
+    }
+
+protected:
+    int arrayLength() {
+        return 0;
+    }
+};
+
+class UpdateOneIndexedFieldWithManyMultikeyIndexes : public UpdateWithManyIndexesBase {
+public:
+    string name() {
+        return "update-manymultikeyindexes-indexedfield";
+    }
+
+protected:
+    int arrayLength() {
+        return 20;
+    }
+};
 
 class All : public Suite {
 public:
@@ -463,6 +897,14 @@ public:
         add<boosttimed_mutexspeed>();
         add<stdmutexspeed>();
         add<stdtimed_mutexspeed>();
+        add<CursorManagerExecutorRegistration>();
+        add<LockManagerCollectionIntentLocks>();
+        add<ClusterCursorManagerCheckOutAndCheckIn>();
+        add<ConnectionPoolCheckOutAndCheckIn>();
+        add<KVCatalogCreateAndDropCollections>();
+        add<KVStorageEngineStartupOpenCollections>();
+        add<UpdateOneIndexedFieldWithManyIndexes>();
+        add<UpdateOneIndexedFieldWithManyMultikeyIndexes>();
     }
 } myall;
 }
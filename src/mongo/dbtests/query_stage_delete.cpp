@@ -41,11 +41,13 @@
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/exec/write_stage_common.h"
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageDelete {
 
@@ -190,6 +192,183 @@ public:
     }
 };
 
+/**
+ * Test that a batched delete stage deletes the documents returned by its child in batches, and
+ * skips a document that was deleted by someone else while it was waiting in a batch.
+ */
+class QueryStageDeleteBatched : public QueryStageDeleteBase {
+public:
+    void run() {
+        // Documents waiting in a batch are not notified of invalidations.
+        if (!supportsDocLocking()) {
+            return;
+        }
+
+        OldClientWriteContext ctx(&_txn, nss.ns());
+
+        Collection* coll = ctx.getCollection();
+
+        vector<RecordId> recordIds;
+        getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+
+        CollectionScanParams collScanParams;
+        collScanParams.collection = coll;
+        collScanParams.direction = CollectionScanParams::FORWARD;
+        collScanParams.tailable = false;
+
+        DeleteStageParams deleteStageParams;
+        deleteStageParams.isMulti = true;
+        deleteStageParams.batched = true;
+
+        WorkingSet ws;
+        DeleteStage deleteStage(&_txn,
+                                deleteStageParams,
+                                &ws,
+                                coll,
+                                new CollectionScan(&_txn, collScanParams, &ws, NULL));
+
+        const DeleteStats* stats = static_cast<const DeleteStats*>(deleteStage.getSpecificStats());
+
+        // Queue a few documents without filling the batch. Nothing gets deleted yet.
+        const size_t targetDocIndex = 2;
+        for (size_t i = 0; i <= targetDocIndex + 1; ++i) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            ASSERT_EQUALS(PlanStage::NEED_TIME, deleteStage.work(&id));
+        }
+        ASSERT_EQUALS(0U, stats->docsDeleted);
+
+        // Remove a document which is waiting in the batch.
+        deleteStage.saveState();
+        BSONObj targetDoc = coll->docFor(&_txn, recordIds[targetDocIndex]).value();
+        ASSERT(!targetDoc.isEmpty());
+        remove(targetDoc);
+        deleteStage.restoreState();
+
+        // Remove the rest.
+        while (!deleteStage.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            invariant(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+        }
+
+        ASSERT_EQUALS(numObj() - 1, stats->docsDeleted);
+        ASSERT_EQUALS(0, coll->numRecords(&_txn));
+    }
+};
+
+/**
+ * Test that a write conflict part way through a batch rolls back the documents of the batch which
+ * were already deleted, and that the whole batch is deleted when it is retried.
+ */
+class QueryStageDeleteBatchedWriteConflict : public QueryStageDeleteBase {
+public:
+    void run() {
+        // Documents waiting in a batch are not notified of invalidations.
+        if (!supportsDocLocking()) {
+            return;
+        }
+
+        OldClientWriteContext ctx(&_txn, nss.ns());
+
+        Collection* coll = ctx.getCollection();
+
+        CollectionScanParams collScanParams;
+        collScanParams.collection = coll;
+        collScanParams.direction = CollectionScanParams::FORWARD;
+        collScanParams.tailable = false;
+
+        DeleteStageParams deleteStageParams;
+        deleteStageParams.isMulti = true;
+        deleteStageParams.batched = true;
+
+        WorkingSet ws;
+        DeleteStage deleteStage(&_txn,
+                                deleteStageParams,
+                                &ws,
+                                coll,
+                                new CollectionScan(&_txn, collScanParams, &ws, NULL));
+
+        const DeleteStats* stats = static_cast<const DeleteStats*>(deleteStage.getSpecificStats());
+
+        write_stage_common::writeConflictInWriteBatch.setMode(FailPoint::nTimes, 1);
+        ON_BLOCK_EXIT(
+            [] { write_stage_common::writeConflictInWriteBatch.setMode(FailPoint::off); });
+
+        size_t numYields = 0;
+        while (!deleteStage.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            if (PlanStage::NEED_YIELD == state) {
+                // The first document of the batch was deleted before the conflict. It must be
+                // back, and not counted.
+                ++numYields;
+                ASSERT_EQUALS(0U, stats->docsDeleted);
+                ASSERT_EQUALS(static_cast<long long>(numObj()), coll->numRecords(&_txn));
+
+                deleteStage.saveState();
+                _txn.recoveryUnit()->abandonSnapshot();
+                deleteStage.restoreState();
+                continue;
+            }
+            ASSERT(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+        }
+
+        ASSERT_EQUALS(1U, numYields);
+        ASSERT_EQUALS(numObj(), stats->docsDeleted);
+        ASSERT_EQUALS(0, coll->numRecords(&_txn));
+    }
+};
+
+/**
+ * Test that a document our child returns twice within a batch, as it may after a yield, is only
+ * deleted once.
+ */
+class QueryStageDeleteBatchedDuplicate : public QueryStageDeleteBase {
+public:
+    void run() {
+        // Documents waiting in a batch are not notified of invalidations.
+        if (!supportsDocLocking()) {
+            return;
+        }
+
+        OldClientWriteContext ctx(&_txn, nss.ns());
+        Collection* coll = ctx.getCollection();
+
+        vector<RecordId> recordIds;
+        getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+
+        // Queue the first document twice, each copy as read in the current snapshot so that
+        // neither is refetched.
+        WorkingSet ws;
+        auto qds = make_unique<QueuedDataStage>(&_txn, &ws);
+        for (int i = 0; i < 2; ++i) {
+            WorkingSetID id = ws.allocate();
+            WorkingSetMember* member = ws.get(id);
+            member->recordId = recordIds[0];
+            member->obj = coll->docFor(&_txn, recordIds[0]);
+            ws.transitionToRecordIdAndObj(id);
+            qds->pushBack(id);
+        }
+
+        DeleteStageParams deleteStageParams;
+        deleteStageParams.isMulti = true;
+        deleteStageParams.batched = true;
+
+        DeleteStage deleteStage(&_txn, deleteStageParams, &ws, coll, qds.release());
+
+        const DeleteStats* stats = static_cast<const DeleteStats*>(deleteStage.getSpecificStats());
+
+        while (!deleteStage.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            ASSERT(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+        }
+
+        ASSERT_EQUALS(1U, stats->docsDeleted);
+        ASSERT_EQUALS(static_cast<long long>(numObj()) - 1, coll->numRecords(&_txn));
+    }
+};
+
 /**
  * Test that the delete stage returns an owned copy of the original document if returnDeleted is
  * specified.
@@ -314,6 +493,9 @@ public:
     void setupTests() {
         // Stage-specific tests below.
         add<QueryStageDeleteInvalidateUpcomingObject>();
+        add<QueryStageDeleteBatched>();
+        add<QueryStageDeleteBatchedWriteConflict>();
+        add<QueryStageDeleteBatchedDuplicate>();
         add<QueryStageDeleteReturnOldDoc>();
         add<QueryStageDeleteSkipOwnedObjects>();
     }
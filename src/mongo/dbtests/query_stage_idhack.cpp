@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+/**
+ * This file tests db/exec/idhack.cpp and the point read path which gets a query by _id to it.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
+#include "mongo/util/timer.h"
+
+namespace QueryStageIDHack {
+
+using std::unique_ptr;
+
+static const NamespaceString nss("unittests.QueryStageIDHack");
+
+const int kDocuments = 100;
+
+class IDHackBase {
+public:
+    IDHackBase() : _client(&_txn) {
+        _client.dropCollection(nss.ns());
+        for (int i = 0; i < kDocuments; i++) {
+            _client.insert(nss.ns(), BSON("_id" << i << "x" << i));
+        }
+    }
+
+    virtual ~IDHackBase() {
+        _client.dropCollection(nss.ns());
+    }
+
+    /**
+     * Builds the executor a find command with 'filter' would run, the same way the find command
+     * does it.
+     */
+    unique_ptr<PlanExecutor> makeExecutor(Collection* collection, const BSONObj& filter) {
+        auto qr = stdx::make_unique<QueryRequest>(nss);
+        qr->setFilter(filter);
+        auto cq = unittest::assertGet(CanonicalQuery::canonicalize(
+            &_txn, std::move(qr), ExtensionsCallbackDisallowExtensions()));
+        return unittest::assertGet(
+            getExecutorFind(&_txn, collection, nss, std::move(cq), PlanExecutor::YIELD_MANUAL));
+    }
+
+protected:
+    const ServiceContext::UniqueOperationContext _txnPtr = cc().makeOperationContext();
+    OperationContext& _txn = *_txnPtr;
+    DBDirectClient _client;
+};
+
+/**
+ * A query by _id runs as an IDHACK plan and returns the document.
+ */
+class IDHackFindsDocument : public IDHackBase {
+public:
+    void run() {
+        AutoGetCollectionForRead ctx(&_txn, nss);
+        auto exec = makeExecutor(ctx.getCollection(), BSON("_id" << 7));
+        ASSERT_EQUALS(STAGE_IDHACK, exec->getRootStage()->stageType());
+
+        BSONObj obj;
+        ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&obj, NULL));
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 7 << "x" << 7), obj);
+        ASSERT_EQUALS(PlanExecutor::IS_EOF, exec->getNext(&obj, NULL));
+    }
+};
+
+/**
+ * A query by an _id which does not exist runs as an IDHACK plan and returns nothing.
+ */
+class IDHackMissingDocument : public IDHackBase {
+public:
+    void run() {
+        AutoGetCollectionForRead ctx(&_txn, nss);
+        auto exec = makeExecutor(ctx.getCollection(), BSON("_id" << kDocuments));
+        ASSERT_EQUALS(STAGE_IDHACK, exec->getRootStage()->stageType());
+
+        BSONObj obj;
+        ASSERT_EQUALS(PlanExecutor::IS_EOF, exec->getNext(&obj, NULL));
+    }
+};
+
+/**
+ * Measures the latency of point reads by _id through the whole find path: canonicalizing the
+ * query, building the executor and its working set, and fetching the document.
+ */
+class IDHackPointReadLatency : public IDHackBase {
+public:
+    void run() {
+        const int kReads = 20000;
+
+        AutoGetCollectionForRead ctx(&_txn, nss);
+        Collection* collection = ctx.getCollection();
+
+        Timer timer;
+        for (int i = 0; i < kReads; i++) {
+            auto exec = makeExecutor(collection, BSON("_id" << i % kDocuments));
+            BSONObj obj;
+            ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&obj, NULL));
+        }
+        const long long micros = timer.micros();
+
+        mongo::log() << "idhack point read: " << kReads << " reads in " << micros / 1000
+                     << "ms, " << static_cast<double>(micros) / kReads << "us per read";
+    }
+};
+
+class All : public Suite {
+public:
+    All() : Suite("query_stage_idhack") {}
+
+    void setupTests() {
+        add<IDHackFindsDocument>();
+        add<IDHackMissingDocument>();
+        add<IDHackPointReadLatency>();
+    }
+};
+
+SuiteInstance<All> queryStageIDHackAll;
+
+}  // namespace QueryStageIDHack
@@ -52,6 +52,7 @@
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -393,6 +394,96 @@ private:
     }
 };
 
+// Test that a plan which is clearly less productive than another stops being worked before the
+// trial period ends, and that the winning plan still runs to the end of the trial period.
+class MPSEarlyCutoff : public QueryStageMultiPlanBase {
+public:
+    void run() {
+        // Insert a document to create the collection.
+        insert(BSON("x" << 1));
+
+        bool earlyCutoffOldValue = internalQueryPlanEvaluationEarlyCutoff.load();
+        ON_BLOCK_EXIT([earlyCutoffOldValue] {
+            internalQueryPlanEvaluationEarlyCutoff.store(earlyCutoffOldValue);
+        });
+
+        internalQueryPlanEvaluationEarlyCutoff.store(true);
+        BSONObj explained = runTwoPlans();
+        int minWorks = internalQueryPlanEvaluationCutoffMinWorks.load();
+        int maxEvaluationResults = internalQueryPlanEvaluationMaxResults;
+        ASSERT_EQ(explained["executionStats"]["trialPeriod"]["plansCutOff"].numberLong(), 1LL);
+        for (auto&& planStats : explained["executionStats"]["allPlansExecution"].Array()) {
+            if (planStats["executionStages"]["needTime"].Int() > 0) {
+                // The losing plan should have been cut off as soon as it was eligible.
+                ASSERT_EQ(planStats["executionStages"]["works"].Int(), minWorks);
+            } else {
+                ASSERT_EQ(planStats["nReturned"].Int(), maxEvaluationResults);
+            }
+        }
+
+        internalQueryPlanEvaluationEarlyCutoff.store(false);
+        explained = runTwoPlans();
+        ASSERT_EQ(explained["executionStats"]["trialPeriod"]["plansCutOff"].numberLong(), 0LL);
+        for (auto&& planStats : explained["executionStats"]["allPlansExecution"].Array()) {
+            // Without the cutoff both plans are worked for the whole trial period.
+            ASSERT_GT(planStats["executionStages"]["works"].Int(), minWorks);
+        }
+    }
+
+private:
+    /**
+     * Races a plan which returns a result on every work against one which returns a result on
+     * every tenth work, and returns the explain output.
+     */
+    BSONObj runTwoPlans() {
+        const int nDocs = 500;
+
+        auto ws = stdx::make_unique<WorkingSet>();
+        auto firstPlan = stdx::make_unique<QueuedDataStage>(&_txn, ws.get());
+        auto secondPlan = stdx::make_unique<QueuedDataStage>(&_txn, ws.get());
+
+        for (int i = 0; i < nDocs; ++i) {
+            addMember(firstPlan.get(), ws.get());
+            addMember(secondPlan.get(), ws.get());
+            for (int j = 0; j < 9; ++j) {
+                secondPlan->pushBack(PlanStage::NEED_TIME);
+            }
+        }
+
+        AutoGetCollectionForRead ctx(&_txn, nss.ns());
+
+        auto qr = stdx::make_unique<QueryRequest>(nss);
+        qr->setFilter(BSON("x" << 1));
+        auto cq = uassertStatusOK(CanonicalQuery::canonicalize(
+            txn(), std::move(qr), ExtensionsCallbackDisallowExtensions()));
+        unique_ptr<MultiPlanStage> mps =
+            make_unique<MultiPlanStage>(&_txn, ctx.getCollection(), cq.get());
+
+        mps->addPlan(new QuerySolution(), firstPlan.release(), ws.get());
+        mps->addPlan(new QuerySolution(), secondPlan.release(), ws.get());
+
+        auto exec = uassertStatusOK(PlanExecutor::make(
+            &_txn, std::move(ws), std::move(mps), ctx.getCollection(), PlanExecutor::YIELD_MANUAL));
+
+        auto root = static_cast<MultiPlanStage*>(exec->getRootStage());
+        ASSERT_TRUE(root->bestPlanChosen());
+        ASSERT_EQ(root->bestPlanIdx(), 0);
+
+        BSONObjBuilder bob;
+        Explain::explainStages(
+            exec.get(), ctx.getCollection(), ExplainCommon::EXEC_ALL_PLANS, &bob);
+        return bob.obj();
+    }
+
+    void addMember(QueuedDataStage* qds, WorkingSet* ws) {
+        WorkingSetID id = ws->allocate();
+        WorkingSetMember* wsm = ws->get(id);
+        wsm->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("x" << 1));
+        wsm->transitionToOwnedObj();
+        qds->pushBack(id);
+    }
+};
+
 // Test that the plan summary only includes stats from the winning plan.
 //
 // This is a regression test for SERVER-20111.
@@ -441,6 +532,7 @@ public:
         add<MPSCollectionScanVsHighlySelectiveIXScan>();
         add<MPSBackupPlan>();
         add<MPSExplainAllPlans>();
+        add<MPSEarlyCutoff>();
         add<MPSSummaryStats>();
     }
 };
@@ -43,6 +43,7 @@
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/exec/update.h"
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/write_stage_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
@@ -53,6 +54,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageUpdate {
 
@@ -355,6 +357,283 @@ public:
     }
 };
 
+/**
+ * Test that a batched multi-update queues the documents returned by its child and updates them
+ * when the batch is written.
+ */
+class QueryStageUpdateBatched : public QueryStageUpdateBase {
+public:
+    void run() {
+        // Documents waiting in a batch are not notified of invalidations.
+        if (!supportsDocLocking()) {
+            return;
+        }
+
+        {
+            OldClientWriteContext ctx(&_txn, nss.ns());
+
+            for (int i = 0; i < 10; ++i) {
+                insert(BSON("_id" << i << "foo" << i));
+            }
+
+            OpDebug* opDebug = &CurOp::get(_txn)->debug();
+            UpdateDriver driver((UpdateDriver::Options()));
+            Collection* coll = ctx.getCollection();
+
+            UpdateRequest request(nss);
+            UpdateLifecycleImpl updateLifecycle(nss);
+            request.setLifecycle(&updateLifecycle);
+
+            // Update is a multi-update that sets 'bar' to 3 in every document where foo is less
+            // than 5.
+            BSONObj query = fromjson("{foo: {$lt: 5}}");
+            BSONObj updates = fromjson("{$set: {bar: 3}}");
+
+            request.setMulti();
+            request.setQuery(query);
+            request.setUpdates(updates);
+
+            ASSERT_OK(driver.parse(request.getUpdates(), request.isMulti()));
+
+            CollectionScanParams collScanParams;
+            collScanParams.collection = coll;
+            collScanParams.direction = CollectionScanParams::FORWARD;
+            collScanParams.tailable = false;
+
+            UpdateStageParams updateParams(&request, &driver, opDebug);
+            unique_ptr<CanonicalQuery> cq(canonicalize(query));
+            updateParams.canonicalQuery = cq.get();
+            updateParams.batched = true;
+
+            auto ws = make_unique<WorkingSet>();
+            auto cs = make_unique<CollectionScan>(&_txn, collScanParams, ws.get(), cq->root());
+
+            auto updateStage =
+                make_unique<UpdateStage>(&_txn, updateParams, ws.get(), coll, cs.release());
+
+            const UpdateStats* stats =
+                static_cast<const UpdateStats*>(updateStage->getSpecificStats());
+
+            // Queue a few documents without filling the batch. Nothing gets updated yet.
+            for (int i = 0; i < 3; ++i) {
+                WorkingSetID id = WorkingSet::INVALID_ID;
+                ASSERT_EQUALS(PlanStage::NEED_TIME, updateStage->work(&id));
+            }
+            ASSERT_EQUALS(0U, stats->nMatched);
+            ASSERT_EQUALS(0U, count(BSON("bar" << 3)));
+
+            runUpdate(updateStage.get());
+
+            ASSERT_EQUALS(5U, stats->nMatched);
+            ASSERT_EQUALS(5U, stats->nModified);
+        }
+
+        {
+            AutoGetCollectionForRead ctx(&_txn, nss.ns());
+            Collection* collection = ctx.getCollection();
+
+            vector<BSONObj> objs;
+            getCollContents(collection, &objs);
+
+            ASSERT_EQUALS(10U, objs.size());
+            assertHasDoc(objs, fromjson("{_id: 0, foo: 0, bar: 3}"));
+            assertHasDoc(objs, fromjson("{_id: 4, foo: 4, bar: 3}"));
+            assertHasDoc(objs, fromjson("{_id: 5, foo: 5}"));
+            assertHasDoc(objs, fromjson("{_id: 9, foo: 9}"));
+        }
+    }
+};
+
+/**
+ * Test that a write conflict part way through a batch rolls back the documents of the batch which
+ * were already updated along with the stats, and that every document is updated exactly once when
+ * the batch is retried.
+ */
+class QueryStageUpdateBatchedWriteConflict : public QueryStageUpdateBase {
+public:
+    void run() {
+        // Documents waiting in a batch are not notified of invalidations.
+        if (!supportsDocLocking()) {
+            return;
+        }
+
+        {
+            OldClientWriteContext ctx(&_txn, nss.ns());
+
+            for (int i = 0; i < 10; ++i) {
+                insert(BSON("_id" << i << "foo" << i));
+            }
+
+            OpDebug* opDebug = &CurOp::get(_txn)->debug();
+            UpdateDriver driver((UpdateDriver::Options()));
+            Collection* coll = ctx.getCollection();
+
+            UpdateRequest request(nss);
+            UpdateLifecycleImpl updateLifecycle(nss);
+            request.setLifecycle(&updateLifecycle);
+
+            BSONObj query = fromjson("{}");
+            BSONObj updates = fromjson("{$inc: {bar: 1}}");
+
+            request.setMulti();
+            request.setQuery(query);
+            request.setUpdates(updates);
+
+            ASSERT_OK(driver.parse(request.getUpdates(), request.isMulti()));
+
+            CollectionScanParams collScanParams;
+            collScanParams.collection = coll;
+            collScanParams.direction = CollectionScanParams::FORWARD;
+            collScanParams.tailable = false;
+
+            UpdateStageParams updateParams(&request, &driver, opDebug);
+            unique_ptr<CanonicalQuery> cq(canonicalize(query));
+            updateParams.canonicalQuery = cq.get();
+            updateParams.batched = true;
+
+            auto ws = make_unique<WorkingSet>();
+            auto cs = make_unique<CollectionScan>(&_txn, collScanParams, ws.get(), cq->root());
+
+            auto updateStage =
+                make_unique<UpdateStage>(&_txn, updateParams, ws.get(), coll, cs.release());
+
+            const UpdateStats* stats =
+                static_cast<const UpdateStats*>(updateStage->getSpecificStats());
+
+            write_stage_common::writeConflictInWriteBatch.setMode(FailPoint::nTimes, 1);
+            ON_BLOCK_EXIT(
+                [] { write_stage_common::writeConflictInWriteBatch.setMode(FailPoint::off); });
+
+            size_t numYields = 0;
+            while (!updateStage->isEOF()) {
+                WorkingSetID id = WorkingSet::INVALID_ID;
+                PlanStage::StageState state = updateStage->work(&id);
+                if (PlanStage::NEED_YIELD == state) {
+                    ++numYields;
+                    ASSERT_EQUALS(0U, stats->nMatched);
+                    ASSERT_EQUALS(0U, stats->nModified);
+
+                    updateStage->saveState();
+                    _txn.recoveryUnit()->abandonSnapshot();
+
+                    // The first document of the batch was updated before the conflict. It must
+                    // have been rolled back.
+                    vector<BSONObj> objs;
+                    getCollContents(coll, &objs);
+                    for (const auto& obj : objs) {
+                        ASSERT(!obj.hasField("bar"));
+                    }
+
+                    updateStage->restoreState();
+                    continue;
+                }
+                ASSERT(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+            }
+
+            ASSERT_EQUALS(1U, numYields);
+            ASSERT_EQUALS(10U, stats->nMatched);
+            ASSERT_EQUALS(10U, stats->nModified);
+        }
+
+        {
+            AutoGetCollectionForRead ctx(&_txn, nss.ns());
+            Collection* collection = ctx.getCollection();
+
+            vector<BSONObj> objs;
+            getCollContents(collection, &objs);
+
+            ASSERT_EQUALS(10U, objs.size());
+            for (const auto& obj : objs) {
+                ASSERT_EQUALS(1, obj["bar"].numberInt());
+            }
+        }
+    }
+};
+
+/**
+ * Test that a document our child returns twice within a batch, as it may after a yield, is only
+ * updated once.
+ */
+class QueryStageUpdateBatchedDuplicate : public QueryStageUpdateBase {
+public:
+    void run() {
+        // Documents waiting in a batch are not notified of invalidations.
+        if (!supportsDocLocking()) {
+            return;
+        }
+
+        {
+            OldClientWriteContext ctx(&_txn, nss.ns());
+
+            for (int i = 0; i < 2; ++i) {
+                insert(BSON("_id" << i << "foo" << i));
+            }
+
+            OpDebug* opDebug = &CurOp::get(_txn)->debug();
+            UpdateDriver driver((UpdateDriver::Options()));
+            Collection* coll = ctx.getCollection();
+
+            UpdateRequest request(nss);
+            UpdateLifecycleImpl updateLifecycle(nss);
+            request.setLifecycle(&updateLifecycle);
+
+            BSONObj query = fromjson("{}");
+            BSONObj updates = fromjson("{$inc: {bar: 1}}");
+
+            request.setMulti();
+            request.setQuery(query);
+            request.setUpdates(updates);
+
+            ASSERT_OK(driver.parse(request.getUpdates(), request.isMulti()));
+
+            vector<RecordId> recordIds;
+            getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+
+            // Queue the first document, the second one and the first one again, each as read in
+            // the current snapshot so that none of them is refetched.
+            auto ws = make_unique<WorkingSet>();
+            auto qds = make_unique<QueuedDataStage>(&_txn, ws.get());
+            for (const auto& recordId : {recordIds[0], recordIds[1], recordIds[0]}) {
+                WorkingSetID id = ws->allocate();
+                WorkingSetMember* member = ws->get(id);
+                member->recordId = recordId;
+                member->obj = coll->docFor(&_txn, recordId);
+                ws->transitionToRecordIdAndObj(id);
+                qds->pushBack(id);
+            }
+
+            UpdateStageParams updateParams(&request, &driver, opDebug);
+            unique_ptr<CanonicalQuery> cq(canonicalize(query));
+            updateParams.canonicalQuery = cq.get();
+            updateParams.batched = true;
+
+            auto updateStage =
+                make_unique<UpdateStage>(&_txn, updateParams, ws.get(), coll, qds.release());
+
+            const UpdateStats* stats =
+                static_cast<const UpdateStats*>(updateStage->getSpecificStats());
+
+            runUpdate(updateStage.get());
+
+            ASSERT_EQUALS(2U, stats->nMatched);
+            ASSERT_EQUALS(2U, stats->nModified);
+        }
+
+        {
+            AutoGetCollectionForRead ctx(&_txn, nss.ns());
+            Collection* collection = ctx.getCollection();
+
+            vector<BSONObj> objs;
+            getCollContents(collection, &objs);
+
+            ASSERT_EQUALS(2U, objs.size());
+            for (const auto& obj : objs) {
+                ASSERT_EQUALS(1, obj["bar"].numberInt());
+            }
+        }
+    }
+};
+
 /**
  * Test that the update stage returns an owned copy of the original document if
  * ReturnDocOption::RETURN_OLD is specified.
@@ -600,6 +879,9 @@ public:
         // Stage-specific tests below.
         add<QueryStageUpdateUpsertEmptyColl>();
         add<QueryStageUpdateSkipInvalidatedDoc>();
+        add<QueryStageUpdateBatched>();
+        add<QueryStageUpdateBatchedWriteConflict>();
+        add<QueryStageUpdateBatchedDuplicate>();
         add<QueryStageUpdateReturnOldDoc>();
         add<QueryStageUpdateReturnNewDoc>();
         add<QueryStageUpdateSkipOwnedObjects>();
@@ -42,7 +42,7 @@
 #include "mongo/util/scopeguard.h"
 
 // One interesting implementation note herein concerns how setup() and
-// refresh() are invoked outside of the global lock, but setTimeout is not.
+// refresh() are invoked outside of the specific pool's lock, but setTimeout is not.
 // This implementation detail simplifies mocks, allowing them to return
 // synchronously sometimes, whereas having timeouts fire instantly adds little
 // value. In practice, dumping the locks is always safe (because we restrict
@@ -67,7 +67,7 @@ public:
      *
      * The complexity comes from the need to hold a lock when writing to the
      * _activeClients param on the specific pool.  Because the code beneath the client needs to lock
-     * and unlock the parent mutex (and can leave unlocked), we want to start the client with the
+     * and unlock the pool's mutex (and can leave unlocked), we want to start the client with the
      * lock acquired, move it into the client, then re-acquire to decrement the counter on the way
      * out.
      *
@@ -77,34 +77,39 @@ public:
      */
     template <typename Callback>
     void runWithActiveClient(Callback&& cb) {
-        runWithActiveClient(stdx::unique_lock<stdx::mutex>(_parent->_mutex),
-                            std::forward<Callback>(cb));
+        runWithActiveClientInLock(stdx::unique_lock<stdx::mutex>(_mutex),
+                                  std::forward<Callback>(cb));
     }
 
+    /**
+     * Enters the specific pool after it was looked up in the parent's host map.  Sinks the lock on
+     * the parent's mutex, which is only released once this pool's mutex is held, so that the pool
+     * cannot be shut down in between.
+     */
     template <typename Callback>
-    void runWithActiveClient(stdx::unique_lock<stdx::mutex> lk, Callback&& cb) {
-        invariant(lk.owns_lock());
+    void runWithActiveClient(stdx::unique_lock<stdx::mutex> parentLk, Callback&& cb) {
+        invariant(parentLk.owns_lock());
 
-        _activeClients++;
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        parentLk.unlock();
 
-        const auto guard = MakeGuard([&] {
-            invariant(!lk.owns_lock());
-            stdx::lock_guard<stdx::mutex> lk(_parent->_mutex);
-            _activeClients--;
-        });
-
-        {
-            decltype(lk) localLk(std::move(lk));
-            cb(std::move(localLk));
-        }
+        runWithActiveClientInLock(std::move(lk), std::forward<Callback>(cb));
     }
 
     SpecificPool(ConnectionPool* parent, const HostAndPort& hostAndPort);
     ~SpecificPool();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Acquires this pool's mutex. The caller must hold the parent's mutex, so that the pool
+     * cannot be shut down in the meantime.
+     */
+    stdx::unique_lock<stdx::mutex> lock() {
+        return stdx::unique_lock<stdx::mutex>(_mutex);
+    }
+
+    /**
+     * Gets a connection from the specific pool. Sinks a unique_lock on this
+     * pool's _mutex
      */
     void getConnection(const HostAndPort& hostAndPort,
                        Milliseconds timeout,
@@ -119,8 +124,8 @@ public:
     void processFailure(const Status& status, stdx::unique_lock<stdx::mutex> lk);
 
     /**
-     * Returns a connection to a specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Returns a connection to a specific pool. Sinks a unique_lock on this
+     * pool's _mutex
      */
     void returnConnection(ConnectionInterface* connection, stdx::unique_lock<stdx::mutex> lk);
 
@@ -174,9 +179,32 @@ private:
 
     void updateStateInLock();
 
+    template <typename Callback>
+    void runWithActiveClientInLock(stdx::unique_lock<stdx::mutex> lk, Callback&& cb) {
+        invariant(lk.owns_lock());
+
+        _activeClients++;
+
+        const auto guard = MakeGuard([&] {
+            invariant(!lk.owns_lock());
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _activeClients--;
+        });
+
+        {
+            decltype(lk) localLk(std::move(lk));
+            cb(std::move(localLk));
+        }
+    }
+
 private:
     ConnectionPool* const _parent;
 
+    // Synchronizes access to all of the state of this pool below.  Each host has its own mutex,
+    // so that checking connections out and in for one host does not contend with other hosts.
+    // When both are needed, the parent's mutex must be acquired first.
+    stdx::mutex _mutex;
+
     const HostAndPort _hostAndPort;
 
     OwnershipPool _readyPool;
@@ -284,10 +312,11 @@ void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
         HostAndPort host = kv.first;
 
         auto& pool = kv.second;
-        ConnectionStatsPer hostStats{pool->inUseConnections(lk),
-                                     pool->availableConnections(lk),
-                                     pool->createdConnections(lk),
-                                     pool->refreshingConnections(lk)};
+        auto poolLk = pool->lock();
+        ConnectionStatsPer hostStats{pool->inUseConnections(poolLk),
+                                     pool->availableConnections(poolLk),
+                                     pool->createdConnections(poolLk),
+                                     pool->refreshingConnections(poolLk)};
         stats->updateStatsForHost(_name, host, hostStats);
     }
 }
@@ -296,7 +325,8 @@ size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort)
     stdx::unique_lock<stdx::mutex> lk(_mutex);
     auto iter = _pools.find(hostAndPort);
     if (iter != _pools.end()) {
-        return iter->second->openConnections(lk);
+        auto poolLk = iter->second->lock();
+        return iter->second->openConnections(poolLk);
     }
 
     return 0;
@@ -355,6 +385,28 @@ void ConnectionPool::SpecificPool::getConnection(const HostAndPort& hostAndPort,
                                                  Milliseconds timeout,
                                                  stdx::unique_lock<stdx::mutex> lk,
                                                  GetConnectionCallback cb) {
+    // Fast path: if nobody else is waiting and there is an idle connection around, hand it out
+    // right away, without queueing a request and arming the request timer for it.
+    if (_requests.empty() && !_readyPool.empty()) {
+        auto iter = _readyPool.begin();
+
+        if (iter->first->isHealthy()) {
+            auto conn = std::move(iter->second);
+            _readyPool.erase(iter);
+            conn->cancelTimeout();
+
+            auto connPtr = conn.get();
+            _checkedOutPool[connPtr] = std::move(conn);
+
+            updateStateInLock();
+
+            connPtr->resetToUnknown();
+            lk.unlock();
+            cb(ConnectionHandle(connPtr, ConnectionHandleDeleter(_parent)));
+            return;
+        }
+    }
+
     if (timeout < Milliseconds(0) || timeout > _parent->_options.refreshTimeout) {
         timeout = _parent->_options.refreshTimeout;
     }
@@ -665,7 +717,8 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
 
 // Called every second after hostTimeout until all processing connections reap
 void ConnectionPool::SpecificPool::shutdown() {
-    stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+    stdx::unique_lock<stdx::mutex> parentLk(_parent->_mutex);
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     // We're racing:
     //
@@ -699,7 +752,15 @@ void ConnectionPool::SpecificPool::shutdown() {
     invariant(_requests.empty());
     invariant(_checkedOutPool.empty());
 
-    _parent->_pools.erase(_hostAndPort);
+    // Take this pool out of the host map, but only destroy it once its own mutex is released.
+    // Nobody else can reach it anymore, since entering it requires the parent's mutex.
+    auto iter = _parent->_pools.find(_hostAndPort);
+    invariant(iter != _parent->_pools.end());
+    auto self = std::move(iter->second);
+    _parent->_pools.erase(iter);
+
+    lk.unlock();
+    parentLk.unlock();
 }
 
 ConnectionPool::SpecificPool::OwnedConnection ConnectionPool::SpecificPool::takeFromPool(
@@ -768,6 +829,10 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
         // If we have no requests, but someone's using a connection, we just
         // hang around until the next request or a return
 
+        // If we were already waiting on checked out connections, nothing to do
+        if (_state == State::kRunning && _requestTimerExpiration == _requestTimerExpiration.max())
+            return;
+
         _requestTimer->cancelTimeout();
         _state = State::kRunning;
         _requestTimerExpiration = _requestTimerExpiration.max();
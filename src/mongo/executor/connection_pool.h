@@ -144,7 +144,8 @@ private:
 
     const std::unique_ptr<DependentTypeFactoryInterface> _factory;
 
-    // The global mutex for specific pool access and the generation counter
+    // The global mutex for the host map.  The state of each specific pool is protected by a mutex
+    // of its own, which is taken once the pool has been looked up.
     mutable stdx::mutex _mutex;
     stdx::unordered_map<HostAndPort, std::unique_ptr<SpecificPool>> _pools;
 };
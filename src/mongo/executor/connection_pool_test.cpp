@@ -32,6 +32,7 @@
 #include "mongo/executor/connection_pool.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -1121,6 +1122,75 @@ TEST_F(ConnectionPoolTest, RefreshTimeoutsDontTimeoutRequests) {
     ASSERT(!conn2);
 }
 
+/**
+ * Verify that connections can be checked out and back in from several threads at once, each
+ * talking to a host of its own, and that the idle connection of each host is reused.
+ */
+TEST_F(ConnectionPoolTest, MultiThreadedCheckoutAndCheckin) {
+    const size_t kNumThreads = 8;
+    const size_t kIterations = 100;
+
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool");
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    std::vector<HostAndPort> hosts;
+    for (size_t i = 0; i < kNumThreads; ++i) {
+        hosts.emplace_back("host" + std::to_string(i), 27017);
+    }
+
+    // Establish one connection per host up front, so that the threads below only ever check out
+    // idle connections.
+    for (const auto& host : hosts) {
+        ConnectionImpl::pushSetup(Status::OK());
+        pool.get(host,
+                 Milliseconds(5000),
+                 [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                     ASSERT(swConn.isOK());
+                     doneWith(swConn.getValue());
+                 });
+        ASSERT_EQ(1U, pool.getNumConnectionsPerHost(host));
+    }
+
+    // Each thread records the first failure it sees, to be checked once all threads are done
+    std::vector<Status> statuses(kNumThreads, Status::OK());
+    std::vector<stdx::thread> threads;
+    for (size_t t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < kIterations && statuses[t].isOK(); ++i) {
+                bool reached = false;
+                pool.get(hosts[t],
+                         Milliseconds(5000),
+                         [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                             reached = true;
+                             if (!swConn.isOK()) {
+                                 statuses[t] = swConn.getStatus();
+                                 return;
+                             }
+                             doneWith(swConn.getValue());
+                         });
+                if (!reached) {
+                    statuses[t] =
+                        Status(ErrorCodes::InternalError, "idle connection was not handed out");
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& status : statuses) {
+        ASSERT_OK(status);
+    }
+
+    // Every host still has its single connection
+    for (const auto& host : hosts) {
+        ASSERT_EQ(1U, pool.getNumConnectionsPerHost(host));
+    }
+}
+
 }  // namespace connection_pool_test_details
 }  // namespace executor
 }  // namespace mongo
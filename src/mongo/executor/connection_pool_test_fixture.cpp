@@ -45,29 +45,37 @@ void TimerImpl::setTimeout(Milliseconds timeout, TimeoutCallback cb) {
     _cb = std::move(cb);
     _expiration = _global->now() + timeout;
 
+    stdx::lock_guard<stdx::mutex> lk(_timersMutex);
     _timers.emplace(this);
 }
 
 void TimerImpl::cancelTimeout() {
+    stdx::lock_guard<stdx::mutex> lk(_timersMutex);
     _timers.erase(this);
 }
 
 void TimerImpl::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_timersMutex);
     _timers.clear();
 }
 
 void TimerImpl::fireIfNecessary() {
     auto now = PoolImpl().now();
 
+    stdx::unique_lock<stdx::mutex> lk(_timersMutex);
     auto timers = _timers;
 
     for (auto&& x : timers) {
         if (_timers.count(x) && (x->_expiration <= now)) {
+            // The callback may set or cancel timers itself
+            lk.unlock();
             x->_cb();
+            lk.lock();
         }
     }
 }
 
+stdx::mutex TimerImpl::_timersMutex;
 std::set<TimerImpl*> TimerImpl::_timers;
 
 ConnectionImpl::ConnectionImpl(const HostAndPort& hostAndPort, size_t generation, PoolImpl* global)
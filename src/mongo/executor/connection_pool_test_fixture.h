@@ -30,6 +30,7 @@
 #include <set>
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 namespace executor {
@@ -57,6 +58,9 @@ public:
     static void clear();
 
 private:
+    // Timers are set and cancelled as connections are checked in and out, which multi-threaded
+    // tests do concurrently.
+    static stdx::mutex _timersMutex;
     static std::set<TimerImpl*> _timers;
 
     TimeoutCallback _cb;
@@ -32,8 +32,11 @@
 
 #include "mongo/s/query/cluster_cursor_manager.h"
 
+#include <functional>
 #include <set>
 
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/clock_source.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -173,19 +176,25 @@ void ClusterCursorManager::PinnedCursor::returnAndKillCursor() {
 
 ClusterCursorManager::ClusterCursorManager(ClockSource* clockSource)
     : _clockSource(clockSource),
-      _pseudoRandom(std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64()) {
+      _prefixPseudoRandom(std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64()) {
     invariant(_clockSource);
+
+    std::unique_ptr<SecureRandom> secureRandom(SecureRandom::create());
+    for (size_t i = 0; i < kNumPartitions; i++) {
+        _partitions.emplace_back(stdx::make_unique<Partition>(i, secureRandom->nextInt64()));
+    }
 }
 
 ClusterCursorManager::~ClusterCursorManager() {
+    for (const auto& partition : _partitions) {
+        invariant(partition->namespaceToContainerMap.empty());
+    }
+    invariant(_namespaceToPrefixMap.empty());
     invariant(_cursorIdPrefixToNamespaceMap.empty());
-    invariant(_namespaceToContainerMap.empty());
 }
 
 void ClusterCursorManager::shutdown() {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    _inShutdown = true;
-    lk.unlock();
+    _inShutdown.store(true);
 
     killAllCursors();
     reapZombieCursors();
@@ -199,9 +208,12 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     // Read the clock out of the lock.
     const auto now = _clockSource->now();
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    Partition& partition = getPartitionForRegistration();
+    stdx::unique_lock<stdx::mutex> lk(partition.mutex);
 
-    if (_inShutdown) {
+    // The shutdown flag is checked under the partition mutex, so that killAllCursors() in
+    // shutdown() is guaranteed to see any cursor registered here.
+    if (_inShutdown.load()) {
         lk.unlock();
         cursor->kill();
         return Status(ErrorCodes::ShutdownInProgress,
@@ -211,21 +223,13 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     invariant(cursor);
 
     // Find the CursorEntryContainer for this namespace.  If none exists, create one.
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    if (nsToContainerIt == _namespaceToContainerMap.end()) {
-        uint32_t containerPrefix = 0;
-        do {
-            // The server has always generated positive values for CursorId (which is a signed
-            // type), so we use std::abs() here on the prefix for consistency with this historical
-            // behavior.
-            containerPrefix = static_cast<uint32_t>(std::abs(_pseudoRandom.nextInt32()));
-        } while (_cursorIdPrefixToNamespaceMap.count(containerPrefix) > 0);
-        _cursorIdPrefixToNamespaceMap[containerPrefix] = nss;
+    auto nsToContainerIt = partition.namespaceToContainerMap.find(nss);
+    if (nsToContainerIt == partition.namespaceToContainerMap.end()) {
+        const uint32_t containerPrefix = acquireNamespacePrefix(nss);
 
         auto emplaceResult =
-            _namespaceToContainerMap.emplace(nss, CursorEntryContainer(containerPrefix));
+            partition.namespaceToContainerMap.emplace(nss, CursorEntryContainer(containerPrefix));
         invariant(emplaceResult.second);
-        invariant(_namespaceToContainerMap.size() == _cursorIdPrefixToNamespaceMap.size());
 
         nsToContainerIt = emplaceResult.first;
     } else {
@@ -233,11 +237,14 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     }
     CursorEntryContainer& container = nsToContainerIt->second;
 
-    // Generate a CursorId (which can't be the invalid value zero).
+    // Generate a CursorId (which can't be the invalid value zero).  The low bits of the suffix
+    // select the partition, so they are fixed to this partition's index.
     CursorEntryMap& entryMap = container.entryMap;
     CursorId cursorId = 0;
     do {
-        const uint32_t cursorSuffix = static_cast<uint32_t>(_pseudoRandom.nextInt32());
+        const uint32_t cursorSuffix = static_cast<uint32_t>(
+            (static_cast<uint32_t>(partition.pseudoRandom.nextInt32()) & ~(kNumPartitions - 1)) |
+            partition.index);
         cursorId = createCursorId(container.containerPrefix, cursorSuffix);
     } while (cursorId == 0 || entryMap.count(cursorId) > 0);
 
@@ -254,14 +261,15 @@ StatusWith<ClusterCursorManager::PinnedCursor> ClusterCursorManager::checkOutCur
     // Read the clock out of the lock.
     const auto now = _clockSource->now();
 
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    if (_inShutdown) {
+    if (_inShutdown.load()) {
         return Status(ErrorCodes::ShutdownInProgress,
                       "Cannot check out cursor as we are in the process of shutting down");
     }
 
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    Partition& partition = getPartition(cursorId);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+
+    CursorEntry* entry = getEntry_inlock(&partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -285,7 +293,8 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
                                          const NamespaceString& nss,
                                          CursorId cursorId,
                                          CursorState cursorState) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    Partition& partition = getPartition(cursorId);
+    stdx::unique_lock<stdx::mutex> lk(partition.mutex);
 
     invariant(cursor);
 
@@ -294,7 +303,7 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
     cursor->setOperationContext(nullptr);
     const bool remotesExhausted = cursor->remotesExhausted();
 
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    CursorEntry* entry = getEntry_inlock(&partition, nss, cursorId);
     invariant(entry);
 
 
@@ -313,7 +322,7 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
 
     // The cursor is exhausted, is not already scheduled for deletion, and does not have any
     // remote cursor state left to clean up. We can delete the cursor right away.
-    auto detachedCursor = detachCursor_inlock(nss, cursorId);
+    auto detachedCursor = detachCursor_inlock(&partition, nss, cursorId);
     invariantOK(detachedCursor.getStatus());
 
     // Deletion of the cursor can happen out of the lock.
@@ -322,9 +331,10 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
 }
 
 Status ClusterCursorManager::killCursor(const NamespaceString& nss, CursorId cursorId) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Partition& partition = getPartition(cursorId);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
 
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    CursorEntry* entry = getEntry_inlock(&partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -335,28 +345,34 @@ Status ClusterCursorManager::killCursor(const NamespaceString& nss, CursorId cur
 }
 
 void ClusterCursorManager::killMortalCursorsInactiveSince(Date_t cutoff) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            CursorEntry& entry = cursorIdEntryPair.second;
-            if (entry.getLifetimeType() == CursorLifetime::Mortal &&
-                entry.getLastActive() <= cutoff) {
-                entry.setInactive();
-                log() << "Marking cursor id " << cursorIdEntryPair.first
-                      << " for deletion, idle since " << entry.getLastActive().toString();
-                entry.setKillPending();
+    // Visit one partition at a time, so that the cleanup job never holds up checkouts in more than
+    // one partition.
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition->mutex);
+
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                CursorEntry& entry = cursorIdEntryPair.second;
+                if (entry.getLifetimeType() == CursorLifetime::Mortal &&
+                    entry.getLastActive() <= cutoff) {
+                    entry.setInactive();
+                    log() << "Marking cursor id " << cursorIdEntryPair.first
+                          << " for deletion, idle since " << entry.getLastActive().toString();
+                    entry.setKillPending();
+                }
             }
         }
     }
 }
 
 void ClusterCursorManager::killAllCursors() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition->mutex);
 
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            cursorIdEntryPair.second.setKillPending();
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                cursorIdEntryPair.second.setKillPending();
+            }
         }
     }
 }
@@ -371,73 +387,76 @@ std::size_t ClusterCursorManager::reapZombieCursors() {
         bool isInactive;
     };
 
-    // List all zombie cursors under the manager lock, and kill them one-by-one while not holding
-    // the lock (ClusterClientCursor::kill() is blocking, so we don't want to hold a lock while
-    // issuing the kill).
-
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    std::vector<CursorDescriptor> zombieCursorDescriptors;
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        const NamespaceString& nss = nsContainerPair.first;
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            CursorId cursorId = cursorIdEntryPair.first;
-            const CursorEntry& entry = cursorIdEntryPair.second;
-            if (!entry.getKillPending()) {
-                continue;
-            }
-            zombieCursorDescriptors.emplace_back(nss, cursorId, entry.isInactive());
-        }
-    }
-
     std::size_t cursorsTimedOut = 0;
 
-    for (auto& cursorDescriptor : zombieCursorDescriptors) {
-        StatusWith<std::unique_ptr<ClusterClientCursor>> zombieCursor =
-            detachCursor_inlock(cursorDescriptor.ns, cursorDescriptor.cursorId);
-        if (!zombieCursor.isOK()) {
-            // Cursor in use, or has already been deleted.
-            continue;
+    // Reap one partition at a time.  For each, list all zombie cursors under the partition lock,
+    // and kill them one-by-one while not holding the lock (ClusterClientCursor::kill() is
+    // blocking, so we don't want to hold a lock while issuing the kill).
+    for (const auto& partition : _partitions) {
+        stdx::unique_lock<stdx::mutex> lk(partition->mutex);
+        std::vector<CursorDescriptor> zombieCursorDescriptors;
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            const NamespaceString& nss = nsContainerPair.first;
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                CursorId cursorId = cursorIdEntryPair.first;
+                const CursorEntry& entry = cursorIdEntryPair.second;
+                if (!entry.getKillPending()) {
+                    continue;
+                }
+                zombieCursorDescriptors.emplace_back(nss, cursorId, entry.isInactive());
+            }
         }
 
-        lk.unlock();
-        zombieCursor.getValue()->setOperationContext(nullptr);
-        zombieCursor.getValue()->kill();
-        zombieCursor.getValue().reset();
-        lk.lock();
+        for (auto& cursorDescriptor : zombieCursorDescriptors) {
+            StatusWith<std::unique_ptr<ClusterClientCursor>> zombieCursor = detachCursor_inlock(
+                partition.get(), cursorDescriptor.ns, cursorDescriptor.cursorId);
+            if (!zombieCursor.isOK()) {
+                // Cursor in use, or has already been deleted.
+                continue;
+            }
+
+            lk.unlock();
+            zombieCursor.getValue()->setOperationContext(nullptr);
+            zombieCursor.getValue()->kill();
+            zombieCursor.getValue().reset();
+            lk.lock();
 
-        if (cursorDescriptor.isInactive) {
-            ++cursorsTimedOut;
+            if (cursorDescriptor.isInactive) {
+                ++cursorsTimedOut;
+            }
         }
     }
     return cursorsTimedOut;
 }
 
 ClusterCursorManager::Stats ClusterCursorManager::stats() const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
     Stats stats;
 
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            const CursorEntry& entry = cursorIdEntryPair.second;
-
-            if (entry.getKillPending()) {
-                // Killed cursors do not count towards the number of pinned cursors or the number of
-                // open cursors.
-                continue;
-            }
-
-            if (!entry.isCursorOwned()) {
-                ++stats.cursorsPinned;
-            }
-
-            switch (entry.getCursorType()) {
-                case CursorType::NamespaceNotSharded:
-                    ++stats.cursorsNotSharded;
-                    break;
-                case CursorType::NamespaceSharded:
-                    ++stats.cursorsSharded;
-                    break;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition->mutex);
+
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                const CursorEntry& entry = cursorIdEntryPair.second;
+
+                if (entry.getKillPending()) {
+                    // Killed cursors do not count towards the number of pinned cursors or the
+                    // number of open cursors.
+                    continue;
+                }
+
+                if (!entry.isCursorOwned()) {
+                    ++stats.cursorsPinned;
+                }
+
+                switch (entry.getCursorType()) {
+                    case CursorType::NamespaceNotSharded:
+                        ++stats.cursorsNotSharded;
+                        break;
+                    case CursorType::NamespaceSharded:
+                        ++stats.cursorsSharded;
+                        break;
+                }
             }
         }
     }
@@ -447,7 +466,7 @@ ClusterCursorManager::Stats ClusterCursorManager::stats() const {
 
 boost::optional<NamespaceString> ClusterCursorManager::getNamespaceForCursorId(
     CursorId cursorId) const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    stdx::lock_guard<stdx::mutex> lk(_prefixMutex);
 
     const auto it = _cursorIdPrefixToNamespaceMap.find(extractPrefixFromCursorId(cursorId));
     if (it == _cursorIdPrefixToNamespaceMap.end()) {
@@ -456,10 +475,61 @@ boost::optional<NamespaceString> ClusterCursorManager::getNamespaceForCursorId(
     return it->second;
 }
 
-ClusterCursorManager::CursorEntry* ClusterCursorManager::getEntry_inlock(const NamespaceString& nss,
-                                                                         CursorId cursorId) {
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    if (nsToContainerIt == _namespaceToContainerMap.end()) {
+ClusterCursorManager::Partition& ClusterCursorManager::getPartition(CursorId cursorId) {
+    return *_partitions[static_cast<uint64_t>(cursorId) & (kNumPartitions - 1)];
+}
+
+ClusterCursorManager::Partition& ClusterCursorManager::getPartitionForRegistration() {
+    const size_t threadHash = std::hash<stdx::thread::id>()(stdx::this_thread::get_id());
+    return *_partitions[threadHash % kNumPartitions];
+}
+
+uint32_t ClusterCursorManager::acquireNamespacePrefix(const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_prefixMutex);
+
+    auto nsToPrefixIt = _namespaceToPrefixMap.find(nss);
+    if (nsToPrefixIt != _namespaceToPrefixMap.end()) {
+        invariant(nsToPrefixIt->second.numPartitions < kNumPartitions);
+        ++nsToPrefixIt->second.numPartitions;
+        return nsToPrefixIt->second.prefix;
+    }
+
+    uint32_t containerPrefix = 0;
+    do {
+        // The server has always generated positive values for CursorId (which is a signed
+        // type), so we use std::abs() here on the prefix for consistency with this historical
+        // behavior.
+        containerPrefix = static_cast<uint32_t>(std::abs(_prefixPseudoRandom.nextInt32()));
+    } while (_cursorIdPrefixToNamespaceMap.count(containerPrefix) > 0);
+
+    _cursorIdPrefixToNamespaceMap[containerPrefix] = nss;
+    _namespaceToPrefixMap.emplace(nss, NamespacePrefix{containerPrefix, 1});
+    invariant(_namespaceToPrefixMap.size() == _cursorIdPrefixToNamespaceMap.size());
+
+    return containerPrefix;
+}
+
+void ClusterCursorManager::releaseNamespacePrefix(const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_prefixMutex);
+
+    auto nsToPrefixIt = _namespaceToPrefixMap.find(nss);
+    invariant(nsToPrefixIt != _namespaceToPrefixMap.end());
+    if (--nsToPrefixIt->second.numPartitions > 0) {
+        return;
+    }
+
+    // No partition holds cursors on the given namespace anymore.  Erase all state associated with
+    // this namespace.
+    size_t numDeleted = _cursorIdPrefixToNamespaceMap.erase(nsToPrefixIt->second.prefix);
+    invariant(numDeleted == 1);
+    _namespaceToPrefixMap.erase(nsToPrefixIt);
+    invariant(_namespaceToPrefixMap.size() == _cursorIdPrefixToNamespaceMap.size());
+}
+
+ClusterCursorManager::CursorEntry* ClusterCursorManager::getEntry_inlock(
+    Partition* partition, const NamespaceString& nss, CursorId cursorId) {
+    auto nsToContainerIt = partition->namespaceToContainerMap.find(nss);
+    if (nsToContainerIt == partition->namespaceToContainerMap.end()) {
         return nullptr;
     }
     CursorEntryMap& entryMap = nsToContainerIt->second.entryMap;
@@ -472,8 +542,8 @@ ClusterCursorManager::CursorEntry* ClusterCursorManager::getEntry_inlock(const N
 }
 
 StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::detachCursor_inlock(
-    const NamespaceString& nss, CursorId cursorId) {
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    Partition* partition, const NamespaceString& nss, CursorId cursorId) {
+    CursorEntry* entry = getEntry_inlock(partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -483,19 +553,15 @@ StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::detachCur
         return cursorInUseStatus(nss, cursorId);
     }
 
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    invariant(nsToContainerIt != _namespaceToContainerMap.end());
+    auto nsToContainerIt = partition->namespaceToContainerMap.find(nss);
+    invariant(nsToContainerIt != partition->namespaceToContainerMap.end());
     CursorEntryMap& entryMap = nsToContainerIt->second.entryMap;
     size_t eraseResult = entryMap.erase(cursorId);
     invariant(1 == eraseResult);
     if (entryMap.empty()) {
-        // This was the last cursor remaining in the given namespace.  Erase all state associated
-        // with this namespace.
-        size_t numDeleted =
-            _cursorIdPrefixToNamespaceMap.erase(nsToContainerIt->second.containerPrefix);
-        invariant(numDeleted == 1);
-        _namespaceToContainerMap.erase(nsToContainerIt);
-        invariant(_namespaceToContainerMap.size() == _cursorIdPrefixToNamespaceMap.size());
+        // This was the last cursor remaining in the given namespace in this partition.
+        partition->namespaceToContainerMap.erase(nsToContainerIt);
+        releaseNamespacePrefix(nss);
     }
 
     return std::move(cursor);
@@ -33,6 +33,7 @@
 
 #include "mongo/db/cursor_id.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/query/cluster_client_cursor.h"
 #include "mongo/stdx/mutex.h"
@@ -382,13 +383,50 @@ private:
                        CursorId cursorId,
                        CursorState cursorState);
 
+    /**
+     * Partition is a non-copyable container for a subset of the registered cursors, together with
+     * the mutex which synchronizes access to them.  A cursor always lives in the partition given
+     * by the low bits of its cursor id.
+     */
+    struct Partition;
+
+    /**
+     * Returns the partition which holds the cursor with the given id.
+     */
+    Partition& getPartition(CursorId cursorId);
+
+    /**
+     * Returns the partition in which the calling thread registers new cursors.  Threads are spread
+     * over the partitions, so that concurrent registrations do not contend with each other.
+     */
+    Partition& getPartitionForRegistration();
+
+    /**
+     * Returns the cursor id prefix for the given namespace, allocating a new one if no partition
+     * holds cursors on the namespace yet.  Must be called once for every partition in which a
+     * CursorEntryContainer for the namespace gets created.
+     *
+     * Thread-safe.
+     */
+    uint32_t acquireNamespacePrefix(const NamespaceString& nss);
+
+    /**
+     * Informs the manager that a partition no longer holds cursors on the given namespace.  Once
+     * no partition holds cursors on it, the namespace's cursor id prefix is released.
+     *
+     * Thread-safe.
+     */
+    void releaseNamespacePrefix(const NamespaceString& nss);
+
     /**
      * Returns a pointer to the CursorEntry for the given cursor.  If the given cursor is not
      * registered, returns null.
      *
-     * Not thread-safe.
+     * Not thread-safe.  The caller must hold the mutex of 'partition'.
      */
-    CursorEntry* getEntry_inlock(const NamespaceString& nss, CursorId cursorId);
+    CursorEntry* getEntry_inlock(Partition* partition,
+                                 const NamespaceString& nss,
+                                 CursorId cursorId);
 
     /**
      * De-registers the given cursor, and returns an owned pointer to the underlying
@@ -397,10 +435,10 @@ private:
      * If the given cursor is pinned, returns an error Status with code CursorInUse.  If the given
      * cursor is not registered, returns an error Status with code CursorNotFound.
      *
-     * Not thread-safe.
+     * Not thread-safe.  The caller must hold the mutex of 'partition'.
      */
-    StatusWith<std::unique_ptr<ClusterClientCursor>> detachCursor_inlock(const NamespaceString& nss,
-                                                                         CursorId cursorId);
+    StatusWith<std::unique_ptr<ClusterClientCursor>> detachCursor_inlock(
+        Partition* partition, const NamespaceString& nss, CursorId cursorId);
 
     /**
      * CursorEntry is a moveable, non-copyable container for a single cursor.
@@ -506,20 +544,62 @@ private:
         CursorEntryMap entryMap;
     };
 
+    using NamespaceToContainerMap =
+        stdx::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>;
+
+    struct Partition {
+        MONGO_DISALLOW_COPYING(Partition);
+
+        Partition(size_t index, int64_t seed) : index(index), pseudoRandom(seed) {}
+
+        // Position of this partition in '_partitions'.  The low bits of the id of every cursor in
+        // this partition are equal to it.
+        const size_t index;
+
+        // Synchronizes access to the state below.
+        stdx::mutex mutex;
+
+        // Randomness source.  Used for generating the ids of the cursors registered here.
+        PseudoRandom pseudoRandom;
+
+        // Map from namespace to the CursorEntryContainer for the cursors of that namespace which
+        // live in this partition.
+        //
+        // Entries are added when the first cursor on the given namespace is registered in this
+        // partition, and removed when the last such cursor is destroyed.
+        NamespaceToContainerMap namespaceToContainerMap;
+    };
+
+    /**
+     * NamespacePrefix is the cursor id prefix shared by all cursors on a namespace, together with
+     * the number of partitions holding cursors on that namespace.
+     */
+    struct NamespacePrefix {
+        uint32_t prefix;
+        size_t numPartitions;
+    };
+
+    static const size_t kNumPartitions = 16;
+
     // Clock source.  Used when the 'last active' time for a cursor needs to be set/updated.  May be
     // concurrently accessed by multiple threads.
     ClockSource* _clockSource;
 
-    // Synchronizes access to all private state variables below.
-    mutable stdx::mutex _mutex;
+    AtomicWord<bool> _inShutdown{false};
 
-    bool _inShutdown{false};
+    // The registered cursors, split by the low bits of their cursor id.  Each partition has its own
+    // mutex, so that checking out and checking in different cursors does not contend on a single
+    // lock.
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
-    // Randomness source.  Used for cursor id generation.
-    PseudoRandom _pseudoRandom;
+    // Synchronizes access to the namespace prefix state below.  When both are needed, a partition
+    // mutex must be acquired before this one.
+    mutable stdx::mutex _prefixMutex;
 
-    // Map from cursor id prefix to associated namespace.  Exists only to provide namespace lookup
-    // for (deprecated) getNamespaceForCursorId() method.
+    // Randomness source.  Used for namespace prefix generation.
+    PseudoRandom _prefixPseudoRandom;
+
+    // Map from namespace to the cursor id prefix of its cursors.
     //
     // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the first
     // cursor on a given namespace is registered, it is given a CursorId with a prefix that is
@@ -528,14 +608,13 @@ private:
     //
     // Entries are added when the first cursor on the given namespace is registered, and removed
     // when the last cursor on the given namespace is destroyed.
-    stdx::unordered_map<uint32_t, NamespaceString> _cursorIdPrefixToNamespaceMap;
+    stdx::unordered_map<NamespaceString, NamespacePrefix, NamespaceString::Hasher>
+        _namespaceToPrefixMap;
 
-    // Map from namespace to the CursorEntryContainer for that namespace.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    stdx::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>
-        _namespaceToContainerMap;
+    // Map from cursor id prefix to associated namespace.  Exists only to provide namespace lookup
+    // for (deprecated) getNamespaceForCursorId() method.  Kept in sync with
+    // '_namespaceToPrefixMap'.
+    stdx::unordered_map<uint32_t, NamespaceString> _cursorIdPrefixToNamespaceMap;
 
     size_t _cursorsTimedOut = 0;
 };
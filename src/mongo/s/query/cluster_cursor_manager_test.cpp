@@ -34,6 +34,7 @@
 
 #include "mongo/s/query/cluster_client_cursor_mock.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
 
@@ -856,6 +857,99 @@ TEST_F(ClusterCursorManagerTest, CannotCheckoutCursorDuringShutdown) {
                   getManager()->checkOutCursor(nss, cursorId, nullptr).getStatus());
 }
 
+// Test that cursors registered on the same namespace from different threads share a cursor id
+// prefix, and that the namespace stays known until the last of them is gone.
+TEST_F(ClusterCursorManagerTest, CursorsRegisteredFromManyThreadsSharePrefix) {
+    const size_t kNumThreads = 32;
+
+    std::vector<std::unique_ptr<ClusterClientCursorMock>> cursors;
+    for (size_t i = 0; i < kNumThreads; ++i) {
+        cursors.push_back(allocateMockCursor());
+    }
+
+    std::vector<StatusWith<CursorId>> swCursorIds(kNumThreads, StatusWith<CursorId>(CursorId(0)));
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&, i] {
+            swCursorIds[i] =
+                getManager()->registerCursor(std::move(cursors[i]),
+                                             nss,
+                                             ClusterCursorManager::CursorType::NamespaceNotSharded,
+                                             ClusterCursorManager::CursorLifetime::Mortal);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<CursorId> cursorIds;
+    for (const auto& swCursorId : swCursorIds) {
+        cursorIds.push_back(assertGet(swCursorId));
+    }
+
+    for (size_t i = 0; i < kNumThreads; ++i) {
+        ASSERT_EQUALS(cursorIds[0] >> 32, cursorIds[i] >> 32);
+        ASSERT_EQUALS(nss, *getManager()->getNamespaceForCursorId(cursorIds[i]));
+    }
+
+    for (size_t i = 0; i < kNumThreads; ++i) {
+        ASSERT(getManager()->getNamespaceForCursorId(cursorIds[0]));
+        ASSERT_OK(getManager()->killCursor(nss, cursorIds[i]));
+        getManager()->reapZombieCursors();
+    }
+    ASSERT(!getManager()->getNamespaceForCursorId(cursorIds[0]));
+}
+
+// Test that cursors can be checked out and back in from several threads at once, and that every
+// checkout pins the requested cursor.
+TEST_F(ClusterCursorManagerTest, ConcurrentCheckOutAndCheckIn) {
+    const size_t kNumThreads = 8;
+    const size_t kCursorsPerThread = 2;
+    const size_t kIterations = 100;
+
+    std::vector<CursorId> cursorIds;
+    for (size_t i = 0; i < kNumThreads * kCursorsPerThread; ++i) {
+        cursorIds.push_back(assertGet(
+            getManager()->registerCursor(allocateMockCursor(),
+                                         nss,
+                                         ClusterCursorManager::CursorType::NamespaceNotSharded,
+                                         ClusterCursorManager::CursorLifetime::Mortal)));
+    }
+
+    // Each thread records the first failure it sees, to be checked once all threads are done
+    std::vector<Status> statuses(kNumThreads, Status::OK());
+    std::vector<stdx::thread> threads;
+    for (size_t t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < kIterations; ++i) {
+                const CursorId cursorId = cursorIds[t * kCursorsPerThread + i % kCursorsPerThread];
+                auto pinnedCursor = getManager()->checkOutCursor(nss, cursorId, nullptr);
+                if (!pinnedCursor.isOK()) {
+                    statuses[t] = pinnedCursor.getStatus();
+                    return;
+                }
+                if (pinnedCursor.getValue().getCursorId() != cursorId) {
+                    statuses[t] = Status(ErrorCodes::InternalError, "checked out wrong cursor");
+                    return;
+                }
+                pinnedCursor.getValue().returnCursor(
+                    ClusterCursorManager::CursorState::NotExhausted);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& status : statuses) {
+        ASSERT_OK(status);
+    }
+
+    auto stats = getManager()->stats();
+    ASSERT_EQUALS(kNumThreads * kCursorsPerThread, stats.cursorsNotSharded);
+    ASSERT_EQUALS(0U, stats.cursorsPinned);
+}
+
 }  // namespace
 
 }  // namespace mongo
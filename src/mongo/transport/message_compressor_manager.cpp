@@ -89,6 +89,14 @@ StatusWith<Message> MessageCompressorManager::compressMessage(const Message& msg
     if (_negotiated.size() == 0) {
         return {msg};
     }
+
+    // The compressor reads the body as one contiguous range.
+    if (msg.isSegmented()) {
+        Message flatMessage = msg;
+        flatMessage.flatten();
+        return compressMessage(flatMessage);
+    }
+
     auto compressor = _negotiated[0];
 
     LOG(3) << "Compressing message with " << compressor->getName();
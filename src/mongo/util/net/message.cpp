@@ -30,7 +30,10 @@
 
 #include "mongo/util/net/message.h"
 
+#include <cstring>
+
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 
@@ -42,4 +45,78 @@ int32_t nextMessageId() {
     return NextMsgId.fetchAndAdd(1);
 }
 
+std::vector<std::pair<char*, int>> Message::sendBuffers() const {
+    std::vector<std::pair<char*, int>> buffers;
+    if (_segments.empty()) {
+        buffers.emplace_back(_buf.get(), size());
+        return buffers;
+    }
+
+    buffers.reserve(_segments.size());
+    for (const auto& segment : _segments) {
+        buffers.emplace_back(const_cast<char*>(segment.data), segment.len);
+    }
+    return buffers;
+}
+
+void Message::flatten() {
+    if (_segments.empty()) {
+        return;
+    }
+
+    auto flat = SharedBuffer::allocate(size());
+    char* out = flat.get();
+    for (const auto& segment : _segments) {
+        memcpy(out, segment.data, segment.len);
+        out += segment.len;
+    }
+    invariant(out == flat.get() + size());
+
+    _segments.clear();
+    _buf = std::move(flat);
+}
+
+void SegmentedMessageBuilder::_endCopiedPiece() {
+    if (_buf.len() > _copiedPieceStart) {
+        _pieces.push_back({{}, nullptr, _copiedPieceStart, _buf.len() - _copiedPieceStart});
+        _copiedPieceStart = _buf.len();
+    }
+}
+
+void SegmentedMessageBuilder::appendReference(ConstSharedBuffer owner, const char* data, int len) {
+    if (!owner || _numReferenced >= kMaxReferencedSegments) {
+        appendCopy(data, len);
+        return;
+    }
+
+    // The copied bytes so far must go out before the referenced ones.
+    _endCopiedPiece();
+    _pieces.push_back({std::move(owner), data, 0, len});
+    _referencedLen += len;
+    ++_numReferenced;
+}
+
+Message SegmentedMessageBuilder::release() {
+    if (_pieces.empty()) {
+        return Message(_buf.release());
+    }
+
+    _endCopiedPiece();
+    SharedBuffer copied = _buf.release();
+
+    std::vector<Message::Segment> segments;
+    segments.reserve(_pieces.size());
+    for (auto& piece : _pieces) {
+        if (piece.owner) {
+            segments.push_back({std::move(piece.owner), piece.data, piece.len});
+        } else {
+            segments.push_back({copied, copied.get() + piece.offset, piece.len});
+        }
+    }
+
+    Message message(copied);
+    message.setSegments(std::move(segments));
+    return message;
+}
+
 }  // namespace mongo
@@ -29,12 +29,16 @@
 #pragma once
 
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/encoded_value_storage.h"
 #include "mongo/base/static_assert.h"
+#include "mongo/bson/util/builder.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 
@@ -380,6 +384,16 @@ inline int ConstView::dataLen() const {
 
 class Message {
 public:
+    /**
+     * A range of bytes which is sent as part of a message without being copied into the message
+     * buffer. 'owner' keeps the bytes alive for as long as the message refers to them.
+     */
+    struct Segment {
+        ConstSharedBuffer owner;
+        const char* data;
+        int len;
+    };
+
     Message() = default;
     explicit Message(SharedBuffer data) : _buf(std::move(data)) {}
 
@@ -393,7 +407,7 @@ public:
     }
 
     MsgData::View singleData() const {
-        massert(13273, "single data buffer expected", _buf);
+        massert(13273, "single data buffer expected", _buf && _segments.empty());
         return header();
     }
 
@@ -414,8 +428,39 @@ public:
 
     void reset() {
         _buf = {};
+        _segments.clear();
+    }
+
+    /**
+     * Turns this into a scatter/gather message which is sent as 'segments', in order, instead of
+     * as the contents of its buffer. The first segment must begin with the message header, and the
+     * length in the header must already cover every segment.
+     */
+    void setSegments(std::vector<Segment> segments) {
+        verify(!empty());
+        verify(!segments.empty() && segments.front().data == _buf.get());
+        _segments = std::move(segments);
+    }
+
+    bool isSegmented() const {
+        return !_segments.empty();
+    }
+
+    const std::vector<Segment>& segments() const {
+        return _segments;
     }
 
+    /**
+     * Returns the ranges of bytes to hand to a scatter/gather send for this message.
+     */
+    std::vector<std::pair<char*, int>> sendBuffers() const;
+
+    /**
+     * Copies the segments of a scatter/gather message into a single buffer, so that the whole
+     * message can be read through buf(). Does nothing if the message is not segmented.
+     */
+    void flatten();
+
     // use to set first buffer if empty
     void setData(SharedBuffer buf) {
         verify(empty());
@@ -455,6 +500,66 @@ public:
 
 private:
     SharedBuffer _buf;
+    std::vector<Segment> _segments;
+};
+
+/**
+ * Builds a Message from bytes which are either copied into the message buffer or, to avoid a copy,
+ * referenced in place from a buffer that somebody else owns. The result is a scatter/gather
+ * message when anything was referenced, and an ordinary single-buffer message otherwise.
+ */
+class SegmentedMessageBuilder {
+public:
+    // Referenced ranges past this count are copied instead, so that a message never needs more
+    // buffers than a single scatter/gather send accepts.
+    static const size_t kMaxReferencedSegments = 256;
+
+    explicit SegmentedMessageBuilder(int initialSize) : _buf(initialSize) {}
+
+    /**
+     * The buffer that copied bytes are written to. It begins with the message header.
+     */
+    BufBuilder& buf() {
+        return _buf;
+    }
+
+    /**
+     * The length of the message built so far, including referenced bytes.
+     */
+    int len() const {
+        return _buf.len() + _referencedLen;
+    }
+
+    void appendCopy(const char* data, int len) {
+        _buf.appendBuf(data, len);
+    }
+
+    /**
+     * Appends 'len' bytes at 'data', which must stay unchanged for as long as 'owner' is alive.
+     */
+    void appendReference(ConstSharedBuffer owner, const char* data, int len);
+
+    /**
+     * Returns the built message. The builder must not be used afterwards.
+     */
+    Message release();
+
+private:
+    // Either a range [offset, offset + len) of '_buf', when 'owner' is null, or a referenced range.
+    struct Piece {
+        ConstSharedBuffer owner;
+        const char* data;
+        int offset;
+        int len;
+    };
+
+    void _endCopiedPiece();
+
+    BufBuilder _buf;
+    std::vector<Piece> _pieces;
+    int _copiedPieceStart = 0;
+    int _referencedLen = 0;
+    size_t _numReferenced = 0;
 };
 
 /**
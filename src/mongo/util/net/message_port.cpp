@@ -225,6 +225,11 @@ void MessagingPort::say(Message& toSend, int responseTo) {
 
 void MessagingPort::say(const Message& toSend) {
     invariant(!toSend.empty());
+    if (toSend.isSegmented()) {
+        send(toSend.sendBuffers(), "say");
+        return;
+    }
+
     auto buf = toSend.buf();
     if (buf) {
         send(buf, MsgData::ConstView(buf).getLen(), "say");
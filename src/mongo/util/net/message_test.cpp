@@ -0,0 +1,118 @@
+/*    Copyright 2018 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+namespace {
+
+const int kHeaderSize = sizeof(MsgData::Value) - 4;
+
+SharedBuffer makeBuffer(const std::string& contents) {
+    auto buffer = SharedBuffer::allocate(contents.size());
+    memcpy(buffer.get(), contents.data(), contents.size());
+    return buffer;
+}
+
+std::string bodyOf(const Message& message) {
+    return std::string(message.buf() + kHeaderSize, message.size() - kHeaderSize);
+}
+
+void setHeader(SegmentedMessageBuilder* mb) {
+    MsgData::View header(mb->buf().buf());
+    header.setLen(mb->len());
+    header.setOperation(opReply);
+}
+
+TEST(SegmentedMessageBuilder, CopiesOnlyIsNotSegmented) {
+    SegmentedMessageBuilder mb(64);
+    mb.buf().skip(kHeaderSize);
+    mb.appendCopy("abc", 3);
+    mb.appendCopy("def", 3);
+    setHeader(&mb);
+
+    Message message = mb.release();
+    ASSERT_FALSE(message.isSegmented());
+    ASSERT_EQ(message.size(), kHeaderSize + 6);
+    ASSERT_EQ(bodyOf(message), "abcdef");
+    ASSERT_EQ(message.sendBuffers().size(), 1UL);
+}
+
+TEST(SegmentedMessageBuilder, ReferencesKeepTheirPlaceBetweenCopies) {
+    auto referenced = makeBuffer("xyz");
+
+    SegmentedMessageBuilder mb(64);
+    mb.buf().skip(kHeaderSize);
+    mb.appendCopy("abc", 3);
+    mb.appendReference(referenced, referenced.get(), 3);
+    mb.appendCopy("def", 3);
+    setHeader(&mb);
+    ASSERT_EQ(mb.len(), kHeaderSize + 9);
+
+    Message message = mb.release();
+    ASSERT_TRUE(message.isSegmented());
+    ASSERT_EQ(message.size(), kHeaderSize + 9);
+
+    auto buffers = message.sendBuffers();
+    ASSERT_EQ(buffers.size(), 3UL);
+    ASSERT_EQ(buffers[0].second, kHeaderSize + 3);
+    ASSERT_EQ(static_cast<const void*>(buffers[1].first), referenced.get());
+    ASSERT_EQ(buffers[2].second, 3);
+
+    message.flatten();
+    ASSERT_FALSE(message.isSegmented());
+    ASSERT_EQ(bodyOf(message), "abcxyzdef");
+}
+
+TEST(SegmentedMessageBuilder, CopiesReferencesPastTheSegmentLimit) {
+    auto referenced = makeBuffer("r");
+    const size_t numAppends = SegmentedMessageBuilder::kMaxReferencedSegments + 10;
+
+    SegmentedMessageBuilder mb(64);
+    mb.buf().skip(kHeaderSize);
+    for (size_t i = 0; i < numAppends; ++i) {
+        mb.appendReference(referenced, referenced.get(), 1);
+    }
+    setHeader(&mb);
+
+    Message message = mb.release();
+    ASSERT_EQ(message.size(), kHeaderSize + static_cast<int>(numAppends));
+
+    // The header, each referenced byte, and one trailing piece holding every copied byte.
+    ASSERT_EQ(message.segments().size(), SegmentedMessageBuilder::kMaxReferencedSegments + 2);
+
+    message.flatten();
+    ASSERT_EQ(bodyOf(message), std::string(numAppends, 'r'));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,178 @@
+// sharded_string_map.h
+
+/*    Copyright 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * A StringMap split into independently locked shards, for maps that are shared by many threads
+ * and hold a large number of keys. Operations on different keys rarely contend, and an operation
+ * never waits for one that touches another shard.
+ *
+ * Values are copied in and out while the shard is locked, so V should be cheap to copy. Each
+ * shard mutex is a leaf lock: callbacks passed to visit() and forEach() must not lock anything
+ * that could be held while calling into the map.
+ *
+ * forEach() locks one shard at a time and so does not give a point-in-time view of the whole map.
+ */
+template <typename V>
+class ShardedStringMap {
+    MONGO_DISALLOW_COPYING(ShardedStringMap);
+
+public:
+    static const int kShardBits = 5;
+    static const size_t kNumShards = 1 << kShardBits;
+
+    ShardedStringMap() = default;
+
+    /**
+     * Copies the value for 'key' into 'out', if there is one. Returns whether 'key' was found.
+     */
+    bool find(StringData key, V* out) const {
+        const StringMapTraits::HashedKey hashed(key);
+        const Shard& shard = _shardFor(hashed);
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        auto it = shard.map.find(hashed);
+        if (it == shard.map.end())
+            return false;
+        *out = it->second;
+        return true;
+    }
+
+    bool contains(StringData key) const {
+        const StringMapTraits::HashedKey hashed(key);
+        const Shard& shard = _shardFor(hashed);
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        return shard.map.find(hashed) != shard.map.end();
+    }
+
+    /**
+     * Calls 'f' with the value for 'key' while its shard is locked. Returns false without calling
+     * 'f' if 'key' is not in the map.
+     */
+    template <typename F>
+    bool visit(StringData key, F&& f) const {
+        const StringMapTraits::HashedKey hashed(key);
+        const Shard& shard = _shardFor(hashed);
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        auto it = shard.map.find(hashed);
+        if (it == shard.map.end())
+            return false;
+        f(it->second);
+        return true;
+    }
+
+    /**
+     * Adds 'key' unless it is already in the map. Returns whether it was added.
+     */
+    bool insert(StringData key, const V& value) {
+        const StringMapTraits::HashedKey hashed(key);
+        Shard& shard = _shardFor(hashed);
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        if (shard.map.find(hashed) != shard.map.end())
+            return false;
+        shard.map[hashed] = value;
+        return true;
+    }
+
+    /**
+     * Adds 'key' or replaces its value.
+     */
+    void set(StringData key, const V& value) {
+        const StringMapTraits::HashedKey hashed(key);
+        Shard& shard = _shardFor(hashed);
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        shard.map[hashed] = value;
+    }
+
+    /**
+     * Removes 'key', copying its value into 'out' if non-null. Returns whether it was found.
+     */
+    bool erase(StringData key, V* out = nullptr) {
+        const StringMapTraits::HashedKey hashed(key);
+        Shard& shard = _shardFor(hashed);
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        auto it = shard.map.find(hashed);
+        if (it == shard.map.end())
+            return false;
+        if (out)
+            *out = it->second;
+        shard.map.erase(it);
+        return true;
+    }
+
+    /**
+     * Calls 'f' with each key and value, in no particular order.
+     */
+    template <typename F>
+    void forEach(F&& f) const {
+        for (const Shard& shard : _shards) {
+            stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+            for (auto& entry : shard.map) {
+                f(StringData(entry.first), entry.second);
+            }
+        }
+    }
+
+    size_t size() const {
+        size_t n = 0;
+        for (const Shard& shard : _shards) {
+            stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+            n += shard.map.size();
+        }
+        return n;
+    }
+
+private:
+    struct Shard {
+        mutable stdx::mutex mutex;
+        StringMap<V> map;
+    };
+
+    // StringMap picks buckets from the low bits of the hash, so shards use the high bits.
+    Shard& _shardFor(const StringMapTraits::HashedKey& key) {
+        return _shards[key.hash() >> (32 - kShardBits)];
+    }
+
+    const Shard& _shardFor(const StringMapTraits::HashedKey& key) const {
+        return _shards[key.hash() >> (32 - kShardBits)];
+    }
+
+    std::array<Shard, kNumShards> _shards;
+};
+
+}  // namespace mongo
@@ -0,0 +1,118 @@
+// sharded_string_map_test.cpp
+
+/*    Copyright 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/sharded_string_map.h"
+
+namespace {
+using namespace mongo;
+
+TEST(ShardedStringMapTest, Basic) {
+    ShardedStringMap<int> m;
+    int v = 0;
+
+    ASSERT_FALSE(m.find("a", &v));
+    ASSERT_FALSE(m.contains("a"));
+
+    ASSERT_TRUE(m.insert("a", 1));
+    ASSERT_FALSE(m.insert("a", 2));
+    ASSERT_TRUE(m.find("a", &v));
+    ASSERT_EQUALS(1, v);
+
+    m.set("a", 3);
+    m.set("b", 4);
+    ASSERT_TRUE(m.contains("b"));
+    ASSERT_EQUALS(2U, m.size());
+
+    ASSERT_TRUE(m.visit("a", [&](const int& value) { v = value; }));
+    ASSERT_EQUALS(3, v);
+    ASSERT_FALSE(m.visit("c", [](const int&) { FAIL("visited a missing key"); }));
+
+    ASSERT_TRUE(m.erase("a", &v));
+    ASSERT_EQUALS(3, v);
+    ASSERT_FALSE(m.erase("a"));
+    ASSERT_FALSE(m.contains("a"));
+    ASSERT_EQUALS(1U, m.size());
+}
+
+TEST(ShardedStringMapTest, ForEachSeesEveryKey) {
+    ShardedStringMap<int> m;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 1000; i++) {
+        std::string key = str::stream() << "test.coll" << i;
+        ASSERT_TRUE(m.insert(key, i));
+        expected.push_back(key);
+    }
+
+    std::vector<std::string> keys;
+    m.forEach([&](StringData key, const int& value) {
+        ASSERT_EQUALS(key, std::string(str::stream() << "test.coll" << value));
+        keys.push_back(key.toString());
+    });
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(keys.begin(), keys.end());
+    ASSERT(expected == keys);
+}
+
+TEST(ShardedStringMapTest, ConcurrentWriters) {
+    ShardedStringMap<int> m;
+    const int nThreads = 8;
+    const int nKeys = 10000;
+
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < nThreads; t++) {
+        threads.emplace_back([&m, t]() {
+            for (int i = 0; i < nKeys; i++) {
+                std::string key = str::stream() << t << "." << i;
+                m.set(key, i);
+                if (i % 2)
+                    m.erase(key);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    ASSERT_EQUALS(static_cast<size_t>(nThreads * nKeys / 2), m.size());
+    int v = -1;
+    ASSERT_TRUE(m.find("3.42", &v));
+    ASSERT_EQUALS(42, v);
+    ASSERT_FALSE(m.contains("3.43"));
+}
+
+}  // namespace